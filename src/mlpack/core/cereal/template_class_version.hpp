@@ -0,0 +1,60 @@
+/**
+ * @file core/cereal/template_class_version.hpp
+ *
+ * Set the serialization version of a class template.
+ *
+ * CEREAL_CLASS_VERSION() only works for a single type, since it fully
+ * specializes cereal::detail::Version.  This macro gives the same
+ * specialization for every instantiation of a class template.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_CEREAL_TEMPLATE_CLASS_VERSION_HPP
+#define MLPACK_CORE_CEREAL_TEMPLATE_CLASS_VERSION_HPP
+
+#include <cereal/details/helpers.hpp>
+#include <cereal/details/static_object.hpp>
+
+#include <typeindex>
+
+//! Remove the parentheses around a macro argument that contains commas.
+#define MLPACK_CEREAL_UNWRAP(...) __VA_ARGS__
+
+/**
+ * Set the serialization version of all instantiations of a class template.
+ * The signature and the type have to be given in parentheses, since they may
+ * contain commas.  For example,
+ *
+ * @code
+ * CEREAL_TEMPLATE_CLASS_VERSION((template<typename T, typename U>),
+ *     (Foo<T, U>), (1));
+ * @endcode
+ *
+ * This has to be used outside of any namespace.
+ */
+#define CEREAL_TEMPLATE_CLASS_VERSION(SIGNATURE, TYPE, VERSION)              \
+namespace cereal {                                                           \
+namespace detail {                                                           \
+MLPACK_CEREAL_UNWRAP SIGNATURE                                               \
+struct Version<MLPACK_CEREAL_UNWRAP TYPE>                                    \
+{                                                                            \
+  static std::uint32_t registerVersion()                                     \
+  {                                                                          \
+    ::cereal::detail::StaticObject<Versions>::getInstance().mapping.emplace( \
+        std::type_index(typeid(MLPACK_CEREAL_UNWRAP TYPE)).hash_code(),      \
+        MLPACK_CEREAL_UNWRAP VERSION);                                       \
+    return MLPACK_CEREAL_UNWRAP VERSION;                                     \
+  }                                                                          \
+  static void unused() { (void) version; }                                   \
+  static const std::uint32_t version;                                        \
+};                                                                           \
+MLPACK_CEREAL_UNWRAP SIGNATURE                                               \
+const std::uint32_t Version<MLPACK_CEREAL_UNWRAP TYPE>::version =            \
+    Version<MLPACK_CEREAL_UNWRAP TYPE>::registerVersion();                   \
+} /* namespace detail */                                                     \
+} /* namespace cereal */
+
+#endif
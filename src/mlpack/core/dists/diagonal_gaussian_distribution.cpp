@@ -48,19 +48,23 @@ double DiagonalGaussianDistribution::LogProbability(
 
 void DiagonalGaussianDistribution::LogProbability(
     const arma::mat& observations,
-    arma::vec& logProbabilities) const
+    arma::vec& logProbabilities,
+    arma::mat& workspace) const
 {
   const size_t k = observations.n_rows;
 
-  // Column i of 'diffs' is the difference between observations.col(i) and
-  // the mean.
-  arma::mat diffs = observations.each_col() - mean;
+  // Column i of the workspace is the squared difference between
+  // observations.col(i) and the mean.  The assignment reuses the memory of
+  // the workspace if it already has the right size.
+  workspace = observations;
+  workspace.each_col() -= mean;
+  workspace %= workspace;
 
   // Calculates log of exponent equation in multivariate Gaussian
   // distribution. We use only diagonal part for faster computation.
-  arma::vec logExponents = -0.5 * arma::trans(diffs % diffs) * invCov;
-
-  logProbabilities = -0.5 * k * log2pi - 0.5 * logDetCov + logExponents;
+  logProbabilities = workspace.t() * invCov;
+  logProbabilities *= -0.5;
+  logProbabilities += -0.5 * k * log2pi - 0.5 * logDetCov;
 }
 
 arma::vec DiagonalGaussianDistribution::Random() const
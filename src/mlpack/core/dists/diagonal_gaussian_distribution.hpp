@@ -94,7 +94,26 @@ class DiagonalGaussianDistribution
    * @param logProbabilities Output log probabilities for each observation.
    */
   void LogProbability(const arma::mat& observations,
-                      arma::vec& logProbabilities) const;
+                      arma::vec& logProbabilities) const
+  {
+    arma::mat workspace;
+    LogProbability(observations, logProbabilities, workspace);
+  }
+
+  /**
+   * Calculate the multivariate Gaussian log probability density function for
+   * each data point (column) in the given matrix, using the given workspace to
+   * hold intermediate results.  No memory is allocated if the workspace and
+   * logProbabilities are reused across calls with the same number of points.
+   *
+   * @param observations Matrix of observations.
+   * @param logProbabilities Output log probabilities for each observation.
+   * @param workspace Matrix for intermediate results; it will be set to the
+   *     same size as observations.
+   */
+  void LogProbability(const arma::mat& observations,
+                      arma::vec& logProbabilities,
+                      arma::mat& workspace) const;
 
   /**
    * Return a randomly generated observation according to the probability
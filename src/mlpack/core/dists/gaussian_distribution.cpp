@@ -76,6 +76,36 @@ double GaussianDistribution::LogProbability(const arma::vec& observation) const
   return -0.5 * k * log2pi - 0.5 * logDetCov - 0.5 * v(0);
 }
 
+void GaussianDistribution::LogProbability(const arma::mat& x,
+                                          arma::vec& logProbabilities,
+                                          arma::mat& workspace) const
+{
+  workspace.set_size(x.n_rows, 2 * x.n_cols);
+  logProbabilities.set_size(x.n_cols);
+
+  // Column i of 'diffs' is the difference between x.col(i) and the mean, and
+  // 'rhs' will hold cov^-1 * diffs.  Both are aliases of the workspace, so
+  // that the GEMM below writes directly into memory owned by the caller.
+  arma::mat diffs(workspace.memptr(), x.n_rows, x.n_cols, false, true);
+  arma::mat rhs(workspace.memptr() + x.n_elem, x.n_rows, x.n_cols, false,
+      true);
+
+  diffs = x;
+  diffs.each_col() -= mean;
+
+  // We only want the diagonal elements of (diffs' * cov^-1 * diffs).  We
+  // calculate the right hand part of the product so that later we are
+  // referencing columns, not rows -- that is faster.
+  rhs = invCov * diffs;
+
+  const double logConstant = -0.5 * x.n_rows * log2pi - 0.5 * logDetCov;
+  for (size_t i = 0; i < x.n_cols; ++i)
+  {
+    logProbabilities[i] = logConstant - 0.5 * arma::dot(diffs.unsafe_col(i),
+        rhs.unsafe_col(i));
+  }
+}
+
 arma::vec GaussianDistribution::Random() const
 {
   return covLower * arma::randn<arma::vec>(mean.n_elem) + mean;
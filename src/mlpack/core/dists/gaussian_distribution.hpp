@@ -107,22 +107,28 @@ class GaussianDistribution
    */
   void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const
   {
-    // Column i of 'diffs' is the difference between x.col(i) and the mean.
-    arma::mat diffs = x;
-    diffs.each_col() -= mean;
-    // Now, we only want to calculate the diagonal elements of (diffs' * cov^-1
-    // * diffs).  We just don't need any of the other elements.  We can
-    // calculate the right hand part of the equation (instead of the left side)
-    // so that later we are referencing columns, not rows -- that is faster.
-    const arma::mat rhs = -0.5 * invCov * diffs;
-    arma::vec logExponents(diffs.n_cols); // We will now fill this.
-    for (size_t i = 0; i < diffs.n_cols; ++i)
-      logExponents(i) = accu(diffs.unsafe_col(i) % rhs.unsafe_col(i));
-
-    logProbabilities = -0.5 * x.n_rows * log2pi - 0.5 * logDetCov +
-      logExponents;
+    arma::mat workspace;
+    LogProbability(x, logProbabilities, workspace);
   }
 
+  /**
+   * Returns the log probability of the given matrix, using the given
+   * workspace to hold intermediate results.  If the workspace and
+   * logProbabilities are reused across calls with the same number of points,
+   * no memory is allocated, so this overload is preferable when the log
+   * probabilities are computed repeatedly (for instance, once per EM
+   * iteration).
+   *
+   * @param x List of observations.
+   * @param logProbabilities Output log probabilities for each input
+   *     observation.
+   * @param workspace Matrix for intermediate results; it will be set to size
+   *     x.n_rows by (2 * x.n_cols).
+   */
+  void LogProbability(const arma::mat& x,
+                      arma::vec& logProbabilities,
+                      arma::mat& workspace) const;
+
   /**
    * Return a randomly generated observation according to the probability
    * distribution defined by this object.
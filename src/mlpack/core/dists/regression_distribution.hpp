@@ -132,6 +132,21 @@ class RegressionDistribution
     return log(Probability(observation));
   }
 
+  /**
+   * Evaluate the log probability density function of each of the given
+   * observations (columns).
+   *
+   * @param observations Points to evaluate log probability at.
+   * @param logProbabilities Output log probabilities for each observation.
+   */
+  void LogProbability(const arma::mat& observations,
+                      arma::vec& logProbabilities) const
+  {
+    logProbabilities.set_size(observations.n_cols);
+    for (size_t i = 0; i < observations.n_cols; ++i)
+      logProbabilities[i] = LogProbability(observations.unsafe_col(i));
+  }
+
   /**
    * Calculate y_i for each data point in points.
    *
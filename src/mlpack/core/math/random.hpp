@@ -13,7 +13,9 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/mlpack_export.hpp>
+#include <limits>
 #include <random>
+#include <vector>
 
 namespace mlpack {
 namespace math /** Miscellaneous math routines. */ {
@@ -179,6 +181,60 @@ inline void ObtainDistinctSamples(const size_t loInclusive,
   }
 }
 
+/**
+ * Seeds for the parts of a computation that are processed in parallel.  The
+ * seeds are drawn in order when the object is created, so that the random
+ * numbers used by a part don't depend on the thread that processes it.  A
+ * single part is left to the generator of the calling thread.
+ *
+ * @code
+ * ParallelSeeds seeds(parts);
+ * #pragma omp parallel for
+ * for (omp_size_t t = 0; t < (omp_size_t) parts; ++t)
+ * {
+ *   seeds.Seed(t);
+ *   ...
+ * }
+ * seeds.Reseed();
+ * @endcode
+ */
+class ParallelSeeds
+{
+ public:
+  /**
+   * Draw a seed for each of the given number of parts.
+   *
+   * @param parts Number of parts.
+   */
+  ParallelSeeds(const size_t parts) : seeds((parts > 1) ? parts : 0)
+  {
+    for (size_t t = 0; t < seeds.size(); ++t)
+      seeds[t] = RandInt(std::numeric_limits<int>::max());
+  }
+
+  //! Seed the Armadillo generator of the current thread for the given part.
+  void Seed(const size_t part) const
+  {
+    if (!seeds.empty())
+      arma::arma_rng::set_seed(seeds[part]);
+  }
+
+  /**
+   * Leave the Armadillo generator of the calling thread in a state that
+   * doesn't depend on the scheduling of the parts.  Call this after the
+   * parallel loop.
+   */
+  void Reseed() const
+  {
+    if (!seeds.empty())
+      arma::arma_rng::set_seed(RandInt(std::numeric_limits<int>::max()));
+  }
+
+ private:
+  //! The seed of each part.
+  std::vector<int> seeds;
+};
+
 } // namespace math
 } // namespace mlpack
 
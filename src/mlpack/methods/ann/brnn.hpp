@@ -22,6 +22,7 @@
 #include "visitor/reset_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "util/batch_prefetcher.hpp"
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
 #include <mlpack/methods/ann/layer/layer_traits.hpp>
@@ -292,6 +293,18 @@ class BRNN
   //! Modify the maximum length of backpropagation through time.
   size_t& Rho() { return rho; }
 
+  /**
+   * Get the number of time steps whose layer outputs are held at once during
+   * backpropagation through time, for each direction.  If 0 (the default), the
+   * outputs of every step are saved.  Otherwise, the forward pass of each
+   * segment of steps is computed again right before its backward pass; see
+   * RNN::CheckpointInterval().
+   */
+  size_t CheckpointInterval() const { return checkpointInterval; }
+  //! Modify the number of time steps whose layer outputs are held at once
+  //! during backpropagation through time.
+  size_t& CheckpointInterval() { return checkpointInterval; }
+
   //! Get the matrix of responses to the input data points.
   const arma::cube& Responses() const { return responses; }
   //! Modify the matrix of responses to the input data points.
@@ -357,12 +370,19 @@ class BRNN
     //! Only predict the last element of the input sequence.
   bool single;
 
+  //! The number of time steps whose layer outputs are held at once during
+  //! BPTT; 0 holds the outputs of all steps.
+  size_t checkpointInterval;
+
   //! The matrix of data points (predictors).
   arma::cube predictors;
 
   //! The matrix of responses to the input data points.
   arma::cube responses;
 
+  //! Gathers the batches of the data points after Shuffle().
+  BatchPrefetcher<arma::cube> batchPrefetcher;
+
   //! Matrix of (trained) parameters.
   arma::mat parameter;
 
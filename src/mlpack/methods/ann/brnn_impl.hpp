@@ -21,6 +21,7 @@
 #include "visitor/forward_visitor.hpp"
 #include "visitor/backward_visitor.hpp"
 #include "visitor/reset_cell_visitor.hpp"
+#include "visitor/rewind_visitor.hpp"
 #include "visitor/gradient_set_visitor.hpp"
 #include "visitor/gradient_visitor.hpp"
 #include "visitor/weight_set_visitor.hpp"
@@ -50,6 +51,7 @@ BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
     targetSize(0),
     reset(false),
     single(single),
+    checkpointInterval(0),
     numFunctions(0),
     deterministic(true),
     forwardRNN(rho, single, outputLayer, initializeRule),
@@ -125,6 +127,7 @@ double BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
 {
   numFunctions = responses.n_cols;
 
+  batchPrefetcher.Reset();
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
 
@@ -159,6 +162,7 @@ double BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
 {
   numFunctions = responses.n_cols;
 
+  batchPrefetcher.Reset();
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
 
@@ -291,6 +295,17 @@ double BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
     targetSize = responses.n_rows;
   }
 
+  // Use the batch gathered in the shuffled order, if Shuffle() was called.
+  const bool shuffled = batchPrefetcher.Shuffled();
+  if (shuffled)
+    batchPrefetcher.Fetch(predictors, responses, begin, batchSize);
+
+  arma::cube& predictorsData = shuffled ? batchPrefetcher.Predictors() :
+      predictors;
+  arma::cube& responsesData = shuffled ? batchPrefetcher.Responses() :
+      responses;
+  const size_t first = shuffled ? 0 : begin;
+
   forwardRNN.ResetCells();
   backwardRNN.ResetCells();
 
@@ -301,10 +316,10 @@ double BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
   for (size_t seqNum = 0; seqNum < rho; ++seqNum)
   {
     forwardRNN.Forward(arma::mat(
-        predictors.slice(seqNum).colptr(begin),
+        predictorsData.slice(seqNum).colptr(first),
         predictors.n_rows, batchSize, false, true));
     backwardRNN.Forward(arma::mat(
-        predictors.slice(rho - seqNum - 1).colptr(begin),
+        predictorsData.slice(rho - seqNum - 1).colptr(first),
         predictors.n_rows, batchSize, false, true));
 
     boost::apply_visitor(SaveOutputParameterVisitor(results1),
@@ -342,7 +357,7 @@ double BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
         mergeOutput);
     performance += outputLayer.Forward(
         boost::apply_visitor(outputParameterVisitor, mergeOutput),
-        arma::mat(responses.slice(responseSeq).colptr(begin),
+        arma::mat(responsesData.slice(responseSeq).colptr(first),
         responses.n_rows, batchSize, false, true));
   }
   return performance;
@@ -410,22 +425,69 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     targetSize = responses.n_rows;
   }
 
+  // Use the batch gathered in the shuffled order, if Shuffle() was called.
+  const bool shuffled = batchPrefetcher.Shuffled();
+  if (shuffled)
+    batchPrefetcher.Fetch(predictors, responses, begin, batchSize);
+
+  arma::cube& predictorsData = shuffled ? batchPrefetcher.Predictors() :
+      predictors;
+  arma::cube& responsesData = shuffled ? batchPrefetcher.Responses() :
+      responses;
+  const size_t first = shuffled ? 0 : begin;
+
+  size_t networkSize = backwardRNN.network.size();
+
+  // The steps can only be computed again if every module can go back to an
+  // earlier step; otherwise the cells hold the state of every step.
+  bool checkpointing = (checkpointInterval > 0);
+  for (size_t l = 0; l < networkSize; ++l)
+  {
+    if (!boost::apply_visitor(RewindVisitor(0, checkpointInterval),
+        forwardRNN.network[l]) || !boost::apply_visitor(RewindVisitor(0,
+        checkpointInterval), backwardRNN.network[l]))
+    {
+      checkpointing = false;
+    }
+  }
+
+  if (!checkpointing && checkpointInterval > 0)
+  {
+    for (size_t l = 0; l < networkSize; ++l)
+    {
+      boost::apply_visitor(RewindVisitor(0, 0), forwardRNN.network[l]);
+      boost::apply_visitor(RewindVisitor(0, 0), backwardRNN.network[l]);
+    }
+  }
+
   forwardRNN.ResetCells();
   backwardRNN.ResetCells();
-  size_t networkSize = backwardRNN.network.size();
+
+  // The two networks draw their random numbers (e.g. the dropout masks) in
+  // turns, so each step of each network gets a seed of its own to be able to
+  // repeat it exactly.
+  std::vector<int> forwardSeeds, backwardSeeds;
 
   // Forward propogation from both directions.
   std::vector<arma::mat> results1, results2;
   for (size_t seqNum = 0; seqNum < rho; ++seqNum)
   {
+    if (checkpointing)
+    {
+      forwardSeeds.push_back(math::RandInt(std::numeric_limits<int>::max()));
+      backwardSeeds.push_back(math::RandInt(std::numeric_limits<int>::max()));
+      arma::arma_rng::set_seed(forwardSeeds.back());
+    }
     forwardRNN.Forward(arma::mat(
-        predictors.slice(seqNum).colptr(begin),
+        predictorsData.slice(seqNum).colptr(first),
         predictors.n_rows, batchSize, false, true));
+    if (checkpointing)
+      arma::arma_rng::set_seed(backwardSeeds.back());
     backwardRNN.Forward(arma::mat(
-        predictors.slice(rho - seqNum - 1).colptr(begin),
+        predictorsData.slice(rho - seqNum - 1).colptr(first),
         predictors.n_rows, batchSize, false, true));
 
-    for (size_t l = 0; l < networkSize; ++l)
+    for (size_t l = 0; l < networkSize && !checkpointing; ++l)
     {
       boost::apply_visitor(SaveOutputParameterVisitor(
           forwardRNNOutputParameter), forwardRNN.network[l]);
@@ -477,7 +539,7 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
         boost::apply_visitor(outputParameterVisitor, mergeLayer),
         results.slice(seqNum)), mergeOutput);
     performance += outputLayer.Forward(results.slice(seqNum),
-        arma::mat(responses.slice(responseSeq).colptr(begin),
+        arma::mat(responsesData.slice(responseSeq).colptr(first),
         responses.n_rows, batchSize, false, true));
   }
 
@@ -494,13 +556,13 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     else if (single && seqNum == 0)
     {
       outputLayer.Backward(results.slice(seqNum),
-          arma::mat(responses.slice(0).colptr(begin),
+          arma::mat(responsesData.slice(0).colptr(first),
           responses.n_rows, batchSize, false, true), error);
     }
     else
     {
       outputLayer.Backward(results.slice(seqNum),
-          arma::mat(responses.slice(seqNum).colptr(begin),
+          arma::mat(responsesData.slice(seqNum).colptr(first),
           responses.n_rows, batchSize, false, true), error);
     }
 
@@ -520,6 +582,31 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
   for (size_t seqNum = 0; seqNum < rho; ++seqNum)
   {
+    // Compute the outputs of the segment that ends with this step again.
+    if (checkpointing && forwardRNNOutputParameter.empty())
+    {
+      const size_t last = rho - seqNum - 1;
+      const size_t start = last / checkpointInterval * checkpointInterval;
+      for (size_t l = 0; l < networkSize; ++l)
+      {
+        boost::apply_visitor(RewindVisitor(start, checkpointInterval),
+            forwardRNN.network[l]);
+      }
+
+      for (size_t step = start; step <= last; ++step)
+      {
+        arma::arma_rng::set_seed(forwardSeeds[step]);
+        forwardRNN.Forward(arma::mat(predictorsData.slice(step).colptr(first),
+            predictors.n_rows, batchSize, false, true));
+
+        for (size_t l = 0; l < networkSize; ++l)
+        {
+          boost::apply_visitor(SaveOutputParameterVisitor(
+              forwardRNNOutputParameter), forwardRNN.network[l]);
+        }
+      }
+    }
+
     forwardGradient.zeros();
     for (size_t l = 0; l < networkSize; ++l)
     {
@@ -544,7 +631,7 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
           forwardRNN.network[networkSize - i]);
     }
     forwardRNN.Gradient(
-        arma::mat(predictors.slice(rho - seqNum - 1).colptr(begin),
+        arma::mat(predictorsData.slice(rho - seqNum - 1).colptr(first),
         predictors.n_rows, batchSize, false, true));
     boost::apply_visitor(GradientVisitor(
         boost::apply_visitor(outputParameterVisitor,
@@ -559,6 +646,32 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
   for (size_t seqNum = 0; seqNum < rho; ++seqNum)
   {
+    // The steps of the backward network run from the end of the sequence.
+    if (checkpointing && backwardRNNOutputParameter.empty())
+    {
+      const size_t last = rho - seqNum - 1;
+      const size_t start = last / checkpointInterval * checkpointInterval;
+      for (size_t l = 0; l < networkSize; ++l)
+      {
+        boost::apply_visitor(RewindVisitor(start, checkpointInterval),
+            backwardRNN.network[l]);
+      }
+
+      for (size_t step = start; step <= last; ++step)
+      {
+        arma::arma_rng::set_seed(backwardSeeds[step]);
+        backwardRNN.Forward(arma::mat(
+            predictorsData.slice(rho - step - 1).colptr(first),
+            predictors.n_rows, batchSize, false, true));
+
+        for (size_t l = 0; l < networkSize; ++l)
+        {
+          boost::apply_visitor(SaveOutputParameterVisitor(
+              backwardRNNOutputParameter), backwardRNN.network[l]);
+        }
+      }
+    }
+
     backwardGradient.zeros();
     for (size_t l = 0; l < networkSize; ++l)
     {
@@ -582,7 +695,7 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     }
 
     backwardRNN.Gradient(
-        arma::mat(predictors.slice(seqNum).colptr(begin),
+        arma::mat(predictorsData.slice(seqNum).colptr(first),
         predictors.n_rows, batchSize, false, true));
     boost::apply_visitor(GradientVisitor(
         std::move(boost::apply_visitor(outputParameterVisitor,
@@ -590,6 +703,11 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
         allDelta[seqNum], 1), mergeLayer);
     totalGradient += backwardGradient;
   }
+
+  // Don't let the next batch draw the random numbers of the first steps.
+  if (checkpointing)
+    arma::arma_rng::set_seed(math::RandInt(std::numeric_limits<int>::max()));
+
   return performance;
 }
 
@@ -612,11 +730,7 @@ template<typename OutputLayerType, typename MergeLayerType,
 void BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
     InitializationRuleType, CustomLayers...>::Shuffle()
 {
-  arma::cube newPredictors, newResponses;
-  math::ShuffleData(predictors, responses, newPredictors, newResponses);
-
-  predictors = std::move(newPredictors);
-  responses = std::move(newResponses);
+  batchPrefetcher.Shuffle(predictors.n_cols);
 }
 
 template<typename OutputLayerType, typename MergeLayerType,
@@ -0,0 +1,596 @@
+/**
+ * @file methods/ann/convolution_rules/im2col_convolution.hpp
+ *
+ * Implementation of the convolution through im2col and matrix multiplication.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution by copying every patch of the input
+ * that is covered by the filter into a column of a matrix (im2col), so that the
+ * convolution becomes a single matrix product.  This class allows
+ * specification of the type of the border type. The convolution can be
+ * computed with the valid border type or the full border type (default).
+ *
+ * FullConvolution: returns the full two-dimensional convolution.
+ * ValidConvolution: returns only those parts of the convolution that are
+ * computed without the zero-padded edges.
+ *
+ * The Convolution() methods have the same interface and give the same results
+ * as those of NaiveConvolution, so this class can be used as convolution rule
+ * for any layer.  In addition, the Forward(), Backward() and Gradient() methods
+ * compute the convolution of a whole batch of multi-channel inputs with all
+ * filters of a layer with one matrix multiplication; the Convolution and
+ * AtrousConvolution layers use these methods when they are given this rule.
+ *
+ * @code
+ * Convolution<Im2ColConvolution<ValidConvolution>,
+ *             Im2ColConvolution<FullConvolution>,
+ *             Im2ColConvolution<ValidConvolution> > layer(1, 6, 5, 5);
+ * @endcode
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class Im2ColConvolution
+{
+ public:
+  /*
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param appending If true, add the result to the given output.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1,
+              const bool appending = false)
+  {
+    if (!appending)
+    {
+      output = arma::zeros<arma::Mat<eT> >(
+        (input.n_rows - (filter.n_rows - 1) * dilationW - 1) / dW + 1,
+        (input.n_cols - (filter.n_cols - 1) * dilationH -  1) / dH + 1);
+    }
+
+    // Use the same indexing as NaiveConvolution.
+    arma::Mat<eT> columns(filter.n_elem, output.n_elem);
+    Im2ColSlice(input.memptr(), input.n_rows, filter.n_rows, filter.n_cols,
+        output.n_rows, output.n_cols, dH, dW, dilationH, dilationW,
+        columns.memptr(), columns.n_rows);
+
+    arma::Col<eT> outputVec(output.memptr(), output.n_elem, false, true);
+    outputVec += columns.t() * arma::vectorise(filter);
+  }
+
+  /*
+   * Perform a convolution (full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param appending If true, add the result to the given output.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1,
+              const bool appending = false)
+  {
+    size_t outputRows = (input.n_rows - 1) * dW + 2 * (filter.n_rows - 1)
+        * dilationW + 1;
+    size_t outputCols = (input.n_cols - 1) * dH + 2 * (filter.n_cols - 1)
+        * dilationH + 1;
+
+    for (size_t i = 0; i < dW; ++i)
+    {
+      if (((((i + outputRows - 2 * (filter.n_rows - 1) * dilationW - 1) % dW)
+          + dW) % dW) == i)
+      {
+        outputRows += i;
+        break;
+      }
+    }
+    for (size_t i = 0; i < dH; ++i)
+    {
+      if (((((i + outputCols - 2 * (filter.n_cols - 1) * dilationH - 1) % dH)
+          + dH) % dH) == i)
+      {
+        outputCols += i;
+        break;
+      }
+    }
+
+    // Pad filter and input to the working output shape.
+    arma::Mat<eT> inputPadded = arma::zeros<arma::Mat<eT> >(outputRows,
+        outputCols);
+    inputPadded.submat((filter.n_rows - 1) * dilationW, (filter.n_cols - 1)
+        * dilationH, (filter.n_rows - 1) * dilationW + input.n_rows - 1,
+        (filter.n_cols - 1) * dilationH + input.n_cols - 1) = input;
+
+    Im2ColConvolution<ValidConvolution>::Convolution(inputPadded, filter,
+        output, 1, 1, dilationW, dilationH, appending);
+  }
+
+  /*
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0),
+        filter.slice(0), convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        filter.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < filter.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(i),
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /**
+   * Compute the forward pass of a convolution layer (valid mode) for a batch
+   * of points.  Slice b * inMaps + i of the input is input map i of point b,
+   * slice o * inMaps + i of the weights is the filter from input map i to
+   * output map o, and slice b * outMaps + o of the output is output map o of
+   * point b.  The output has to be allocated with the size of the output maps;
+   * it is overwritten.
+   *
+   * @param input Input maps of all points.
+   * @param weight Filters of the layer.
+   * @param output Output maps of all points.
+   * @param inMaps Number of input maps of each point.
+   * @param dW Stride of filter application in the x direction (rows).
+   * @param dH Stride of filter application in the y direction (columns).
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Forward(const arma::Cube<eT>& input,
+                      const arma::Cube<eT>& weight,
+                      arma::Cube<eT>& output,
+                      const size_t inMaps,
+                      const size_t dW = 1,
+                      const size_t dH = 1,
+                      const size_t dilationW = 1,
+                      const size_t dilationH = 1)
+  {
+    const size_t outMaps = weight.n_slices / inMaps;
+    const size_t batchSize = input.n_slices / inMaps;
+    const size_t points = output.n_rows * output.n_cols;
+
+    arma::Mat<eT> columns;
+    Im2Col(input, inMaps, weight.n_rows, weight.n_cols, output.n_rows,
+        output.n_cols, dW, dH, dilationW, dilationH, columns);
+
+    // Column o holds all filters of output map o.
+    const arma::Mat<eT> filters(const_cast<eT*>(weight.memptr()),
+        columns.n_rows, outMaps, false, true);
+    const arma::Mat<eT> result = columns.t() * filters;
+
+    // The output maps of a point are stored one after the other, which is a
+    // block of rows of the result.
+    #pragma omp parallel for
+    for (omp_size_t b = 0; b < (omp_size_t) batchSize; ++b)
+    {
+      arma::Mat<eT> outputMaps(output.slice_memptr(b * outMaps), points,
+          outMaps, false, true);
+      outputMaps = result.rows(b * points, (b + 1) * points - 1);
+    }
+  }
+
+  /**
+   * Compute the backward pass of a convolution layer (valid mode) for a batch
+   * of points, that is the gradient of the loss with respect to the input
+   * maps, given the gradient with respect to the output maps.  The layout of
+   * the maps is the same as for Forward().  The result is added to g, which
+   * has to be allocated with the size of the input maps.
+   *
+   * @param error Gradient with respect to the output maps of all points.
+   * @param weight Filters of the layer.
+   * @param g Gradient with respect to the input maps of all points.
+   * @param inMaps Number of input maps of each point.
+   * @param dW Stride of filter application in the x direction (rows).
+   * @param dH Stride of filter application in the y direction (columns).
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Backward(const arma::Cube<eT>& error,
+                       const arma::Cube<eT>& weight,
+                       arma::Cube<eT>& g,
+                       const size_t inMaps,
+                       const size_t dW = 1,
+                       const size_t dH = 1,
+                       const size_t dilationW = 1,
+                       const size_t dilationH = 1)
+  {
+    const size_t outMaps = weight.n_slices / inMaps;
+
+    arma::Mat<eT> errorMatrix;
+    ErrorMatrix(error, outMaps, errorMatrix);
+
+    const arma::Mat<eT> filters(const_cast<eT*>(weight.memptr()),
+        weight.n_rows * weight.n_cols * inMaps, outMaps, false, true);
+    const arma::Mat<eT> columns = filters * errorMatrix.t();
+
+    Col2Im(columns, inMaps, weight.n_rows, weight.n_cols, error.n_rows,
+        error.n_cols, dW, dH, dilationW, dilationH, g);
+  }
+
+  /**
+   * Compute the gradient of the loss with respect to the filters of a
+   * convolution layer (valid mode) for a batch of points, given the gradient
+   * with respect to the output maps.  The layout of the maps is the same as
+   * for Forward().  The gradient has to be allocated with the size of the
+   * filters; it is overwritten.
+   *
+   * @param input Input maps of all points.
+   * @param error Gradient with respect to the output maps of all points.
+   * @param gradient Gradient with respect to the filters.
+   * @param inMaps Number of input maps of each point.
+   * @param dW Stride of filter application in the x direction (rows).
+   * @param dH Stride of filter application in the y direction (columns).
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Gradient(const arma::Cube<eT>& input,
+                       const arma::Cube<eT>& error,
+                       arma::Cube<eT>& gradient,
+                       const size_t inMaps,
+                       const size_t dW = 1,
+                       const size_t dH = 1,
+                       const size_t dilationW = 1,
+                       const size_t dilationH = 1)
+  {
+    const size_t outMaps = gradient.n_slices / inMaps;
+
+    arma::Mat<eT> columns;
+    Im2Col(input, inMaps, gradient.n_rows, gradient.n_cols, error.n_rows,
+        error.n_cols, dW, dH, dilationW, dilationH, columns);
+
+    arma::Mat<eT> errorMatrix;
+    ErrorMatrix(error, outMaps, errorMatrix);
+
+    arma::Mat<eT> filterGradient(gradient.memptr(), columns.n_rows, outMaps,
+        false, true);
+    filterGradient = columns * errorMatrix;
+  }
+
+  /**
+   * Copy every patch of the input maps that is covered by a filter into a
+   * column of the given matrix.  Row (i * kernelHeight + kj) * kernelWidth + ki
+   * of column b * outputWidth * outputHeight + oj * outputWidth + oi holds the
+   * element (oi * dW + ki * dilationW, oj * dH + kj * dilationH) of input map
+   * i of point b.
+   *
+   * @param input Input maps of all points (maps per point).
+   * @param maps Number of input maps of each point.
+   * @param kernelWidth Width of the filters.
+   * @param kernelHeight Height of the filters.
+   * @param outputWidth Width of the output maps.
+   * @param outputHeight Height of the output maps.
+   * @param dW Stride of filter application in the x direction (rows).
+   * @param dH Stride of filter application in the y direction (columns).
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param columns Matrix to store the patches in.
+   */
+  template<typename eT>
+  static void Im2Col(const arma::Cube<eT>& input,
+                     const size_t maps,
+                     const size_t kernelWidth,
+                     const size_t kernelHeight,
+                     const size_t outputWidth,
+                     const size_t outputHeight,
+                     const size_t dW,
+                     const size_t dH,
+                     const size_t dilationW,
+                     const size_t dilationH,
+                     arma::Mat<eT>& columns)
+  {
+    const size_t batchSize = input.n_slices / maps;
+    const size_t kernelSize = kernelWidth * kernelHeight;
+    const size_t points = outputWidth * outputHeight;
+    columns.set_size(kernelSize * maps, points * batchSize);
+
+    #pragma omp parallel for
+    for (omp_size_t b = 0; b < (omp_size_t) batchSize; ++b)
+    {
+      for (size_t i = 0; i < maps; ++i)
+      {
+        Im2ColSlice(input.slice_memptr(b * maps + i), input.n_rows,
+            kernelWidth, kernelHeight, outputWidth, outputHeight, dW, dH,
+            dilationW, dilationH, columns.colptr(b * points) + i * kernelSize,
+            columns.n_rows);
+      }
+    }
+  }
+
+  /**
+   * Add the columns of the given matrix back to the patches of the maps they
+   * were taken from by Im2Col().  Elements that belong to several patches are
+   * summed.
+   *
+   * @param columns Matrix of patches.
+   * @param maps Number of maps of each point.
+   * @param kernelWidth Width of the filters.
+   * @param kernelHeight Height of the filters.
+   * @param outputWidth Width of the output maps.
+   * @param outputHeight Height of the output maps.
+   * @param dW Stride of filter application in the x direction (rows).
+   * @param dH Stride of filter application in the y direction (columns).
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param output Maps of all points to add the patches to.
+   */
+  template<typename eT>
+  static void Col2Im(const arma::Mat<eT>& columns,
+                     const size_t maps,
+                     const size_t kernelWidth,
+                     const size_t kernelHeight,
+                     const size_t outputWidth,
+                     const size_t outputHeight,
+                     const size_t dW,
+                     const size_t dH,
+                     const size_t dilationW,
+                     const size_t dilationH,
+                     arma::Cube<eT>& output)
+  {
+    const size_t batchSize = output.n_slices / maps;
+    const size_t kernelSize = kernelWidth * kernelHeight;
+    const size_t points = outputWidth * outputHeight;
+
+    #pragma omp parallel for
+    for (omp_size_t b = 0; b < (omp_size_t) batchSize; ++b)
+    {
+      for (size_t i = 0; i < maps; ++i)
+      {
+        Col2ImSlice(columns.colptr(b * points) + i * kernelSize,
+            columns.n_rows, kernelWidth, kernelHeight, outputWidth,
+            outputHeight, dW, dH, dilationW, dilationH,
+            output.slice_memptr(b * maps + i), output.n_rows);
+      }
+    }
+  }
+
+ private:
+  /**
+   * Copy the patches of one map into the given columns, which are ld elements
+   * apart.
+   */
+  template<typename eT>
+  static void Im2ColSlice(const eT* input,
+                          const size_t inputRows,
+                          const size_t kernelRows,
+                          const size_t kernelCols,
+                          const size_t outputRows,
+                          const size_t outputCols,
+                          const size_t rowStride,
+                          const size_t colStride,
+                          const size_t rowDilation,
+                          const size_t colDilation,
+                          eT* columns,
+                          const size_t ld)
+  {
+    for (size_t j = 0; j < outputCols; ++j)
+    {
+      for (size_t i = 0; i < outputRows; ++i)
+      {
+        eT* column = columns + (j * outputRows + i) * ld;
+        for (size_t kj = 0; kj < kernelCols; ++kj)
+        {
+          const eT* inputPtr = input + (j * colStride + kj * colDilation) *
+              inputRows + i * rowStride;
+          for (size_t ki = 0; ki < kernelRows; ++ki)
+            *column++ = inputPtr[ki * rowDilation];
+        }
+      }
+    }
+  }
+
+  /**
+   * Add the given columns, which are ld elements apart, back to the patches of
+   * one map.
+   */
+  template<typename eT>
+  static void Col2ImSlice(const eT* columns,
+                          const size_t ld,
+                          const size_t kernelRows,
+                          const size_t kernelCols,
+                          const size_t outputRows,
+                          const size_t outputCols,
+                          const size_t rowStride,
+                          const size_t colStride,
+                          const size_t rowDilation,
+                          const size_t colDilation,
+                          eT* output,
+                          const size_t mapRows)
+  {
+    for (size_t j = 0; j < outputCols; ++j)
+    {
+      for (size_t i = 0; i < outputRows; ++i)
+      {
+        const eT* column = columns + (j * outputRows + i) * ld;
+        for (size_t kj = 0; kj < kernelCols; ++kj)
+        {
+          eT* outputPtr = output + (j * colStride + kj * colDilation) *
+              mapRows + i * rowStride;
+          for (size_t ki = 0; ki < kernelRows; ++ki)
+            outputPtr[ki * rowDilation] += *column++;
+        }
+      }
+    }
+  }
+
+  /**
+   * Arrange the gradient with respect to the output maps as a matrix with one
+   * row for each position of each point and one column for each output map.
+   */
+  template<typename eT>
+  static void ErrorMatrix(const arma::Cube<eT>& error,
+                          const size_t outMaps,
+                          arma::Mat<eT>& errorMatrix)
+  {
+    const size_t batchSize = error.n_slices / outMaps;
+    const size_t points = error.n_rows * error.n_cols;
+    errorMatrix.set_size(points * batchSize, outMaps);
+
+    #pragma omp parallel for
+    for (omp_size_t b = 0; b < (omp_size_t) batchSize; ++b)
+    {
+      const arma::Mat<eT> errorMaps(const_cast<eT*>(
+          error.slice_memptr(b * outMaps)), points, outMaps, false, true);
+      errorMatrix.rows(b * points, (b + 1) * points - 1) = errorMaps;
+    }
+  }
+};  // class Im2ColConvolution
+
+/**
+ * Check whether the given convolution rule is Im2ColConvolution, so that layers
+ * can use its batch methods.
+ */
+template<typename ConvolutionRule>
+struct IsIm2ColConvolution
+{
+  static const bool value = false;
+};
+
+template<typename BorderMode>
+struct IsIm2ColConvolution<Im2ColConvolution<BorderMode> >
+{
+  static const bool value = true;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -26,6 +26,7 @@
 #include "visitor/loss_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "util/batch_prefetcher.hpp"
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
@@ -168,13 +169,60 @@ class FFN
    * reflect the output of the given output layer as returned by the
    * output layer function.
    *
+   * The predictors are passed through the network in batches of batchSize
+   * points, so that each layer works on a matrix of points at once; larger
+   * batches are faster but use more memory for the intermediate outputs of
+   * the layers.  After the first batch, the layer outputs share two buffers
+   * of that size, so predicting does not allocate memory for each batch.
+   *
    * If you want to pass in a parameter and discard the original parameter
    * object, be sure to use std::move to avoid unnecessary copy.
    *
    * @param predictors Input predictors.
    * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Number of points to predict at once.
+   */
+  void Predict(arma::mat predictors,
+               arma::mat& results,
+               const size_t batchSize = 128);
+
+  /**
+   * Prepare a trained network for inference by removing the layers that only
+   * do work during training.  Every BatchNorm layer that directly follows a
+   * Linear or Convolution layer is folded into that layer: in deterministic
+   * mode the normalization is an affine transform per output unit (or channel)
+   * using the running mean and variance, so it can be applied to the weights
+   * and bias of the preceding layer once instead of to every output.  In
+   * addition, IdentityLayer and Dropout layers, which only copy their input
+   * in deterministic mode, are removed.
+   *
+   * The predictions of the network are unchanged (up to floating point
+   * rounding), but the network should not be trained afterwards, since the
+   * removed layers are gone.
+   */
+  void FuseLayers();
+
+  /**
+   * Quantize the weights of every Linear, LinearNoBias and Convolution layer
+   * of a trained network to 8-bit integers, for faster inference with less
+   * memory.  Each of these layers is replaced by a QuantizedLinear or
+   * QuantizedConvolution layer, which keeps one scale per output unit (or
+   * output map) for the weights and accumulates the products of the 8-bit
+   * weights and inputs in 32-bit integers.  The scale of the input of each
+   * layer is chosen such that the largest absolute input that the layer sees
+   * on the given calibration data is mapped to 127.
+   *
+   * The predictions of the network change slightly, so they should be checked
+   * on held-out data.  The network should not be trained afterwards, since the
+   * quantized layers have no trainable parameters.  Since FuseLayers() changes
+   * the weights, it should be called before this function.
+   *
+   * @param calibrationData Input points that are representative of the data
+   *     the network will be used on.
+   * @param batchSize Number of points to pass through the network at once.
    */
-  void Predict(arma::mat predictors, arma::mat& results);
+  void Quantize(const arma::mat& calibrationData,
+                const size_t batchSize = 128);
 
   /**
    * Evaluate the feedforward network with the given predictors and responses.
@@ -304,11 +352,34 @@ class FFN
   //! Modify the network model.  Be careful!  If you change the structure of the
   //! network or parameters for layers, its state may become invalid, so be sure
   //! to call ResetParameters() afterwards.
-  std::vector<LayerTypes<CustomLayers...> >& Model() { return network; }
+  std::vector<LayerTypes<CustomLayers...> >& Model()
+  {
+    layerOutputs.clear();
+    return network;
+  }
 
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return numFunctions; }
 
+  /**
+   * Get the number of threads that share the work of each mini-batch during
+   * training.  If it is greater than one, EvaluateWithGradient() splits the
+   * batch into that many parts, which are passed through copies (replicas) of
+   * the network in parallel; the replicas use the same parameter matrix, and
+   * their gradients are summed in a fixed order, so the result doesn't depend
+   * on the scheduling of the threads.  The output layer is evaluated on the
+   * whole batch, and the penalties of regularizers are only added once, so
+   * the objective is the same as with one thread, except for layers that use
+   * statistics of the batch (like BatchNorm), which compute them over each
+   * part.  The running statistics of these layers are averaged over the
+   * parts.  Each part of the batch is processed with a random seed drawn from
+   * the mlpack random number generator, so training is reproducible after
+   * math::RandomSeed().  Defaults to 1.
+   */
+  size_t Threads() const { return threads; }
+  //! Modify the number of threads that share the work of each mini-batch.
+  size_t& Threads() { return threads; }
+
   //! Return the initial point for the optimization.
   const arma::mat& Parameters() const { return parameter; }
   //! Modify the initial point for the optimization.
@@ -426,6 +497,62 @@ class FFN
    */
   void ResetGradients(arma::mat& gradient);
 
+  /**
+   * Collect the output parameter and the delta of every layer, so that each
+   * step of the forward and backward passes dispatches on the layer type only
+   * once.  The layers hold these matrices themselves, so the collected
+   * pointers stay valid until the layers of the network change.
+   */
+  void ResetLayerGraph();
+
+  /**
+   * Create a copy of the network whose layers use the parameter matrix of this
+   * network, for training in parallel with it.  The caller has to delete the
+   * copy.
+   */
+  FFN* Replica();
+
+  /**
+   * Create the replicas of the network that are used by the other threads
+   * during training.
+   */
+  void ResetReplicas();
+
+  /**
+   * Compute the objective and the gradient for the given batch, split into
+   * parts that are processed in parallel by this network and its replicas.
+   *
+   * @param predictorsBatch Input data of the batch.
+   * @param responsesBatch Responses of the batch.
+   * @param gradient Matrix to output the gradient into; it has to be zeroed.
+   * @return Objective of the batch.
+   */
+  double ParallelEvaluateWithGradient(const arma::mat& predictorsBatch,
+                                      const arma::mat& responsesBatch,
+                                      arma::mat& gradient);
+
+  /**
+   * Replace the layers of the network by the given layers, which may share
+   * layers with the old network, and let them use a new parameter matrix that
+   * holds their current parameters.  The layers that are not used anymore
+   * have to be deleted by the caller.
+   *
+   * @param layers The new layers of the network.
+   */
+  void ReplaceLayers(std::vector<LayerTypes<CustomLayers...> >& layers);
+
+  /**
+   * Let the outputs of the layers share the memory of the workspace, based on
+   * their current sizes.  This is only valid for prediction: the output of
+   * each layer is overwritten by the layer after the next one.
+   */
+  void PlanWorkspace();
+
+  /**
+   * Make sure that no layer output uses the memory of the workspace anymore.
+   */
+  void ReleaseWorkspace();
+
   /**
    * Swap the content of this network with given network.
    *
@@ -452,18 +579,39 @@ class FFN
   //! Locally-stored model modules.
   std::vector<LayerTypes<CustomLayers...> > network;
 
+  //! The output parameter of each layer in the network.
+  std::vector<arma::mat*> layerOutputs;
+
+  //! The delta of each layer in the network.
+  std::vector<arma::mat*> layerDeltas;
+
+  //! The memory shared by the layer outputs during prediction.
+  arma::mat workspace;
+
   //! The matrix of data points (predictors).
   arma::mat predictors;
 
   //! The matrix of responses to the input data points.
   arma::mat responses;
 
+  //! Gathers the batches of the data points after Shuffle().
+  BatchPrefetcher<arma::mat> batchPrefetcher;
+
   //! Matrix of (trained) parameters.
   arma::mat parameter;
 
   //! The number of separable functions (the number of predictor points).
   size_t numFunctions;
 
+  //! The number of threads that share the work of each mini-batch.
+  size_t threads;
+
+  //! The copies of the network used by the other threads during training.
+  std::vector<FFN*> replicas;
+
+  //! The gradients computed by the replicas.
+  std::vector<arma::mat> replicaGradients;
+
   //! The current error for the backward pass.
   arma::mat error;
 
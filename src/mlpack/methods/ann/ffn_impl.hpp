@@ -20,8 +20,11 @@
 #include "visitor/deterministic_set_visitor.hpp"
 #include "visitor/gradient_set_visitor.hpp"
 #include "visitor/gradient_visitor.hpp"
+#include "visitor/parameters_visitor.hpp"
+#include "visitor/regularize_set_visitor.hpp"
 #include "visitor/set_input_height_visitor.hpp"
 #include "visitor/set_input_width_visitor.hpp"
+#include "visitor/training_statistics_visitor.hpp"
 
 #include "util/check_input_shape.hpp"
 
@@ -39,6 +42,7 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     height(0),
     reset(false),
     numFunctions(0),
+    threads(1),
     deterministic(false)
 {
   /* Nothing to do here. */
@@ -50,6 +54,9 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::~FFN()
 {
   std::for_each(network.begin(), network.end(),
       boost::apply_visitor(deleteVisitor));
+
+  for (size_t i = 0; i < replicas.size(); ++i)
+    delete replicas[i];
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -58,6 +65,7 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::ResetData(
     arma::mat predictors, arma::mat responses)
 {
   numFunctions = responses.n_cols;
+  batchPrefetcher.Reset();
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
   this->deterministic = false;
@@ -167,7 +175,7 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Forward(
     ResetParameters();
 
   Forward(inputs);
-  results = boost::apply_visitor(outputParameterVisitor, network.back());
+  results = *layerOutputs.back();
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -179,19 +187,19 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Forward(
     const size_t begin,
     const size_t end)
 {
-  boost::apply_visitor(ForwardVisitor(inputs,
-      boost::apply_visitor(outputParameterVisitor, network[begin])),
+  if (layerOutputs.size() != network.size())
+    ResetLayerGraph();
+
+  boost::apply_visitor(ForwardVisitor(inputs, *layerOutputs[begin]),
       network[begin]);
 
-  for (size_t i = 1; i < end - begin + 1; ++i)
+  for (size_t i = begin + 1; i <= end; ++i)
   {
-    boost::apply_visitor(ForwardVisitor(boost::apply_visitor(
-        outputParameterVisitor, network[begin + i - 1]),
-        boost::apply_visitor(outputParameterVisitor, network[begin + i])),
-        network[begin + i]);
+    boost::apply_visitor(ForwardVisitor(*layerOutputs[i - 1],
+        *layerOutputs[i]), network[i]);
   }
 
-  results = boost::apply_visitor(outputParameterVisitor, network[end]);
+  results = *layerOutputs[end];
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -202,16 +210,17 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward(
     const TargetsType& targets,
     GradientsType& gradients)
 {
-  double res = outputLayer.Forward(boost::apply_visitor(
-      outputParameterVisitor, network.back()), targets);
+  if (layerOutputs.size() != network.size())
+    ResetLayerGraph();
+
+  double res = outputLayer.Forward(*layerOutputs.back(), targets);
 
   for (size_t i = 0; i < network.size(); ++i)
   {
     res += boost::apply_visitor(lossVisitor, network[i]);
   }
 
-  outputLayer.Backward(boost::apply_visitor(outputParameterVisitor,
-      network.back()), targets, error);
+  outputLayer.Backward(*layerOutputs.back(), targets, error);
 
   gradients = arma::zeros<arma::mat>(parameter.n_rows, parameter.n_cols);
 
@@ -225,7 +234,7 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward(
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
-    arma::mat predictors, arma::mat& results)
+    arma::mat predictors, arma::mat& results, const size_t batchSize)
 {
   CheckInputShape<std::vector<LayerTypes<CustomLayers...> > >(network, 
                                                               predictors.n_rows, 
@@ -240,22 +249,237 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
     ResetDeterministic();
   }
 
-  arma::mat resultsTemp;
-  Forward(arma::mat(predictors.colptr(0), predictors.n_rows, 1, false, true));
-  resultsTemp = boost::apply_visitor(outputParameterVisitor,
-      network.back()).col(0);
+  if (batchSize == 0)
+  {
+    Log::Fatal << "FFN<>::Predict(): batchSize must be greater than 0!"
+        << std::endl;
+  }
+
+  results.clear();
+
+  // Process in accordance with the given batch size.
+  for (size_t begin = 0; begin < predictors.n_cols; begin += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols - begin));
+
+    // Wrap a matrix around our data to avoid a copy.
+    Forward(arma::mat(predictors.colptr(begin), predictors.n_rows,
+        effectiveBatchSize, false, true));
+
+    const arma::mat& output = *layerOutputs.back();
+    if (begin == 0)
+      results.set_size(output.n_rows, predictors.n_cols);
+
+    results.cols(begin, begin + effectiveBatchSize - 1) = output;
+
+    // Now that the size of every layer output is known, the remaining batches
+    // can reuse the same memory.
+    if (begin == 0 && effectiveBatchSize < predictors.n_cols)
+      PlanWorkspace();
+  }
+
+  ReleaseWorkspace();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FuseLayers()
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  std::vector<LayerTypes<CustomLayers...> > fused;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    // Layers that only copy their input in deterministic mode can be dropped,
+    // as long as something is left.
+    if ((boost::get<IdentityLayer<>*>(&network[i]) ||
+        boost::get<Dropout<>*>(&network[i])) &&
+        (!fused.empty() || i + 1 < network.size()))
+    {
+      boost::apply_visitor(deleteVisitor, network[i]);
+      continue;
+    }
+
+    BatchNorm<>** batchNorm = boost::get<BatchNorm<>*>(&network[i]);
+    if (batchNorm == NULL || fused.empty())
+    {
+      fused.push_back(network[i]);
+      continue;
+    }
+
+    // In deterministic mode the layer computes
+    // gamma * (x - mean) / sqrt(var + eps) + beta for every unit (or channel),
+    // which is scale * x + shift.
+    BatchNorm<>& layer = **batchNorm;
+    const size_t size = layer.InputSize();
+    const arma::vec scale = layer.Parameters().rows(0, size - 1) /
+        arma::sqrt(layer.TrainingVariance() + layer.Epsilon());
+    const arma::vec shift = layer.Parameters().rows(size, 2 * size - 1) -
+        scale % layer.TrainingMean();
+
+    if (Linear<>** linear = boost::get<Linear<>*>(&fused.back()))
+    {
+      if ((*linear)->OutputSize() != size)
+      {
+        fused.push_back(network[i]);
+        continue;
+      }
+
+      (*linear)->Weight().each_col() %= scale;
+      (*linear)->Bias() = scale % (*linear)->Bias() + shift;
+    }
+    else if (Convolution<>** conv = boost::get<Convolution<>*>(&fused.back()))
+    {
+      const size_t inSize = (*conv)->InputSize();
+      if ((*conv)->OutputSize() != size)
+      {
+        fused.push_back(network[i]);
+        continue;
+      }
+
+      for (size_t outMap = 0; outMap < size; ++outMap)
+      {
+        (*conv)->Weight().slices(outMap * inSize,
+            (outMap + 1) * inSize - 1) *= scale(outMap);
+      }
+      (*conv)->Bias() = scale % (*conv)->Bias() + shift;
+    }
+    else
+    {
+      fused.push_back(network[i]);
+      continue;
+    }
+
+    boost::apply_visitor(deleteVisitor, network[i]);
+  }
+
+  if (fused.size() == network.size())
+    return;
+
+  ReplaceLayers(fused);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Quantize(
+    const arma::mat& calibrationData, const size_t batchSize)
+{
+  CheckInputShape<std::vector<LayerTypes<CustomLayers...> > >(network,
+      calibrationData.n_rows, "FFN<>::Quantize()");
+
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  if (batchSize == 0)
+  {
+    Log::Fatal << "FFN<>::Quantize(): batchSize must be greater than 0!"
+        << std::endl;
+  }
+
+  // Find the largest absolute input of each layer on the calibration data.
+  std::vector<double> inputRange(network.size(), 0.0);
+  for (size_t begin = 0; begin < calibrationData.n_cols; begin += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(calibrationData.n_cols - begin));
 
-  results = arma::mat(resultsTemp.n_elem, predictors.n_cols);
-  results.col(0) = resultsTemp.col(0);
+    // Wrap a matrix around our data to avoid a copy.
+    const arma::mat batch(const_cast<double*>(calibrationData.colptr(begin)),
+        calibrationData.n_rows, effectiveBatchSize, false, true);
+    Forward(batch);
 
-  for (size_t i = 1; i < predictors.n_cols; ++i)
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+      const arma::mat& input = (i == 0) ? batch : *layerOutputs[i - 1];
+      if (!input.is_empty())
+        inputRange[i] = std::max(inputRange[i], arma::abs(input).max());
+    }
+  }
+
+  std::vector<LayerTypes<CustomLayers...> > quantized;
+  for (size_t i = 0; i < network.size(); ++i)
   {
-    Forward(arma::mat(predictors.colptr(i), predictors.n_rows, 1, false, true));
+    const double inputScale = (inputRange[i] > 0.0) ?
+        inputRange[i] / 127.0 : 1.0;
 
-    resultsTemp = boost::apply_visitor(outputParameterVisitor,
-        network.back());
-    results.col(i) = resultsTemp.col(0);
+    if (Linear<>** linear = boost::get<Linear<>*>(&network[i]))
+    {
+      quantized.push_back(new QuantizedLinear<>(**linear, inputScale));
+    }
+    else if (LinearNoBias<>** linearNoBias =
+        boost::get<LinearNoBias<>*>(&network[i]))
+    {
+      quantized.push_back(new QuantizedLinear<>(**linearNoBias, inputScale));
+    }
+    else if (Convolution<>** conv = boost::get<Convolution<>*>(&network[i]))
+    {
+      quantized.push_back(new QuantizedConvolution<>(**conv, inputScale));
+    }
+    else
+    {
+      quantized.push_back(network[i]);
+      continue;
+    }
+
+    boost::apply_visitor(deleteVisitor, network[i]);
   }
+
+  ReplaceLayers(quantized);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+ReplaceLayers(std::vector<LayerTypes<CustomLayers...> >& layers)
+{
+  // Collect the (updated) parameters of the remaining layers, which still
+  // point into the old parameter matrix.
+  size_t weights = 0;
+  std::vector<arma::mat> layerParameters(layers.size());
+  for (size_t i = 0; i < layers.size(); ++i)
+  {
+    boost::apply_visitor(ParametersVisitor(layerParameters[i]), layers[i]);
+    weights += boost::apply_visitor(weightSizeVisitor, layers[i]);
+  }
+
+  arma::mat newParameter(weights, 1);
+  size_t offset = 0;
+  for (size_t i = 0; i < layers.size(); ++i)
+  {
+    const size_t layerWeights = boost::apply_visitor(weightSizeVisitor,
+        layers[i]);
+    if (layerWeights > 0)
+    {
+      newParameter.rows(offset, offset + layerWeights - 1) =
+          arma::vectorise(layerParameters[i]);
+    }
+    offset += layerWeights;
+  }
+
+  // Let the layers use the new parameter matrix.  Resetting a layer may
+  // initialize its weights, so the values are copied afterwards.
+  network = std::move(layers);
+  parameter = newParameter;
+  offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    offset += boost::apply_visitor(WeightSetVisitor(parameter, offset),
+        network[i]);
+    boost::apply_visitor(resetVisitor, network[i]);
+  }
+  parameter = newParameter;
+
+  deterministic = true;
+  ResetDeterministic();
+  layerOutputs.clear();
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -279,8 +503,7 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
 
   Forward(predictors);
 
-  double res = outputLayer.Forward(boost::apply_visitor(
-      outputParameterVisitor, network.back()), responses);
+  double res = outputLayer.Forward(*layerOutputs.back(), responses);
 
   for (size_t i = 0; i < network.size(); ++i)
   {
@@ -319,10 +542,26 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     ResetDeterministic();
   }
 
-  Forward(predictors.cols(begin, begin + batchSize - 1));
-  double res = outputLayer.Forward(
-      boost::apply_visitor(outputParameterVisitor, network.back()),
-      responses.cols(begin, begin + batchSize - 1));
+  // After Shuffle() the points of the batch are gathered in the random order;
+  // otherwise they are used in place.
+  const bool shuffled = batchPrefetcher.Shuffled();
+  if (shuffled)
+    batchPrefetcher.Fetch(predictors, responses, begin, batchSize);
+
+  arma::mat& predictorsData = shuffled ? batchPrefetcher.Predictors() :
+      predictors;
+  arma::mat& responsesData = shuffled ? batchPrefetcher.Responses() :
+      responses;
+  const size_t first = shuffled ? 0 : begin;
+
+  // Wrap matrices around the batch to avoid a copy.
+  const arma::mat predictorsBatch(predictorsData.colptr(first),
+      predictors.n_rows, batchSize, false, true);
+  const arma::mat responsesBatch(responsesData.colptr(first),
+      responses.n_rows, batchSize, false, true);
+
+  Forward(predictorsBatch);
+  double res = outputLayer.Forward(*layerOutputs.back(), responsesBatch);
 
   for (size_t i = 0; i < network.size(); ++i)
   {
@@ -380,24 +619,43 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     ResetDeterministic();
   }
 
-  Forward(predictors.cols(begin, begin + batchSize - 1));
-  double res = outputLayer.Forward(
-      boost::apply_visitor(outputParameterVisitor, network.back()),
-      responses.cols(begin, begin + batchSize - 1));
+  // After Shuffle() the points of the batch are gathered in the random order;
+  // otherwise they are used in place.
+  const bool shuffled = batchPrefetcher.Shuffled();
+  if (shuffled)
+    batchPrefetcher.Fetch(predictors, responses, begin, batchSize);
+
+  arma::mat& predictorsData = shuffled ? batchPrefetcher.Predictors() :
+      predictors;
+  arma::mat& responsesData = shuffled ? batchPrefetcher.Responses() :
+      responses;
+  const size_t first = shuffled ? 0 : begin;
+
+  // Wrap matrices around the batch to avoid a copy.
+  const arma::mat predictorsBatch(predictorsData.colptr(first),
+      predictors.n_rows, batchSize, false, true);
+  const arma::mat responsesBatch(responsesData.colptr(first),
+      responses.n_rows, batchSize, false, true);
+
+  if (threads > 1 && batchSize > 1)
+  {
+    return ParallelEvaluateWithGradient(predictorsBatch, responsesBatch,
+        gradient);
+  }
+
+  Forward(predictorsBatch);
+  double res = outputLayer.Forward(*layerOutputs.back(), responsesBatch);
 
   for (size_t i = 0; i < network.size(); ++i)
   {
     res += boost::apply_visitor(lossVisitor, network[i]);
   }
 
-  outputLayer.Backward(
-      boost::apply_visitor(outputParameterVisitor, network.back()),
-      responses.cols(begin, begin + batchSize - 1),
-      error);
+  outputLayer.Backward(*layerOutputs.back(), responsesBatch, error);
 
   Backward();
   ResetGradients(gradient);
-  Gradient(predictors.cols(begin, begin + batchSize - 1));
+  Gradient(predictorsBatch);
 
   return res;
 }
@@ -417,7 +675,7 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Shuffle()
 {
-  math::ShuffleData(predictors, responses, predictors, responses);
+  batchPrefetcher.Shuffle(predictors.n_cols);
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -431,6 +689,9 @@ void FFN<OutputLayerType, InitializationRuleType,
   NetworkInitialization<InitializationRuleType,
                         CustomLayers...> networkInit(initializeRule);
   networkInit.Initialize(network, parameter);
+
+  // The structure of the network may have changed.
+  layerOutputs.clear();
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -456,14 +717,77 @@ void FFN<OutputLayerType, InitializationRuleType,
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ResetLayerGraph()
+{
+  layerOutputs.resize(network.size());
+  layerDeltas.resize(network.size());
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    layerOutputs[i] = &boost::apply_visitor(outputParameterVisitor,
+        network[i]);
+    layerDeltas[i] = &boost::apply_visitor(deltaVisitor, network[i]);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::PlanWorkspace()
+{
+  // Without a backward pass, the output of a layer is only needed until the
+  // next layer has been run, so alternating between two buffers is enough.
+  size_t bufferSize = 0;
+  for (size_t i = 0; i < layerOutputs.size(); ++i)
+    bufferSize = std::max(bufferSize, (size_t) layerOutputs[i]->n_elem);
+
+  workspace.set_size(bufferSize, 2);
+  for (size_t i = 0; i < layerOutputs.size(); ++i)
+  {
+    arma::mat& output = *layerOutputs[i];
+    if (output.is_empty())
+      continue;
+
+    // The alias is not strict: if the size of a layer output changes (for
+    // instance for the last, smaller batch), the layer simply allocates its
+    // own memory again.
+    output = arma::mat(workspace.colptr(i % 2), output.n_rows, output.n_cols,
+        false, false);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ReleaseWorkspace()
+{
+  if (workspace.is_empty())
+    return;
+
+  // Training needs the outputs of all layers at once, so no layer may keep
+  // using the workspace.
+  const double* begin = workspace.memptr();
+  const double* end = workspace.memptr() + workspace.n_elem;
+  for (size_t i = 0; i < layerOutputs.size(); ++i)
+  {
+    const double* memory = layerOutputs[i]->memptr();
+    if (memory >= begin && memory < end)
+      layerOutputs[i]->reset();
+  }
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename InputType>
 void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Forward(const InputType& input)
 {
-  boost::apply_visitor(ForwardVisitor(input,
-      boost::apply_visitor(outputParameterVisitor, network.front())),
+  if (layerOutputs.size() != network.size())
+    ResetLayerGraph();
+
+  boost::apply_visitor(ForwardVisitor(input, *layerOutputs.front()),
       network.front());
 
   if (!reset)
@@ -490,9 +814,8 @@ void FFN<OutputLayerType, InitializationRuleType,
       boost::apply_visitor(SetInputHeightVisitor(height), network[i]);
     }
 
-    boost::apply_visitor(ForwardVisitor(boost::apply_visitor(
-        outputParameterVisitor, network[i - 1]),
-        boost::apply_visitor(outputParameterVisitor, network[i])), network[i]);
+    boost::apply_visitor(ForwardVisitor(*layerOutputs[i - 1],
+        *layerOutputs[i]), network[i]);
 
     if (!reset)
     {
@@ -518,17 +841,14 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward()
 {
-  boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
-      outputParameterVisitor, network.back()), error,
-      boost::apply_visitor(deltaVisitor, network.back())), network.back());
+  boost::apply_visitor(BackwardVisitor(*layerOutputs.back(), error,
+      *layerDeltas.back()), network.back());
 
   for (size_t i = 2; i < network.size(); ++i)
   {
-    boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
-        outputParameterVisitor, network[network.size() - i]),
-        boost::apply_visitor(deltaVisitor, network[network.size() - i + 1]),
-        boost::apply_visitor(deltaVisitor, network[network.size() - i])),
-        network[network.size() - i]);
+    const size_t l = network.size() - i;
+    boost::apply_visitor(BackwardVisitor(*layerOutputs[l],
+        *layerDeltas[l + 1], *layerDeltas[l]), network[l]);
   }
 }
 
@@ -538,19 +858,17 @@ template<typename InputType>
 void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Gradient(const InputType& input)
 {
-  boost::apply_visitor(GradientVisitor(input,
-      boost::apply_visitor(deltaVisitor, network[1])), network.front());
+  boost::apply_visitor(GradientVisitor(input, *layerDeltas[1]),
+      network.front());
 
   for (size_t i = 1; i < network.size() - 1; ++i)
   {
-    boost::apply_visitor(GradientVisitor(boost::apply_visitor(
-        outputParameterVisitor, network[i - 1]),
-        boost::apply_visitor(deltaVisitor, network[i + 1])), network[i]);
+    boost::apply_visitor(GradientVisitor(*layerOutputs[i - 1],
+        *layerDeltas[i + 1]), network[i]);
   }
 
-  boost::apply_visitor(GradientVisitor(boost::apply_visitor(
-      outputParameterVisitor, network[network.size() - 2]), error),
-      network[network.size() - 1]);
+  boost::apply_visitor(GradientVisitor(*layerOutputs[network.size() - 2],
+      error), network.back());
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -571,6 +889,7 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
     std::for_each(network.begin(), network.end(),
         boost::apply_visitor(deleteVisitor));
     network.clear();
+    layerOutputs.clear();
   }
 
   ar(CEREAL_VECTOR_VARIANT_POINTER(network));
@@ -592,21 +911,211 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+FFN<OutputLayerType, InitializationRuleType, CustomLayers...>*
+FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Replica()
+{
+  FFN* replica = new FFN(outputLayer, initializeRule);
+  for (size_t i = 0; i < network.size(); ++i)
+    replica->network.push_back(boost::apply_visitor(copyVisitor, network[i]));
+
+  // Resetting a layer may initialize its weights, which are shared with this
+  // network, so the values are restored afterwards.
+  const arma::mat values = parameter;
+  replica->parameter = arma::mat(parameter.memptr(), parameter.n_rows,
+      parameter.n_cols, false, false);
+  size_t offset = 0;
+  for (size_t i = 0; i < replica->network.size(); ++i)
+  {
+    offset += boost::apply_visitor(WeightSetVisitor(replica->parameter,
+        offset), replica->network[i]);
+    boost::apply_visitor(resetVisitor, replica->network[i]);
+  }
+  parameter = values;
+
+  // If this network hasn't seen any input yet, the replica infers the input
+  // sizes of its layers on its own first pass.
+  replica->reset = reset;
+  replica->deterministic = false;
+  replica->ResetDeterministic();
+  return replica;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ResetReplicas()
+{
+  for (size_t i = 0; i < replicas.size(); ++i)
+    delete replicas[i];
+  replicas.clear();
+
+  // The penalties of the regularizers are only added by this network, so that
+  // they are counted once in the summed gradient.
+  for (size_t t = 1; t < threads; ++t)
+  {
+    replicas.push_back(Replica());
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+      boost::apply_visitor(RegularizeSetVisitor(false),
+          replicas.back()->network[i]);
+    }
+  }
+
+  replicaGradients.resize(replicas.size());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+ParallelEvaluateWithGradient(const arma::mat& predictorsBatch,
+                             const arma::mat& responsesBatch,
+                             arma::mat& gradient)
+{
+  // The replicas are stale if the layers or the parameter matrix changed.
+  if (replicas.size() + 1 != threads || (!replicas.empty() &&
+      (replicas[0]->parameter.memptr() != parameter.memptr() ||
+      replicas[0]->network.size() != network.size())))
+  {
+    ResetReplicas();
+  }
+
+  // Split the batch into parts of (nearly) the same size.
+  const size_t batchSize = predictorsBatch.n_cols;
+  const size_t parts = std::min(threads, batchSize);
+  std::vector<size_t> bounds(parts + 1);
+  for (size_t t = 0; t < parts; ++t)
+    bounds[t] = t * batchSize / parts;
+  bounds[parts] = batchSize;
+  const math::ParallelSeeds seeds(parts);
+
+  // The running statistics of layers like BatchNorm start from the values of
+  // this network in every part.
+  std::vector<std::vector<arma::mat*> > statistics(parts);
+  std::vector<std::vector<size_t*> > counts(parts);
+  for (size_t t = 0; t < parts; ++t)
+  {
+    FFN& net = (t == 0) ? *this : *replicas[t - 1];
+    for (size_t i = 0; i < net.network.size(); ++i)
+    {
+      boost::apply_visitor(TrainingStatisticsVisitor(statistics[t],
+          counts[t]), net.network[i]);
+    }
+  }
+
+  for (size_t t = 1; t < parts; ++t)
+  {
+    for (size_t k = 0; k < statistics[t].size(); ++k)
+      *statistics[t][k] = *statistics[0][k];
+    for (size_t k = 0; k < counts[t].size(); ++k)
+      *counts[t][k] = *counts[0][k];
+  }
+
+  #pragma omp parallel for
+  for (omp_size_t t = 0; t < (omp_size_t) parts; ++t)
+  {
+    FFN& net = (t == 0) ? *this : *replicas[t - 1];
+    seeds.Seed(t);
+
+    // Wrap a matrix around the part to avoid a copy.
+    const arma::mat input(const_cast<double*>(predictorsBatch.colptr(
+        bounds[t])), predictorsBatch.n_rows, bounds[t + 1] - bounds[t], false,
+        true);
+    net.Forward(input);
+  }
+
+  seeds.Reseed();
+
+  // The running statistics are updated linearly, so their average over the
+  // parts, weighted by the size of the parts, is the update with the average
+  // of the batch statistics of the parts.
+  for (size_t k = 0; k < statistics[0].size(); ++k)
+  {
+    *statistics[0][k] *= (double) (bounds[1] - bounds[0]) / batchSize;
+    for (size_t t = 1; t < parts; ++t)
+    {
+      *statistics[0][k] += (double) (bounds[t + 1] - bounds[t]) / batchSize *
+          *statistics[t][k];
+    }
+  }
+
+  // The output layer is evaluated on the whole batch, since the loss may be
+  // normalized by the number of points.
+  arma::mat output;
+  for (size_t t = 0; t < parts; ++t)
+  {
+    const arma::mat& partOutput = (t == 0) ? *layerOutputs.back() :
+        *replicas[t - 1]->layerOutputs.back();
+    if (t == 0)
+      output.set_size(partOutput.n_rows, batchSize);
+
+    output.cols(bounds[t], bounds[t + 1] - 1) = partOutput;
+  }
+
+  double res = outputLayer.Forward(output, responsesBatch);
+
+  arma::mat batchError;
+  outputLayer.Backward(output, responsesBatch, batchError);
+
+  #pragma omp parallel for
+  for (omp_size_t t = 0; t < (omp_size_t) parts; ++t)
+  {
+    FFN& net = (t == 0) ? *this : *replicas[t - 1];
+    arma::mat& partGradient = (t == 0) ? gradient : replicaGradients[t - 1];
+    if (t != 0)
+      partGradient.zeros(parameter.n_rows, parameter.n_cols);
+
+    const arma::mat input(const_cast<double*>(predictorsBatch.colptr(
+        bounds[t])), predictorsBatch.n_rows, bounds[t + 1] - bounds[t], false,
+        true);
+    net.error = batchError.cols(bounds[t], bounds[t + 1] - 1);
+    net.Backward();
+    net.ResetGradients(partGradient);
+    net.Gradient(input);
+  }
+
+  // Sum the results in a fixed order.  The losses of the layers are averages
+  // over the points of each part, so they are weighted by the size of the part.
+  for (size_t t = 0; t < parts; ++t)
+  {
+    const FFN& net = (t == 0) ? *this : *replicas[t - 1];
+    const double weight = (double) (bounds[t + 1] - bounds[t]) / batchSize;
+    for (size_t i = 0; i < net.network.size(); ++i)
+      res += weight * boost::apply_visitor(lossVisitor, net.network[i]);
+
+    if (t != 0)
+      gradient += replicaGradients[t - 1];
+  }
+
+  return res;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Swap(FFN& network)
 {
+  // The points are visited in order again.
+  batchPrefetcher.Reset();
+  network.batchPrefetcher.Reset();
+
   std::swap(outputLayer, network.outputLayer);
   std::swap(initializeRule, network.initializeRule);
   std::swap(width, network.width);
   std::swap(height, network.height);
   std::swap(reset, network.reset);
   std::swap(this->network, network.network);
+  std::swap(layerOutputs, network.layerOutputs);
+  std::swap(layerDeltas, network.layerDeltas);
+  std::swap(workspace, network.workspace);
   std::swap(predictors, network.predictors);
   std::swap(responses, network.responses);
   std::swap(parameter, network.parameter);
   std::swap(numFunctions, network.numFunctions);
+  std::swap(threads, network.threads);
+  std::swap(replicas, network.replicas);
+  std::swap(replicaGradients, network.replicaGradients);
   std::swap(error, network.error);
   std::swap(deterministic, network.deterministic);
   std::swap(delta, network.delta);
@@ -628,6 +1137,7 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     responses(network.responses),
     parameter(network.parameter),
     numFunctions(network.numFunctions),
+    threads(network.threads),
     error(network.error),
     deterministic(network.deterministic),
     delta(network.delta),
@@ -653,10 +1163,11 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     width(network.width),
     height(network.height),
     reset(network.reset),
-    predictors(std::move(network.predictors)),
-    responses(std::move(network.responses)),
     parameter(std::move(network.parameter)),
     numFunctions(network.numFunctions),
+    threads(network.threads),
+    replicas(std::move(network.replicas)),
+    replicaGradients(std::move(network.replicaGradients)),
     error(std::move(network.error)),
     deterministic(network.deterministic),
     delta(std::move(network.delta)),
@@ -664,7 +1175,14 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     outputParameter(std::move(network.outputParameter)),
     gradient(std::move(network.gradient))
 {
+  // The data can only be moved once no batch of it is being gathered.
+  network.batchPrefetcher.Reset();
+  predictors = std::move(network.predictors);
+  responses = std::move(network.responses);
+
   this->network = std::move(network.network);
+  layerOutputs = std::move(network.layerOutputs);
+  layerDeltas = std::move(network.layerDeltas);
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -326,6 +326,21 @@ class GAN
   //! Modify the matrix of data points (predictors).
   arma::mat& Predictors() { return predictors; }
 
+  /**
+   * Get whether the passes of the Discriminator on the real and the generated
+   * data run concurrently during training.  If true, the real batch is passed
+   * through a copy of the Discriminator that uses the same parameters on a
+   * second thread, which also samples the noise of the next step, while the
+   * Generator and the Discriminator process the generated batch.  Each of the
+   * two threads uses a random seed drawn from the mlpack random number
+   * generator, so training is reproducible after math::RandomSeed().  Layers
+   * that keep statistics of the batches (like BatchNorm) only see the
+   * generated batches in the Discriminator itself.  Defaults to false.
+   */
+  bool Concurrent() const { return concurrent; }
+  //! Modify whether the passes of the Discriminator run concurrently.
+  bool& Concurrent() { return concurrent; }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
@@ -337,6 +352,22 @@ class GAN
   */
   void ResetDeterministic();
 
+  //! Fill the noise matrix, either with the noise sampled ahead during the
+  //! previous step or with new samples.
+  void SampleNoise();
+
+  /**
+   * Compute the gradient of the Discriminator on the real batch that starts
+   * at the given point, and add the objective of the given pass over the
+   * generated batch.  If Concurrent() is true, both run at the same time.
+   *
+   * @param i Index of the first point of the real batch.
+   * @param fakePass Function that passes the generated batch through the
+   *     networks and returns its objective.
+   */
+  template<typename FakePassType>
+  double DiscriminatorPasses(const size_t i, FakePassType& fakePass);
+
   //! Locally stored parameter for training data + noise data.
   arma::mat predictors;
   //! Locally stored parameters of the network.
@@ -401,6 +432,14 @@ class GAN
   size_t genWeights;
   //! To keep track of number of discriminator weights in total weights.
   size_t discWeights;
+  //! Whether the passes on the real and the generated data run concurrently.
+  bool concurrent;
+  //! Copy of the Discriminator that processes the real data concurrently.
+  std::unique_ptr<Model> discriminatorReplica;
+  //! Locally stored noise of the next step.
+  arma::mat nextNoise;
+  //! Whether the noise of the next step has been sampled.
+  bool nextNoiseReady;
 };
 
 } // namespace ann
@@ -56,7 +56,9 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::GAN(
     reset(false),
     deterministic(false),
     genWeights(0),
-    discWeights(0)
+    discWeights(0),
+    concurrent(false),
+    nextNoiseReady(false)
 {
   // Insert IdentityLayer for joining the Generator and Discriminator.
   this->discriminator.network.insert(
@@ -92,7 +94,10 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::GAN(
     noise(network.noise),
     deterministic(network.deterministic),
     genWeights(network.genWeights),
-    discWeights(network.discWeights)
+    discWeights(network.discWeights),
+    concurrent(network.concurrent),
+    nextNoise(network.nextNoise),
+    nextNoiseReady(network.nextNoiseReady)
 {
   /* Nothing to do here */
 }
@@ -125,7 +130,10 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::GAN(
     noise(std::move(network.noise)),
     deterministic(network.deterministic),
     genWeights(network.genWeights),
-    discWeights(network.discWeights)
+    discWeights(network.discWeights),
+    concurrent(network.concurrent),
+    nextNoise(std::move(network.nextNoise)),
+    nextNoiseReady(network.nextNoiseReady)
 {
   /* Nothing to do here */
 }
@@ -143,6 +151,7 @@ void GAN<Model, InitializationRuleType, Noise, PolicyType>::ResetData(
 
   numFunctions = trainData.n_cols;
   noise.set_size(noiseDim, batchSize);
+  nextNoiseReady = false;
 
   deterministic = true;
   ResetDeterministic();
@@ -334,20 +343,22 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       gradientGenerator.n_elem,
       discriminator.Parameters().n_elem, 1, false, false);
 
-  // Get the gradients of the Discriminator.
-  double res = discriminator.EvaluateWithGradient(discriminator.parameter,
-      i, gradientDiscriminator, batchSize);
+  SampleNoise();
+  auto fakePass = [&]() -> double
+  {
+    generator.Forward(noise);
+    predictors.cols(numFunctions, numFunctions + batchSize - 1) =
+        boost::apply_visitor(outputParameterVisitor, generator.network.back());
+    responses.cols(numFunctions, numFunctions + batchSize - 1) =
+        arma::zeros(1, batchSize);
 
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(noise);
-  predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      boost::apply_visitor(outputParameterVisitor, generator.network.back());
-  responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      arma::zeros(1, batchSize);
+    // Get the gradients of the Generator.
+    return discriminator.EvaluateWithGradient(discriminator.parameter,
+        numFunctions, noiseGradientDiscriminator, batchSize);
+  };
 
-  // Get the gradients of the Generator.
-  res += discriminator.EvaluateWithGradient(discriminator.parameter,
-      numFunctions, noiseGradientDiscriminator, batchSize);
+  // Get the gradients of the Discriminator.
+  double res = DiscriminatorPasses(i, fakePass);
   gradientDiscriminator += noiseGradientDiscriminator;
 
   if (currentBatch % generatorUpdateStep == 0 && preTrainSize == 0)
@@ -403,6 +414,84 @@ Gradient(const arma::mat& parameters,
   this->EvaluateWithGradient(parameters, i, gradient, batchSize);
 }
 
+template<
+  typename Model,
+  typename InitializationRuleType,
+  typename Noise,
+  typename PolicyType
+>
+void GAN<Model, InitializationRuleType, Noise, PolicyType>::SampleNoise()
+{
+  if (nextNoiseReady)
+  {
+    noise.swap(nextNoise);
+    nextNoiseReady = false;
+  }
+  else
+  {
+    noise.imbue( [&]() { return noiseFunction();} );
+  }
+}
+
+template<
+  typename Model,
+  typename InitializationRuleType,
+  typename Noise,
+  typename PolicyType
+>
+template<typename FakePassType>
+double GAN<Model, InitializationRuleType, Noise, PolicyType>::
+DiscriminatorPasses(const size_t i, FakePassType& fakePass)
+{
+  if (!concurrent)
+  {
+    const double res = discriminator.EvaluateWithGradient(
+        discriminator.parameter, i, gradientDiscriminator, batchSize);
+    return res + fakePass();
+  }
+
+  // The replica is stale if the layers or the parameter matrix changed.
+  if (!discriminatorReplica || discriminatorReplica->parameter.memptr() !=
+      discriminator.parameter.memptr() || discriminatorReplica->network.size()
+      != discriminator.network.size())
+  {
+    discriminatorReplica.reset(discriminator.Replica());
+  }
+
+  // The last real batch may reach into the columns of the generated batch,
+  // which are overwritten by the other pass, so the real batch is copied.
+  discriminatorReplica->predictors = predictors.cols(i, i + batchSize - 1);
+  discriminatorReplica->responses = responses.cols(i, i + batchSize - 1);
+
+  const math::ParallelSeeds seeds(2);
+  double res[2];
+  #pragma omp parallel for
+  for (omp_size_t t = 0; t < 2; ++t)
+  {
+    seeds.Seed(t);
+    if (t == 0)
+    {
+      res[0] = discriminatorReplica->EvaluateWithGradient(
+          discriminatorReplica->parameter, 0, gradientDiscriminator,
+          batchSize);
+
+      // The noise doesn't depend on the parameters, so the noise of the next
+      // step can be sampled already.
+      nextNoise.set_size(noiseDim, batchSize);
+      nextNoise.imbue( [&]() { return noiseFunction();} );
+    }
+    else
+    {
+      res[1] = fakePass();
+    }
+  }
+
+  seeds.Reseed();
+  nextNoiseReady = true;
+
+  return res[0] + res[1];
+}
+
 template<
   typename Model,
   typename InitializationRuleType,
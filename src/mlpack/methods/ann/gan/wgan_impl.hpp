@@ -127,20 +127,22 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       gradientGenerator.n_elem,
       discriminator.Parameters().n_elem, 1, false, false);
 
-  // Get the gradients of the Discriminator.
-  double res = discriminator.EvaluateWithGradient(discriminator.parameter,
-      i, gradientDiscriminator, batchSize);
+  SampleNoise();
+  auto fakePass = [&]() -> double
+  {
+    generator.Forward(noise);
+    predictors.cols(numFunctions, numFunctions + batchSize - 1) =
+        boost::apply_visitor(outputParameterVisitor, generator.network.back());
+    responses.cols(numFunctions, numFunctions + batchSize - 1) =
+        -arma::ones(1, batchSize);
 
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(noise);
-  predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      boost::apply_visitor(outputParameterVisitor, generator.network.back());
-  responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      -arma::ones(1, batchSize);
+    // Get the gradients of the Generator.
+    return discriminator.EvaluateWithGradient(discriminator.parameter,
+        numFunctions, noiseGradientDiscriminator, batchSize);
+  };
 
-  // Get the gradients of the Generator.
-  res += discriminator.EvaluateWithGradient(discriminator.parameter,
-      numFunctions, noiseGradientDiscriminator, batchSize);
+  // Get the gradients of the Discriminator.
+  double res = DiscriminatorPasses(i, fakePass);
   gradientDiscriminator += noiseGradientDiscriminator;
   gradientDiscriminator = arma::clamp(gradientDiscriminator,
       -clippingParameter, clippingParameter);
@@ -144,29 +144,36 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   currentInput = arma::mat(predictors.memptr() + (i * predictors.n_rows),
       predictors.n_rows, batchSize, false, false);
 
-  // Get the gradients of the Discriminator.
-  double res = discriminator.EvaluateWithGradient(discriminator.parameter,
-      i, gradientDiscriminator, batchSize);
+  SampleNoise();
 
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(std::move(noise));
-  arma::mat generatedData = boost::apply_visitor(outputParameterVisitor,
-      generator.network.back());
+  // The interpolation weight is drawn here, since the noise of the next step
+  // may be sampled while the generated batch is processed.
+  const double epsilon = math::Random();
+  auto fakePass = [&]() -> double
+  {
+    generator.Forward(noise);
+    arma::mat generatedData = boost::apply_visitor(outputParameterVisitor,
+        generator.network.back());
 
-  // Gradient Penalty is calculated here.
-  double epsilon = math::Random();
-  predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      (epsilon * currentInput) + ((1.0 - epsilon) * generatedData);
-  responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      -arma::ones(1, batchSize);
-  discriminator.Gradient(discriminator.parameter, numFunctions,
-      normGradientDiscriminator, batchSize);
-  res += lambda * std::pow(arma::norm(normGradientDiscriminator, 2) - 1, 2);
+    // Gradient Penalty is calculated here.
+    predictors.cols(numFunctions, numFunctions + batchSize - 1) =
+        (epsilon * currentInput) + ((1.0 - epsilon) * generatedData);
+    responses.cols(numFunctions, numFunctions + batchSize - 1) =
+        -arma::ones(1, batchSize);
+    discriminator.Gradient(discriminator.parameter, numFunctions,
+        normGradientDiscriminator, batchSize);
+    double res = lambda * std::pow(arma::norm(normGradientDiscriminator, 2) -
+        1, 2);
+
+    predictors.cols(numFunctions, numFunctions + batchSize - 1) =
+        generatedData;
+    res += discriminator.EvaluateWithGradient(discriminator.parameter,
+        numFunctions, noiseGradientDiscriminator, batchSize);
+    return res;
+  };
 
-  predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      generatedData;
-  res += discriminator.EvaluateWithGradient(discriminator.parameter,
-      numFunctions, noiseGradientDiscriminator, batchSize);
+  // Get the gradients of the Discriminator.
+  double res = DiscriminatorPasses(i, fakePass);
   gradientDiscriminator += noiseGradientDiscriminator;
 
   if (currentBatch % generatorUpdateStep == 0 && preTrainSize == 0)
@@ -75,7 +75,7 @@ class NetworkInitialization
         // initialization rule.
         const size_t weight = boost::apply_visitor(weightSizeVisitor,
             network[i]);
-        arma::Mat<eT> tmp = arma::mat(parameter.memptr() + offset,
+        arma::Mat<eT> tmp = arma::Mat<eT>(parameter.memptr() + offset,
             weight, 1, false, false);
         initializeRule.Initialize(tmp, tmp.n_elem, 1);
 
@@ -209,6 +209,30 @@ void AtrousConvolution<
   output.set_size(wConv * hConv * outSize, batchSize);
   outputTemp = arma::Cube<eT>(output.memptr(), wConv, hConv,
       outSize * batchSize, false, false);
+
+  if (IsIm2ColConvolution<ForwardConvolutionRule>::value)
+  {
+    // Convolve the whole batch with all filters in one matrix product.
+    if (padding.PadWLeft() != 0 || padding.PadWRight() != 0 ||
+        padding.PadHTop() != 0 || padding.PadHBottom() != 0)
+    {
+      Im2ColConvolution<>::Forward(inputPaddedTemp, weight, outputTemp,
+          inSize, strideWidth, strideHeight, dilationWidth, dilationHeight);
+    }
+    else
+    {
+      Im2ColConvolution<>::Forward(inputTemp, weight, outputTemp, inSize,
+          strideWidth, strideHeight, dilationWidth, dilationHeight);
+    }
+
+    for (size_t outMap = 0; outMap < outSize * batchSize; ++outMap)
+      outputTemp.slice(outMap) += bias(outMap % outSize);
+
+    outputWidth = outputTemp.n_rows;
+    outputHeight = outputTemp.n_cols;
+    return;
+  }
+
   outputTemp.zeros();
 
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
@@ -273,6 +297,34 @@ void AtrousConvolution<
       inSize * batchSize, false, false);
   gTemp.zeros();
 
+  if (IsIm2ColConvolution<BackwardConvolutionRule>::value)
+  {
+    if (padding.PadWLeft() != 0 || padding.PadWRight() != 0 ||
+        padding.PadHTop() != 0 || padding.PadHBottom() != 0)
+    {
+      // Compute the gradient with respect to the padded input and crop it.
+      arma::Cube<eT> gPadded(inputWidth + padding.PadWLeft() +
+          padding.PadWRight(), inputHeight + padding.PadHTop() +
+          padding.PadHBottom(), gTemp.n_slices, arma::fill::zeros);
+      Im2ColConvolution<>::Backward(mappedError, weight, gPadded, inSize,
+          strideWidth, strideHeight, dilationWidth, dilationHeight);
+
+      for (size_t i = 0; i < gTemp.n_slices; ++i)
+      {
+        gTemp.slice(i) = gPadded.slice(i).submat(padding.PadWLeft(),
+            padding.PadHTop(), padding.PadWLeft() + gTemp.n_rows - 1,
+            padding.PadHTop() + gTemp.n_cols - 1);
+      }
+    }
+    else
+    {
+      Im2ColConvolution<>::Backward(mappedError, weight, gTemp, inSize,
+          strideWidth, strideHeight, dilationWidth, dilationHeight);
+    }
+
+    return;
+  }
+
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
@@ -336,6 +388,32 @@ void AtrousConvolution<
       weight.n_cols, weight.n_slices, false, false);
   gradientTemp.zeros();
 
+  if (IsIm2ColConvolution<GradientConvolutionRule>::value)
+  {
+    if (padding.PadWLeft() != 0 || padding.PadWRight() != 0 ||
+        padding.PadHTop() != 0 || padding.PadHBottom() != 0)
+    {
+      Im2ColConvolution<>::Gradient(inputPaddedTemp, mappedError,
+          gradientTemp, inSize, strideWidth, strideHeight, dilationWidth,
+          dilationHeight);
+    }
+    else
+    {
+      Im2ColConvolution<>::Gradient(inputTemp, mappedError, gradientTemp,
+          inSize, strideWidth, strideHeight, dilationWidth, dilationHeight);
+    }
+
+    // The gradient of the bias is the sum of the errors of the output map.
+    gradient.rows(weight.n_elem, gradient.n_rows - 1).zeros();
+    for (size_t outMap = 0; outMap < outSize * batchSize; ++outMap)
+    {
+      gradient(weight.n_elem + (outMap % outSize)) +=
+          arma::accu(mappedError.slice(outMap));
+    }
+
+    return;
+  }
+
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
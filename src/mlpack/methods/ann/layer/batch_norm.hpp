@@ -148,6 +148,13 @@ class BatchNorm
   //! Modify the variance over the training data.
   OutputDataType& TrainingVariance() { return runningVariance; }
 
+  //! Get the number of batches the training mean and variance were computed
+  //! from.
+  size_t Count() const { return count; }
+  //! Modify the number of batches the training mean and variance were computed
+  //! from.
+  size_t& Count() { return count; }
+
   //! Get the number of input units / channels.
   size_t InputSize() const { return size; }
 
@@ -170,6 +177,9 @@ class BatchNorm
   void serialize(Archive& ar, const uint32_t /* version */);
 
  private:
+  //! Element type of the output.
+  typedef typename OutputDataType::elem_type ElemType;
+
   //! Locally-stored number of input units.
   size_t size;
 
@@ -230,10 +240,10 @@ class BatchNorm
   OutputDataType outputParameter;
 
   //! Locally-stored normalized input.
-  arma::cube normalized;
+  arma::Cube<ElemType> normalized;
 
   //! Locally-stored zero mean input.
-  arma::cube inputMean;
+  arma::Cube<ElemType> inputMean;
 }; // class BatchNorm
 
 } // namespace ann
@@ -128,7 +128,7 @@ class CELU
   OutputDataType outputParameter;
 
   //! Locally stored first derivative of the activation function.
-  arma::mat derivative;
+  OutputDataType derivative;
 
   //! CELU Hyperparameter (alpha > 0).
   double alpha;
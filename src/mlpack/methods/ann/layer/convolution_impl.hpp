@@ -152,9 +152,9 @@ void Convolution<
     OutputDataType
 >::Reset()
 {
-    weight = arma::cube(weights.memptr(), kernelWidth, kernelHeight,
+    weight = arma::Cube<ElemType>(weights.memptr(), kernelWidth, kernelHeight,
         outSize * inSize, false, false);
-    bias = arma::mat(weights.memptr() + weight.n_elem,
+    bias = OutputDataType(weights.memptr() + weight.n_elem,
         outSize, 1, false, false);
 }
 
@@ -175,7 +175,7 @@ void Convolution<
 >::Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
 {
   batchSize = input.n_cols;
-  arma::cube inputTemp(const_cast<arma::Mat<eT>&>(input).memptr(),
+  arma::Cube<eT> inputTemp(const_cast<arma::Mat<eT>&>(input).memptr(),
                        inputWidth, inputHeight, inSize * batchSize,
                        false, false);
 
@@ -199,6 +199,21 @@ void Convolution<
   output.set_size(wConv * hConv * outSize, batchSize);
   outputTemp = arma::Cube<eT>(output.memptr(), wConv, hConv,
                               outSize * batchSize, false, false);
+
+  if (IsIm2ColConvolution<ForwardConvolutionRule>::value)
+  {
+    // Convolve the whole batch with all filters in one matrix product.
+    Im2ColConvolution<>::Forward(inputTemp, weight, outputTemp, inSize,
+        strideWidth, strideHeight);
+
+    for (size_t outMap = 0; outMap < outSize * batchSize; ++outMap)
+      outputTemp.slice(outMap) += bias(outMap % outSize);
+
+    outputWidth = outputTemp.n_rows;
+    outputHeight = outputTemp.n_cols;
+    return;
+  }
+
   outputTemp.zeros();
   // call slice first to cache slices, prevents data races
   for (omp_size_t outMapIdx = 0; outMapIdx < outSize; outMapIdx++) {
@@ -243,25 +258,52 @@ void Convolution<
 >::Backward(
     const arma::Mat<eT>& input, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
 {
-  arma::cube mappedError(((arma::Mat<eT>&) gy).memptr(), outputWidth,
+  arma::Cube<eT> mappedError(((arma::Mat<eT>&) gy).memptr(), outputWidth,
       outputHeight, outSize * batchSize, false, false);
-  arma::cube inputTemp(((arma::Mat<eT>&) input).memptr(), inputWidth,
+  arma::Cube<eT> inputTemp(((arma::Mat<eT>&) input).memptr(), inputWidth,
       inputHeight, inSize * batchSize, false, false);
 
   g.set_size(inputTemp.n_rows * inputTemp.n_cols * inSize, batchSize);
   gTemp = arma::Cube<eT>(g.memptr(), inputTemp.n_rows, inputTemp.n_cols,
                          inputTemp.n_slices, false, false);
   gTemp.zeros();
+
+  if (IsIm2ColConvolution<BackwardConvolutionRule>::value)
+  {
+    if (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0)
+    {
+      // Compute the gradient with respect to the padded input and crop it.
+      arma::Cube<eT> gPadded(inputTemp.n_rows + padWLeft + padWRight,
+          inputTemp.n_cols + padHTop + padHBottom, inputTemp.n_slices,
+          arma::fill::zeros);
+      Im2ColConvolution<>::Backward(mappedError, weight, gPadded, inSize,
+          strideWidth, strideHeight);
+
+      for (size_t i = 0; i < gTemp.n_slices; ++i)
+      {
+        gTemp.slice(i) = gPadded.slice(i).submat(padWLeft, padHTop,
+            padWLeft + gTemp.n_rows - 1, padHTop + gTemp.n_cols - 1);
+      }
+    }
+    else
+    {
+      Im2ColConvolution<>::Backward(mappedError, weight, gTemp, inSize,
+          strideWidth, strideHeight);
+    }
+
+    return;
+  }
+
   for (size_t outMapIdx = 0; outMapIdx < outSize; outMapIdx++)
   {
     for (size_t inMap = 0; inMap < inSize; inMap++)
     {
       arma::Mat<eT> rotatedFilter;
-      Rotate180(weight.slice(outMapIdx+inMap), rotatedFilter);
+      Rotate180(weight.slice(outMapIdx * inSize + inMap), rotatedFilter);
       #pragma omp parallel for
       for (omp_size_t batchCount = 0; batchCount < batchSize; batchCount++) {
-        arma::Mat<double> &errSlice = mappedError.slice(outMapIdx +
-                                                        batchCount*outSize);
+        arma::Mat<eT>& errSlice = mappedError.slice(outMapIdx +
+            batchCount * outSize);
 
         if (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0)
         {
@@ -305,13 +347,13 @@ void Convolution<
     const arma::Mat<eT>& error,
     arma::Mat<eT>& gradient)
 {
-  arma::cube mappedError(((arma::Mat<eT>&) error).memptr(), outputWidth,
+  arma::Cube<eT> mappedError(((arma::Mat<eT>&) error).memptr(), outputWidth,
       outputHeight, outSize * batchSize, false, false);
-  arma::cube inputTemp;
+  arma::Cube<eT> inputTemp;
   if (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0) {
     inputTemp = inputPaddedTemp;
   } else {
-    inputTemp = arma::cube(((arma::Mat<eT>&) input).memptr(), inputWidth,
+    inputTemp = arma::Cube<eT>(((arma::Mat<eT>&) input).memptr(), inputWidth,
                            inputHeight, inSize * batchSize, false, false);
   }
 
@@ -319,12 +361,32 @@ void Convolution<
   gradientTemp = arma::Cube<eT>(gradient.memptr(), weight.n_rows,
       weight.n_cols, weight.n_slices, false, false);
   gradientTemp.zeros();
+
+  // The gradient of the bias is the sum of the errors of the output map over
+  // the batch.
+  gradient.rows(weight.n_elem, gradient.n_rows - 1).zeros();
+
+  if (IsIm2ColConvolution<GradientConvolutionRule>::value)
+  {
+    Im2ColConvolution<>::Gradient(inputTemp, mappedError, gradientTemp,
+        inSize, strideWidth, strideHeight);
+
+    for (size_t outMap = 0; outMap < outSize * batchSize; ++outMap)
+    {
+      gradient(weight.n_elem + (outMap % outSize)) +=
+          arma::accu(mappedError.slice(outMap));
+    }
+
+    return;
+  }
+
   #pragma omp parallel for
   for (omp_size_t outMapIdx = 0; outMapIdx < outSize; outMapIdx++)
   {
     for (size_t inMap = 0; inMap < inSize; inMap++)
     {
-      arma::Mat<eT>& curGradTemp = gradientTemp.slice(outMapIdx+inMap);
+      arma::Mat<eT>& curGradTemp = gradientTemp.slice(outMapIdx * inSize +
+          inMap);
       for (size_t batchCount = 0; batchCount < batchSize; batchCount++) {
         size_t outMap = outMapIdx + batchCount*outSize;
         arma::Mat<eT>& inputSlice = inputTemp.slice(inMap+(batchCount*inSize));
@@ -348,9 +410,8 @@ void Convolution<
          curGradTemp += output;
         }
         if (inMap == inSize-1) {
-          gradient.submat(weight.n_elem+(outMap%outSize), 0,
-                          weight.n_elem+(outMap%outSize),
-                          0) = arma::accu(mappedError.slice(outMap));
+          gradient(weight.n_elem + outMapIdx) +=
+              arma::accu(mappedError.slice(outMap));
         }
       }
     }
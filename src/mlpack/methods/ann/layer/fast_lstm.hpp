@@ -133,6 +133,16 @@ class FastLSTM
    */
   void ResetCell(const size_t size);
 
+  /*
+   * Continue the forward pass at the given time step, which has to be the
+   * first step of a segment of CheckpointInterval() steps.  The output and the
+   * cell state of the step before the segment are restored, so that the steps
+   * of the segment can be computed again.
+   *
+   * @param step The time step that the next call to Forward() computes.
+   */
+  void Rewind(const size_t step);
+
   /*
    * Calculate the gradient using the output delta and the input activation.
    *
@@ -150,6 +160,12 @@ class FastLSTM
   //! Modify the maximum number of steps to backpropagate through time (BPTT).
   size_t& Rho() { return rho; }
 
+  //! Get the number of time steps whose state is held at once (0 holds the
+  //! state of every step).  It takes effect at the next call to ResetCell().
+  size_t CheckpointInterval() const { return checkpointInterval; }
+  //! Modify the number of time steps whose state is held at once.
+  size_t& CheckpointInterval() { return checkpointInterval; }
+
   //! Get the parameters.
   OutputDataType const& Parameters() const { return weights; }
   //! Modify the parameters.
@@ -305,7 +321,8 @@ class FastLSTM
   //! Locally-stored state activation.
   OutputDataType stateActivation;
 
-  //! Locally-stored cell parameter.
+  //! Locally-stored cell states, the first block holds the state of the step
+  //! before the held steps.
   OutputDataType cell;
 
   //! Locally-stored cell activation error.
@@ -317,7 +334,8 @@ class FastLSTM
   //! Locally-stored previous error.
   OutputDataType prevError;
 
-  //! Locally-stored output parameters.
+  //! Locally-stored outputs, the first block holds the output of the step
+  //! before the held steps.
   OutputDataType outParameter;
 
   //! Locally-stored current rho size.
@@ -325,6 +343,22 @@ class FastLSTM
 
   //! Current backpropagate through time steps.
   size_t bpttSteps;
+
+  //! Locally-stored number of time steps whose state is held at once.
+  size_t checkpointInterval;
+
+  //! Locally-stored number of time steps whose state is held.
+  size_t heldSteps;
+
+  //! Locally-stored number of forward steps since the start of the sequence.
+  size_t forwardStepIdx;
+
+  //! Locally-stored outputs of the steps before each segment of held steps.
+  OutputDataType checkpointOutput;
+
+  //! Locally-stored cell states of the steps before each segment of held
+  //! steps.
+  OutputDataType checkpointCell;
 }; // class FastLSTM
 
 } // namespace ann
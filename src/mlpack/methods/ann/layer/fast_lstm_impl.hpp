@@ -20,7 +20,10 @@ namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
 template<typename InputDataType, typename OutputDataType>
-FastLSTM<InputDataType, OutputDataType>::FastLSTM()
+FastLSTM<InputDataType, OutputDataType>::FastLSTM() :
+    checkpointInterval(0),
+    heldSteps(0),
+    forwardStepIdx(0)
 {
   // Nothing to do here.
 }
@@ -38,7 +41,10 @@ FastLSTM<InputDataType, OutputDataType>::FastLSTM(
     batchStep(0),
     gradientStepIdx(0),
     rhoSize(rho),
-    bpttSteps(0)
+    bpttSteps(0),
+    checkpointInterval(0),
+    heldSteps(0),
+    forwardStepIdx(0)
 {
   // Weights for: input to gate layer (4 * outsize * inSize + 4 * outsize)
   // and output to gate (4 * outSize).
@@ -59,7 +65,10 @@ FastLSTM<InputDataType, OutputDataType>::FastLSTM(const FastLSTM& layer) :
     gradientStepIdx(layer.gradientStepIdx),
     grad(layer.grad),
     rhoSize(layer.rho),
-    bpttSteps(layer.bpttSteps)
+    bpttSteps(layer.bpttSteps),
+    checkpointInterval(layer.checkpointInterval),
+    heldSteps(layer.heldSteps),
+    forwardStepIdx(layer.forwardStepIdx)
 {
   // Nothing to do here.
 }
@@ -78,7 +87,10 @@ FastLSTM<InputDataType, OutputDataType>::FastLSTM(FastLSTM&& layer) :
     gradientStepIdx(std::move(layer.gradientStepIdx)),
     grad(std::move(layer.grad)),
     rhoSize(std::move(layer.rho)),
-    bpttSteps(std::move(layer.bpttSteps))
+    bpttSteps(std::move(layer.bpttSteps)),
+    checkpointInterval(std::move(layer.checkpointInterval)),
+    heldSteps(std::move(layer.heldSteps)),
+    forwardStepIdx(std::move(layer.forwardStepIdx))
 {
   // Nothing to do here.
 }
@@ -102,6 +114,9 @@ FastLSTM<InputDataType, OutputDataType>::operator=(const FastLSTM& layer)
     grad = layer.grad;
     rhoSize = layer.rho;
     bpttSteps = layer.bpttSteps;
+    checkpointInterval = layer.checkpointInterval;
+    heldSteps = layer.heldSteps;
+    forwardStepIdx = layer.forwardStepIdx;
   }
   return *this;
 }
@@ -125,6 +140,9 @@ FastLSTM<InputDataType, OutputDataType>::operator=(FastLSTM&& layer)
     grad = std::move(layer.grad);
     rhoSize = std::move(layer.rho);
     bpttSteps = std::move(layer.bpttSteps);
+    checkpointInterval = std::move(layer.checkpointInterval);
+    heldSteps = std::move(layer.heldSteps);
+    forwardStepIdx = std::move(layer.forwardStepIdx);
   }
   return *this;
 }
@@ -157,12 +175,21 @@ void FastLSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
     return;
 
   bpttSteps = std::min(rho, rhoSize);
+
+  // With a checkpoint interval only the state of one segment of steps is held,
+  // along with the output and the cell state before every segment.
+  heldSteps = (checkpointInterval > 0) ?
+      std::min(checkpointInterval, bpttSteps) : size;
+  const size_t segments = (bpttSteps + heldSteps - 1) /
+      std::max(heldSteps, size_t(1));
+
   forwardStep = 0;
+  forwardStepIdx = 0;
   gradientStepIdx = 0;
-  backwardStep = batchSize * size - 1;
-  gradientStep = batchSize * size - 1;
+  backwardStep = batchSize * heldSteps - 1;
+  gradientStep = batchSize * heldSteps - 1;
 
-  const size_t rhoBatchSize = size * batchSize;
+  const size_t rhoBatchSize = heldSteps * batchSize;
 
   // Make sure all of the matrices we use to store state are at least as large
   // as we need.
@@ -174,9 +201,28 @@ void FastLSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
 
   // Reset stored state to zeros.
   prevOutput.zeros(outSize, batchSize);
-  cell.zeros(outSize, size * batchSize);
+  cell.zeros(outSize, rhoBatchSize + batchSize);
   cellActivationError.zeros(outSize, batchSize);
-  outParameter.zeros(outSize, (size + 1) * batchSize);
+  outParameter.zeros(outSize, rhoBatchSize + batchSize);
+  checkpointCell.zeros(outSize, segments * batchSize);
+  checkpointOutput.zeros(outSize, segments * batchSize);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void FastLSTM<InputDataType, OutputDataType>::Rewind(const size_t step)
+{
+  if (batchSize == 0 || bpttSteps == 0 || heldSteps == 0)
+    return;
+
+  // Continue from the output and the cell state before the segment.
+  const size_t checkpoint = (step / heldSteps) * batchSize;
+  outParameter.cols(0, batchStep) = checkpointOutput.cols(checkpoint,
+      checkpoint + batchStep);
+  cell.cols(0, batchStep) = checkpointCell.cols(checkpoint,
+      checkpoint + batchStep);
+
+  forwardStep = 0;
+  forwardStepIdx = step;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -193,6 +239,29 @@ void FastLSTM<InputDataType, OutputDataType>::Forward(
     ResetCell(rhoSize);
   }
 
+  if (forwardStepIdx == bpttSteps)
+  {
+    // Start a new sequence.
+    forwardStep = 0;
+    forwardStepIdx = 0;
+    outParameter.cols(0, batchStep).zeros();
+    cell.cols(0, batchStep).zeros();
+  }
+  else if (checkpointInterval > 0 && forwardStep == heldSteps * batchSize)
+  {
+    // Start a new segment from the last held step, and keep its output and
+    // cell state in case the segment is computed again.
+    const size_t checkpoint = (forwardStepIdx / heldSteps) * batchSize;
+    outParameter.cols(0, batchStep) = outParameter.cols(forwardStep,
+        forwardStep + batchStep);
+    cell.cols(0, batchStep) = cell.cols(forwardStep, forwardStep + batchStep);
+    checkpointOutput.cols(checkpoint, checkpoint + batchStep) =
+        outParameter.cols(0, batchStep);
+    checkpointCell.cols(checkpoint, checkpoint + batchStep) =
+        cell.cols(0, batchStep);
+    forwardStep = 0;
+  }
+
   gate.cols(forwardStep, forwardStep + batchStep) = input2GateWeight * input +
       output2GateWeight * outParameter.cols(
       forwardStep, forwardStep + batchStep);
@@ -211,26 +280,16 @@ void FastLSTM<InputDataType, OutputDataType>::Forward(
   // Update the cell: cmul1 + cmul2
   // where cmul1 is input gate * hidden state and
   // cmul2 is forget gate * cell (prevCell).
-  if (forwardStep == 0)
-  {
-    cell.cols(forwardStep, forwardStep + batchStep) =
-        gateActivation.submat(0, forwardStep, outSize - 1,
-        forwardStep + batchStep) %
-        stateActivation.cols(forwardStep, forwardStep + batchStep);
-  }
-  else
-  {
-    cell.cols(forwardStep, forwardStep + batchStep) =
-        gateActivation.submat(0, forwardStep, outSize - 1,
-        forwardStep + batchStep) %
-        stateActivation.cols(forwardStep, forwardStep + batchStep) +
-        gateActivation.submat(2 * outSize, forwardStep, 3 * outSize - 1,
-        forwardStep + batchStep) %
-        cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep);
-  }
+  cell.cols(forwardStep + batchSize, forwardStep + batchSize + batchStep) =
+      gateActivation.submat(0, forwardStep, outSize - 1,
+      forwardStep + batchStep) %
+      stateActivation.cols(forwardStep, forwardStep + batchStep) +
+      gateActivation.submat(2 * outSize, forwardStep, 3 * outSize - 1,
+      forwardStep + batchStep) %
+      cell.cols(forwardStep, forwardStep + batchStep);
 
-  cellActivation.cols(forwardStep, forwardStep + batchStep) =
-      arma::tanh(cell.cols(forwardStep, forwardStep + batchStep));
+  cellActivation.cols(forwardStep, forwardStep + batchStep) = arma::tanh(
+      cell.cols(forwardStep + batchSize, forwardStep + batchSize + batchStep));
 
   outParameter.cols(forwardStep + batchSize,
       forwardStep + batchSize + batchStep) = cellActivation.cols(
@@ -240,11 +299,12 @@ void FastLSTM<InputDataType, OutputDataType>::Forward(
   output = OutputType(outParameter.memptr() +
       (forwardStep + batchSize) * outSize, outSize, batchSize, false, false);
 
+  // The backward pass starts with the last computed step.
+  backwardStep = forwardStep + batchStep;
+  gradientStep = forwardStep + batchStep;
+
   forwardStep += batchSize;
-  if ((forwardStep / batchSize) == bpttSteps)
-  {
-    forwardStep = 0;
-  }
+  forwardStepIdx++;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -275,19 +335,12 @@ void FastLSTM<InputDataType, OutputDataType>::Backward(
       backwardStep - batchStep, 3 * outSize - 1, backwardStep) %
       cellActivationError;
 
-  if (backwardStep > batchStep)
-  {
-    prevError.submat(2 * outSize, 0, 3 * outSize - 1, batchStep) =
-        cell.cols((backwardStep - batchSize) - batchStep,
-        (backwardStep - batchSize)) % cellActivationError %
-        gateActivation.submat(2 * outSize, backwardStep - batchStep,
-        3 * outSize - 1, backwardStep) % (1.0 - gateActivation.submat(
-        2 * outSize, backwardStep - batchStep, 3 * outSize - 1, backwardStep));
-  }
-  else
-  {
-    prevError.submat(2 * outSize, 0, 3 * outSize - 1, batchStep).zeros();
-  }
+  prevError.submat(2 * outSize, 0, 3 * outSize - 1, batchStep) =
+      cell.cols(backwardStep - batchStep, backwardStep) %
+      cellActivationError % gateActivation.submat(2 * outSize,
+      backwardStep - batchStep, 3 * outSize - 1, backwardStep) %
+      (1.0 - gateActivation.submat(2 * outSize, backwardStep - batchStep,
+      3 * outSize - 1, backwardStep));
 
   prevError.submat(0, 0, outSize - 1, batchStep) =
       stateActivation.cols(backwardStep - batchStep,
@@ -344,7 +397,7 @@ void FastLSTM<InputDataType, OutputDataType>::Gradient(
   }
   else
   {
-    gradientStep = batchSize * bpttSteps - 1;
+    gradientStep = batchSize * heldSteps - 1;
   }
 }
 
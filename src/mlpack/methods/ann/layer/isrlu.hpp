@@ -122,7 +122,7 @@ class ISRLU
   OutputDataType outputParameter;
 
   //! Locally stored first derivative of the activation function.
-  arma::mat derivative;
+  OutputDataType derivative;
 
   //! ISRLU Hyperparameter (alpha > 0).
   double alpha;
@@ -60,6 +60,8 @@
 #include "parametric_relu.hpp"
 #include "pixel_shuffle.hpp"
 #include "positional_encoding.hpp"
+#include "quantized_convolution.hpp"
+#include "quantized_linear.hpp"
 #include "recurrent_attention.hpp"
 #include "recurrent.hpp"
 #include "reinforce_normal.hpp"
@@ -88,6 +88,10 @@ HAS_MEM_FUNC(Reset, HasResetCheck);
 // we can use with SFINAE to catch when a type has a ResetCell() function.
 HAS_MEM_FUNC(ResetCell, HasResetCellCheck);
 
+// This gives us a HasRewindCheck<T, U> type (where U is a function pointer) we
+// can use with SFINAE to catch when a type has a Rewind() function.
+HAS_MEM_FUNC(Rewind, HasRewindCheck);
+
 // This gives us a HasRewardCheck<T, U> type (where U is a function pointer) we
 // can use with SFINAE to catch when a type has a Reward() function.
 HAS_MEM_FUNC(Reward, HasRewardCheck);
@@ -120,6 +124,16 @@ HAS_MEM_FUNC(Bias, HasBiasCheck);
 // we can use with SFINAE to catch when a type has a MaxIterations() function.
 HAS_MEM_FUNC(MaxIterations, HasMaxIterations);
 
+// This gives us a HasRegularizeCheck<T, U> type (where U is a function
+// pointer) we can use with SFINAE to catch when a type has a Regularize()
+// function.
+HAS_MEM_FUNC(Regularize, HasRegularizeCheck);
+
+// This gives us a HasTrainingMeanCheck<T, U> type (where U is a function
+// pointer) we can use with SFINAE to catch when a type has a TrainingMean()
+// function.
+HAS_MEM_FUNC(TrainingMean, HasTrainingMeanCheck);
+
 // This gives us a HasInShapeCheck<T> type we can use with SFINAE to catch when
 // a type has a function named InputShape.
 HAS_ANY_METHOD_FORM(InputShape, HasInputShapeCheck);
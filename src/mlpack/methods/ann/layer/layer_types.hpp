@@ -102,6 +102,10 @@ template<typename InputDataType,
          typename OutputDataType>
 class NoisyLinear;
 
+template<typename InputDataType,
+         typename OutputDataType>
+class QuantizedLinear;
+
 template<typename InputDataType,
          typename OutputDataType,
          typename RegularizerType>
@@ -192,6 +196,12 @@ template<
 >
 class AtrousConvolution;
 
+template<
+    typename InputDataType,
+    typename OutputDataType
+>
+class QuantizedConvolution;
+
 template<
     typename InputDataType,
     typename OutputDataType
@@ -240,7 +250,9 @@ using MoreTypes = boost::variant<
         RBF<arma::mat, arma::mat, GaussianFunction>*,
         BaseLayer<GaussianFunction, arma::mat, arma::mat>*,
         PositionalEncoding<arma::mat, arma::mat>*,
-        ISRLU<arma::mat, arma::mat>*
+        ISRLU<arma::mat, arma::mat>*,
+        QuantizedLinear<arma::mat, arma::mat>*,
+        QuantizedConvolution<arma::mat, arma::mat>*
 >;
 
 template <typename... CustomLayers>
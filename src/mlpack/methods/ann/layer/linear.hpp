@@ -136,6 +136,11 @@ class Linear
   //! Modify the gradient.
   OutputDataType& Gradient() { return gradient; }
 
+  //! Get whether the regularizer is added to the gradient.
+  bool Regularize() const { return regularize; }
+  //! Modify whether the regularizer is added to the gradient.
+  bool& Regularize() { return regularize; }
+
   //! Get the weight of the layer.
   OutputDataType const& Weight() const { return weight; }
   //! Modify the weight of the layer.
@@ -194,6 +199,9 @@ class Linear
 
   //! Locally-stored regularizer object.
   RegularizerType regularizer;
+
+  //! If true, the regularizer is added to the gradient.
+  bool regularize;
 }; // class Linear
 
 } // namespace ann
@@ -138,6 +138,11 @@ class Linear3D
   //! Modify the gradient.
   OutputDataType& Gradient() { return gradient; }
 
+  //! Get whether the regularizer is added to the gradient.
+  bool Regularize() const { return regularize; }
+  //! Modify whether the regularizer is added to the gradient.
+  bool& Regularize() { return regularize; }
+
   //! Get the weight of the layer.
   OutputDataType const& Weight() const { return weight; }
   //! Modify the weight of the layer.
@@ -190,6 +195,9 @@ class Linear3D
 
   //! Locally-stored regularizer object.
   RegularizerType regularizer;
+
+  //! If true, the regularizer is added to the gradient.
+  bool regularize;
 }; // class Linear
 
 } // namespace ann
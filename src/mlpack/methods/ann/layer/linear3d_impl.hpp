@@ -22,7 +22,8 @@ template<typename InputDataType, typename OutputDataType,
     typename RegularizerType>
 Linear3D<InputDataType, OutputDataType, RegularizerType>::Linear3D() :
     inSize(0),
-    outSize(0)
+    outSize(0),
+    regularize(true)
 {
   // Nothing to do here.
 }
@@ -35,7 +36,8 @@ Linear3D<InputDataType, OutputDataType, RegularizerType>::Linear3D(
     RegularizerType regularizer) :
     inSize(inSize),
     outSize(outSize),
-    regularizer(regularizer)
+    regularizer(regularizer),
+    regularize(true)
 {
   weights.set_size(outSize * inSize + outSize, 1);
 }
@@ -47,7 +49,8 @@ Linear3D<InputDataType, OutputDataType, RegularizerType>::Linear3D(
     inSize(layer.inSize),
     outSize(layer.outSize),
     weights(layer.weights),
-    regularizer(layer.regularizer)
+    regularizer(layer.regularizer),
+    regularize(layer.regularize)
 {
   // Nothing to do here.
 }
@@ -59,7 +62,8 @@ Linear3D<InputDataType, OutputDataType, RegularizerType>::Linear3D(
     inSize(0),
     outSize(0),
     weights(std::move(layer.weights)),
-    regularizer(std::move(layer.regularizer))
+    regularizer(std::move(layer.regularizer)),
+    regularize(layer.regularize)
 {
   // Nothing to do here.
 }
@@ -76,6 +80,7 @@ operator=(const Linear3D& layer)
     outSize = layer.outSize;
     weights = layer.weights;
     regularizer = layer.regularizer;
+    regularize = layer.regularize;
   }
   return *this;
 }
@@ -92,6 +97,7 @@ operator=(Linear3D&& layer)
     outSize = 0;
     weights = std::move(layer.weights);
     regularizer = std::move(layer.regularizer);
+    regularize = layer.regularize;
   }
   return *this;
 }
@@ -210,7 +216,8 @@ void Linear3D<InputDataType, OutputDataType, RegularizerType>::Gradient(
   gradient.submat(weight.n_elem, 0, weights.n_elem - 1, 0)
       = arma::vectorise(arma::sum(arma::sum(errorTemp, 2), 1));
 
-  regularizer.Evaluate(weights, gradient);
+  if (regularize)
+    regularizer.Evaluate(weights, gradient);
 }
 
 template<typename InputDataType, typename OutputDataType,
@@ -23,7 +23,8 @@ template<typename InputDataType, typename OutputDataType,
     typename RegularizerType>
 Linear<InputDataType, OutputDataType, RegularizerType>::Linear() :
     inSize(0),
-    outSize(0)
+    outSize(0),
+    regularize(true)
 {
   // Nothing to do here.
 }
@@ -36,7 +37,8 @@ Linear<InputDataType, OutputDataType, RegularizerType>::Linear(
     RegularizerType regularizer) :
     inSize(inSize),
     outSize(outSize),
-    regularizer(regularizer)
+    regularizer(regularizer),
+    regularize(true)
 {
   weights.set_size(WeightSize(), 1);
 }
@@ -48,7 +50,8 @@ Linear<InputDataType, OutputDataType, RegularizerType>::Linear(
     inSize(layer.inSize),
     outSize(layer.outSize),
     weights(layer.weights),
-    regularizer(layer.regularizer)
+    regularizer(layer.regularizer),
+    regularize(layer.regularize)
 {
   // Nothing to do here.
 }
@@ -60,7 +63,8 @@ Linear<InputDataType, OutputDataType, RegularizerType>::Linear(
     inSize(0),
     outSize(0),
     weights(std::move(layer.weights)),
-    regularizer(std::move(layer.regularizer))
+    regularizer(std::move(layer.regularizer)),
+    regularize(layer.regularize)
 {
   // Nothing to do here.
 }
@@ -77,6 +81,7 @@ operator=(const Linear& layer)
     outSize = layer.outSize;
     weights = layer.weights;
     regularizer = layer.regularizer;
+    regularize = layer.regularize;
   }
   return *this;
 }
@@ -93,6 +98,7 @@ operator=(Linear&& layer)
     outSize = layer.outSize;
     weights = std::move(layer.weights);
     regularizer = std::move(layer.regularizer);
+    regularize = layer.regularize;
   }
   return *this;
 }
@@ -101,8 +107,8 @@ template<typename InputDataType, typename OutputDataType,
     typename RegularizerType>
 void Linear<InputDataType, OutputDataType, RegularizerType>::Reset()
 {
-  weight = arma::mat(weights.memptr(), outSize, inSize, false, false);
-  bias = arma::mat(weights.memptr() + weight.n_elem,
+  weight = OutputDataType(weights.memptr(), outSize, inSize, false, false);
+  bias = OutputDataType(weights.memptr() + weight.n_elem,
       outSize, 1, false, false);
 }
 
@@ -137,7 +143,8 @@ void Linear<InputDataType, OutputDataType, RegularizerType>::Gradient(
       error * input.t());
   gradient.submat(weight.n_elem, 0, gradient.n_elem - 1, 0) =
       arma::sum(error, 1);
-  regularizer.Evaluate(weights, gradient);
+  if (regularize)
+    regularizer.Evaluate(weights, gradient);
 }
 
 template<typename InputDataType, typename OutputDataType,
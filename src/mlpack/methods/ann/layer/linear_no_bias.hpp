@@ -123,6 +123,11 @@ class LinearNoBias
   //! Modify the gradient.
   OutputDataType& Gradient() { return gradient; }
 
+  //! Get whether the regularizer is added to the gradient.
+  bool Regularize() const { return regularize; }
+  //! Modify whether the regularizer is added to the gradient.
+  bool& Regularize() { return regularize; }
+
   //! Get the size of the weights.
   size_t WeightSize() const
   {
@@ -168,6 +173,9 @@ class LinearNoBias
 
   //! Locally-stored regularizer object.
   RegularizerType regularizer;
+
+  //! If true, the regularizer is added to the gradient.
+  bool regularize;
 }; // class LinearNoBias
 
 } // namespace ann
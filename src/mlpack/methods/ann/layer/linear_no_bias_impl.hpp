@@ -23,7 +23,8 @@ template<typename InputDataType, typename OutputDataType,
     typename RegularizerType>
 LinearNoBias<InputDataType, OutputDataType, RegularizerType>::LinearNoBias() :
     inSize(0),
-    outSize(0)
+    outSize(0),
+    regularize(true)
 {
   // Nothing to do here.
 }
@@ -36,7 +37,8 @@ LinearNoBias<InputDataType, OutputDataType, RegularizerType>::LinearNoBias(
     RegularizerType regularizer) :
     inSize(inSize),
     outSize(outSize),
-    regularizer(regularizer)
+    regularizer(regularizer),
+    regularize(true)
 {
   weights.set_size(WeightSize(), 1);
 }
@@ -45,7 +47,7 @@ template<typename InputDataType, typename OutputDataType,
     typename RegularizerType>
 void LinearNoBias<InputDataType, OutputDataType, RegularizerType>::Reset()
 {
-  weight = arma::mat(weights.memptr(), outSize, inSize, false, false);
+  weight = OutputDataType(weights.memptr(), outSize, inSize, false, false);
 }
 
 template<typename InputDataType, typename OutputDataType,
@@ -76,7 +78,8 @@ void LinearNoBias<InputDataType, OutputDataType, RegularizerType>::Gradient(
 {
   gradient.submat(0, 0, weight.n_elem - 1, 0) = arma::vectorise(
       error * input.t());
-  regularizer.Evaluate(weights, gradient);
+  if (regularize)
+    regularizer.Evaluate(weights, gradient);
 }
 
 template<typename InputDataType, typename OutputDataType,
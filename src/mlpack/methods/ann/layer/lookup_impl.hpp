@@ -44,8 +44,12 @@ void Lookup<InputDataType, OutputDataType>::Forward(
     // ith column of output is a vectorized form of a matrix of shape
     // (embeddingSize, seqLength) selected as a combination of columns from the
     // weights.
-    output.col(i) = arma::vectorise(weights.cols(
-        arma::conv_to<arma::uvec>::from(input.col(i)) - 1));
+    for (size_t j = 0; j < seqLength; ++j)
+    {
+      std::copy(weights.colptr((size_t) input(j, i) - 1),
+          weights.colptr((size_t) input(j, i) - 1) + embeddingSize,
+          output.colptr(i) + j * embeddingSize);
+    }
   }
 }
 
@@ -69,16 +73,18 @@ void Lookup<InputDataType, OutputDataType>::Gradient(
   const size_t seqLength = input.n_rows;
   const size_t batchSize = input.n_cols;
 
-  arma::Cube<eT> errorTemp(const_cast<arma::Mat<eT>&>(error).memptr(),
-      embeddingSize, seqLength, batchSize, false, false);
-
-  gradient.set_size(arma::size(weights));
-  gradient.zeros();
-
+  gradient.zeros(embeddingSize, vocabSize);
   for (size_t i = 0; i < batchSize; ++i)
   {
-    gradient.cols(arma::conv_to<arma::uvec>::from(input.col(i)) - 1)
-        += errorTemp.slice(i);
+    for (size_t j = 0; j < seqLength; ++j)
+    {
+      // The Lookup layer uses token - 1 for the columns.
+      const size_t token = (size_t) input(j, i) - 1;
+      eT* column = gradient.colptr(token);
+      const eT* columnError = error.colptr(i) + j * embeddingSize;
+      for (size_t k = 0; k < embeddingSize; ++k)
+        column[k] += columnError[k];
+    }
   }
 }
 
@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_ANN_LAYER_LP_POOLING_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/util/pooling_kernels.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -152,30 +153,8 @@ class LpPooling
   void serialize(Archive& ar, const uint32_t /* version */);
 
  private:
-  /**
-   * Apply pooling to the input and store the results.
-   *
-   * @param input The input to be apply the pooling rule.
-   * @param output The pooled result.
-   */
-  template<typename eT>
-  void Pooling(const arma::Mat<eT>& input, arma::Mat<eT>& output)
-  {
-    for (size_t j = 0, colidx = 0; j < output.n_cols;
-         ++j, colidx += strideHeight)
-    {
-      for (size_t i = 0, rowidx = 0; i < output.n_rows;
-           ++i, rowidx += strideWidth)
-      {
-        arma::mat subInput = input(
-            arma::span(rowidx, rowidx + kernelWidth - 1 - offset),
-            arma::span(colidx, colidx + kernelHeight - 1 - offset));
-
-        output(i, j) = pow(arma::accu(arma::pow(subInput,
-            normType)), 1.0 / normType);
-      }
-    }
-  }
+  //! Element type of the output.
+  typedef typename OutputDataType::elem_type ElemType;
 
   /**
    * Apply unpooling to the input and store the results.
@@ -256,13 +235,13 @@ class LpPooling
   size_t batchSize;
 
   //! Locally-stored output parameter.
-  arma::cube outputTemp;
+  arma::Cube<ElemType> outputTemp;
 
   //! Locally-stored transformed input parameter.
-  arma::cube inputTemp;
+  arma::Cube<ElemType> inputTemp;
 
   //! Locally-stored transformed output parameter.
-  arma::cube gTemp;
+  arma::Cube<ElemType> gTemp;
 
   //! Locally-stored delta object.
   OutputDataType delta;
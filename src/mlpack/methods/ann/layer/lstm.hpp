@@ -31,6 +31,13 @@ namespace ann /** Artificial Neural Network. */ {
  * h &=& o \odot tanh(c)
  * @f}
  *
+ * The weights of the four gates (i, f, z and o, in that order) are stacked, so
+ * every step computes the input and output contributions to all gates with one
+ * matrix multiplication each, and then applies the peephole connections and
+ * activations and updates the cell in a single pass over the units.  The layer
+ * parameters hold the stacked input weights, the stacked biases, the stacked
+ * output weights and the cell weights of the i, f and o gates.
+ *
  * Note that if an LSTM layer is desired as the first layer of a neural network,
  * an IdentityLayer should be added to the network as the first layer, and then
  * the LSTM layer should be added.
@@ -47,8 +54,8 @@ namespace ann /** Artificial Neural Network. */ {
  * }
  * @endcode
  *
- * \see FastLSTM for a faster LSTM version which combines the calculation of the
- * input, forget, output gates and hidden state in a single step.
+ * \see FastLSTM for a faster LSTM version without the peephole connections,
+ * which uses an approximation of the sigmoid function.
  *
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
@@ -140,6 +147,16 @@ class LSTM
    */
   void ResetCell(const size_t size);
 
+  /*
+   * Continue the forward pass at the given time step, which has to be the
+   * first step of a segment of CheckpointInterval() steps.  The output and the
+   * cell state of the step before the segment are restored, so that the steps
+   * of the segment can be computed again.
+   *
+   * @param step The time step that the next call to Forward() computes.
+   */
+  void Rewind(const size_t step);
+
   /*
    * Calculate the gradient using the output delta and the input activation.
    *
@@ -157,6 +174,12 @@ class LSTM
   //! Modify the maximum number of steps to backpropagate through time (BPTT).
   size_t& Rho() { return rho; }
 
+  //! Get the number of time steps whose state is held at once (0 holds the
+  //! state of every step).  It takes effect at the next call to ResetCell().
+  size_t CheckpointInterval() const { return checkpointInterval; }
+  //! Modify the number of time steps whose state is held at once.
+  size_t& CheckpointInterval() { return checkpointInterval; }
+
   //! Get the parameters.
   OutputDataType const& Parameters() const { return weights; }
   //! Modify the parameters.
@@ -196,7 +219,7 @@ class LSTM
    * Serialize the layer
    */
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */);
+  void serialize(Archive& ar, const uint32_t version);
 
  private:
   //! Locally-stored number of input units.
@@ -245,53 +268,28 @@ class LSTM
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
 
-  //! Weights between the output and input gate.
-  OutputDataType output2GateInputWeight;
+  //! Weights between the input and the gates (input gate, forget gate, hidden
+  //! layer and output gate, stacked).
+  OutputDataType input2GateWeight;
 
-  //! Weights between the input and gate.
-  OutputDataType input2GateInputWeight;
+  //! Bias between the input and the gates.
+  OutputDataType input2GateBias;
 
-  //! Bias between the input and input gate.
-  OutputDataType input2GateInputBias;
+  //! Weights between the output and the gates.
+  OutputDataType output2GateWeight;
 
   //! Weights between the cell and input gate.
   OutputDataType cell2GateInputWeight;
 
-  //! Weights between the output and forget gate.
-  OutputDataType output2GateForgetWeight;
-
-  //! Weights between the input and gate.
-  OutputDataType input2GateForgetWeight;
-
-  //! Bias between the input and gate.
-  OutputDataType input2GateForgetBias;
-
-  //! Bias between the input and gate.
+  //! Weights between the cell and forget gate.
   OutputDataType cell2GateForgetWeight;
 
-  //! Weights between the output and gate.
-  OutputDataType output2GateOutputWeight;
-
-  //! Weights between the input and gate.
-  OutputDataType input2GateOutputWeight;
-
-  //! Bias between the input and gate.
-  OutputDataType input2GateOutputBias;
-
   //! Weights between cell and output gate.
   OutputDataType cell2GateOutputWeight;
 
-  //! Locally-stored input gate parameter.
-  OutputDataType inputGate;
-
-  //! Locally-stored forget gate parameter.
-  OutputDataType forgetGate;
-
-  //! Locally-stored hidden layer parameter.
-  OutputDataType hiddenLayer;
-
-  //! Locally-stored output gate parameter.
-  OutputDataType outputGate;
+  //! Locally-stored input and output contributions to the gates of the current
+  //! step.
+  OutputDataType gates;
 
   //! Locally-stored input gate activation.
   OutputDataType inputGateActivation;
@@ -305,52 +303,59 @@ class LSTM
   //! Locally-stored hidden layer activation.
   OutputDataType hiddenLayerActivation;
 
-  //! Locally-stored input to hidden weight.
-  OutputDataType input2HiddenWeight;
-
-  //! Locally-stored input to hidden bias.
-  OutputDataType input2HiddenBias;
-
-  //! Locally-stored output to hidden weight.
-  OutputDataType output2HiddenWeight;
-
-  //! Locally-stored cell parameter.
+  //! Locally-stored cell states, the first block holds the state of the step
+  //! before the held steps.
   OutputDataType cell;
 
   //! Locally-stored cell activation error.
   OutputDataType cellActivation;
 
-  //! Locally-stored forget gate error.
-  OutputDataType forgetGateError;
-
-  //! Locally-stored output gate error.
-  OutputDataType outputGateError;
+  //! Locally-stored error of the gates (input gate, forget gate, hidden layer
+  //! and output gate, stacked).
+  OutputDataType gateError;
 
   //! Locally-stored previous error.
   OutputDataType prevError;
 
-  //! Locally-stored output parameters.
+  //! Locally-stored outputs, the first block holds the output of the step
+  //! before the held steps.
   OutputDataType outParameter;
 
   //! Locally-stored input cell error parameter.
   OutputDataType inputCellError;
 
-  //! Locally-stored input gate error.
-  OutputDataType inputGateError;
-
-  //! Locally-stored hidden layer error.
-  OutputDataType hiddenError;
-
   //! Locally-stored current rho size.
   size_t rhoSize;
 
   //! Current backpropagate through time steps.
   size_t bpttSteps;
+
+  //! Locally-stored number of time steps whose state is held at once.
+  size_t checkpointInterval;
+
+  //! Locally-stored number of time steps whose state is held.
+  size_t heldSteps;
+
+  //! Locally-stored number of forward steps since the start of the sequence.
+  size_t forwardStepIdx;
+
+  //! Locally-stored outputs of the steps before each segment of held steps.
+  OutputDataType checkpointOutput;
+
+  //! Locally-stored cell states of the steps before each segment of held
+  //! steps.
+  OutputDataType checkpointCell;
 }; // class LSTM
 
 } // namespace ann
 } // namespace mlpack
 
+//! Set the serialization version of the LSTM class.  Version 1 stores the
+//! gate weights stacked.
+CEREAL_TEMPLATE_CLASS_VERSION((template<typename InputDataType,
+    typename OutputDataType>), (mlpack::ann::LSTM<InputDataType,
+    OutputDataType>), (1));
+
 // Include implementation.
 #include "lstm_impl.hpp"
 
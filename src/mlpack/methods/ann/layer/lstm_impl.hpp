@@ -19,7 +19,10 @@ namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
 template<typename InputDataType, typename OutputDataType>
-LSTM<InputDataType, OutputDataType>::LSTM()
+LSTM<InputDataType, OutputDataType>::LSTM() :
+    checkpointInterval(0),
+    heldSteps(0),
+    forwardStepIdx(0)
 {
   // Nothing to do here.
 }
@@ -38,7 +41,10 @@ LSTM<InputDataType, OutputDataType>::LSTM(
     batchStep(layer.batchStep),
     gradientStepIdx(layer.gradientStepIdx),
     rhoSize(layer.rho),
-    bpttSteps(layer.bpttSteps)
+    bpttSteps(layer.bpttSteps),
+    checkpointInterval(layer.checkpointInterval),
+    heldSteps(layer.heldSteps),
+    forwardStepIdx(layer.forwardStepIdx)
 {
   // Nothing to do here.
 }
@@ -57,7 +63,10 @@ LSTM<InputDataType, OutputDataType>::LSTM(
     batchStep(std::move(layer.batchStep)),
     gradientStepIdx(std::move(layer.gradientStepIdx)),
     rhoSize(std::move(layer.rho)),
-    bpttSteps(std::move(layer.bpttSteps))
+    bpttSteps(std::move(layer.bpttSteps)),
+    checkpointInterval(std::move(layer.checkpointInterval)),
+    heldSteps(std::move(layer.heldSteps)),
+    forwardStepIdx(std::move(layer.forwardStepIdx))
 {
   // Nothing to do here.
 }
@@ -81,6 +90,9 @@ LSTM<InputDataType, OutputDataType> :: operator=(const LSTM& layer)
     grad = layer.grad;
     rhoSize = layer.rho;
     bpttSteps = layer.bpttSteps;
+    checkpointInterval = layer.checkpointInterval;
+    heldSteps = layer.heldSteps;
+    forwardStepIdx = layer.forwardStepIdx;
   }
   return *this; 
 }
@@ -104,6 +116,9 @@ LSTM<InputDataType, OutputDataType> :: operator=(LSTM&& layer)
     grad = std::move(layer.grad);
     rhoSize = std::move(layer.rho);
     bpttSteps = std::move(layer.bpttSteps);
+    checkpointInterval = std::move(layer.checkpointInterval);
+    heldSteps = std::move(layer.heldSteps);
+    forwardStepIdx = std::move(layer.forwardStepIdx);
   }
   return *this; 
 }
@@ -121,7 +136,10 @@ LSTM<InputDataType, OutputDataType>::LSTM(
     batchStep(0),
     gradientStepIdx(0),
     rhoSize(rho),
-    bpttSteps(0)
+    bpttSteps(0),
+    checkpointInterval(0),
+    heldSteps(0),
+    forwardStepIdx(0)
 {
   weights.set_size(WeightSize(), 1);
 }
@@ -138,20 +156,24 @@ void LSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
     return;
 
   bpttSteps = std::min(rho, rhoSize);
+
+  // With a checkpoint interval only the state of one segment of steps is held,
+  // along with the output and the cell state before every segment.
+  heldSteps = (checkpointInterval > 0) ?
+      std::min(checkpointInterval, bpttSteps) : size;
+  const size_t segments = (bpttSteps + heldSteps - 1) /
+      std::max(heldSteps, size_t(1));
+
   forwardStep = 0;
+  forwardStepIdx = 0;
   gradientStepIdx = 0;
-  backwardStep = batchSize * size - 1;
-  gradientStep = batchSize * size - 1;
+  backwardStep = batchSize * heldSteps - 1;
+  gradientStep = batchSize * heldSteps - 1;
 
-  const size_t rhoBatchSize = size * batchSize;
+  const size_t rhoBatchSize = heldSteps * batchSize;
 
   // Make sure all of the different matrices we will use to hold parameters are
   // at least as large as we need.
-  inputGate.set_size(outSize, rhoBatchSize);
-  forgetGate.set_size(outSize, rhoBatchSize);
-  hiddenLayer.set_size(outSize, rhoBatchSize);
-  outputGate.set_size(outSize, rhoBatchSize);
-
   inputGateActivation.set_size(outSize, rhoBatchSize);
   forgetGateActivation.set_size(outSize, rhoBatchSize);
   outputGateActivation.set_size(outSize, rhoBatchSize);
@@ -161,74 +183,58 @@ void LSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
   prevError.set_size(4 * outSize, batchSize);
 
   // Now reset recurrent values to 0.
-  cell.zeros(outSize, size * batchSize);
-  outParameter.zeros(outSize, (size + 1) * batchSize);
+  cell.zeros(outSize, rhoBatchSize + batchSize);
+  outParameter.zeros(outSize, rhoBatchSize + batchSize);
+  checkpointCell.zeros(outSize, segments * batchSize);
+  checkpointOutput.zeros(outSize, segments * batchSize);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void LSTM<InputDataType, OutputDataType>::Rewind(const size_t step)
+{
+  if (batchSize == 0 || bpttSteps == 0 || heldSteps == 0)
+    return;
+
+  // Continue from the output and the cell state before the segment.
+  const size_t checkpoint = (step / heldSteps) * batchSize;
+  outParameter.cols(0, batchStep) = checkpointOutput.cols(checkpoint,
+      checkpoint + batchStep);
+  cell.cols(0, batchStep) = checkpointCell.cols(checkpoint,
+      checkpoint + batchStep);
+
+  forwardStep = 0;
+  forwardStepIdx = step;
 }
 
 template<typename InputDataType, typename OutputDataType>
 void LSTM<InputDataType, OutputDataType>::Reset()
 {
-  // Set the weight parameter for the output gate.
-  input2GateOutputWeight = OutputDataType(weights.memptr(), outSize, inSize,
+  // Set the weight parameter for the input to gates multiplication, for all
+  // gates at once.
+  input2GateWeight = OutputDataType(weights.memptr(), 4 * outSize, inSize,
       false, false);
-  input2GateOutputBias = OutputDataType(weights.memptr() +
-      input2GateOutputWeight.n_elem, outSize, 1, false, false);
-  size_t offset = input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem;
-
-  // Set the weight parameter for the forget gate.
-  input2GateForgetWeight = OutputDataType(weights.memptr() + offset,
-      outSize, inSize, false, false);
-  input2GateForgetBias = OutputDataType(weights.memptr() +
-      offset + input2GateForgetWeight.n_elem, outSize, 1, false, false);
-  offset += input2GateForgetWeight.n_elem + input2GateForgetBias.n_elem;
-
-  // Set the weight parameter for the input gate.
-  input2GateInputWeight = OutputDataType(weights.memptr() +
-      offset, outSize, inSize, false, false);
-  input2GateInputBias = OutputDataType(weights.memptr() +
-      offset + input2GateInputWeight.n_elem, outSize, 1, false, false);
-  offset += input2GateInputWeight.n_elem + input2GateInputBias.n_elem;
-
-  // Set the weight parameter for the hidden gate.
-  input2HiddenWeight = OutputDataType(weights.memptr() +
-      offset, outSize, inSize, false, false);
-  input2HiddenBias = OutputDataType(weights.memptr() +
-      offset + input2HiddenWeight.n_elem, outSize, 1, false, false);
-  offset += input2HiddenWeight.n_elem + input2HiddenBias.n_elem;
-
-  // Set the weight parameter for the output multiplication.
-  output2GateOutputWeight = OutputDataType(weights.memptr() +
-      offset, outSize, outSize, false, false);
-  offset += output2GateOutputWeight.n_elem;
-
-  // Set the weight parameter for the output multiplication.
-  output2GateForgetWeight = OutputDataType(weights.memptr() +
-      offset, outSize, outSize, false, false);
-  offset += output2GateForgetWeight.n_elem;
-
-  // Set the weight parameter for the input multiplication.
-  output2GateInputWeight = OutputDataType(weights.memptr() +
-      offset, outSize, outSize, false, false);
-  offset += output2GateInputWeight.n_elem;
-
-  // Set the weight parameter for the hidden multiplication.
-  output2HiddenWeight = OutputDataType(weights.memptr() +
-      offset, outSize, outSize, false, false);
-  offset += output2HiddenWeight.n_elem;
+  input2GateBias = OutputDataType(weights.memptr() + input2GateWeight.n_elem,
+      4 * outSize, 1, false, false);
+  size_t offset = input2GateWeight.n_elem + input2GateBias.n_elem;
 
-  // Set the weight parameter for the cell multiplication.
-  cell2GateOutputWeight = OutputDataType(weights.memptr() +
-      offset, outSize, 1, false, false);
-  offset += cell2GateOutputWeight.n_elem;
+  // Set the weight parameter for the output to gates multiplication.
+  output2GateWeight = OutputDataType(weights.memptr() + offset,
+      4 * outSize, outSize, false, false);
+  offset += output2GateWeight.n_elem;
+
+  // Set the weight parameter for the cell - input gate multiplication.
+  cell2GateInputWeight = OutputDataType(weights.memptr() + offset,
+      outSize, 1, false, false);
+  offset += cell2GateInputWeight.n_elem;
 
   // Set the weight parameter for the cell - forget gate multiplication.
-  cell2GateForgetWeight = OutputDataType(weights.memptr() +
-      offset, outSize, 1, false, false);
-  offset += cell2GateOutputWeight.n_elem;
+  cell2GateForgetWeight = OutputDataType(weights.memptr() + offset,
+      outSize, 1, false, false);
+  offset += cell2GateForgetWeight.n_elem;
 
-  // Set the weight parameter for the cell - input gate multiplication.
-  cell2GateInputWeight = OutputDataType(weights.memptr() +
-      offset, outSize, 1, false, false);
+  // Set the weight parameter for the cell multiplication.
+  cell2GateOutputWeight = OutputDataType(weights.memptr() + offset,
+      outSize, 1, false, false);
 }
 
 // Forward when cellState is not needed.
@@ -250,6 +256,8 @@ void LSTM<InputDataType, OutputDataType>::Forward(const InputType& input,
                                                   OutputType& cellState,
                                                   bool useCellState)
 {
+  typedef typename OutputDataType::elem_type ElemType;
+
   // Check if the batch size changed, the number of cols is defines the input
   // batch size.
   if (input.n_cols != batchSize)
@@ -259,102 +267,94 @@ void LSTM<InputDataType, OutputDataType>::Forward(const InputType& input,
     ResetCell(rhoSize);
   }
 
-  inputGate.cols(forwardStep, forwardStep + batchStep) = input2GateInputWeight *
-      input + output2GateInputWeight * outParameter.cols(forwardStep,
-      forwardStep + batchStep);
-  inputGate.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2GateInputBias;
-
-  forgetGate.cols(forwardStep, forwardStep + batchStep) = input2GateForgetWeight
-      * input + output2GateForgetWeight * outParameter.cols(
-      forwardStep, forwardStep + batchStep);
-  forgetGate.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2GateForgetBias;
+  if (forwardStepIdx == bpttSteps)
+  {
+    // Start a new sequence.
+    forwardStep = 0;
+    forwardStepIdx = 0;
+    outParameter.cols(0, batchStep).zeros();
+    cell.cols(0, batchStep).zeros();
+  }
+  else if (checkpointInterval > 0 && forwardStep == heldSteps * batchSize)
+  {
+    // Start a new segment from the last held step, and keep its output and
+    // cell state in case the segment is computed again.
+    const size_t checkpoint = (forwardStepIdx / heldSteps) * batchSize;
+    outParameter.cols(0, batchStep) = outParameter.cols(forwardStep,
+        forwardStep + batchStep);
+    cell.cols(0, batchStep) = cell.cols(forwardStep, forwardStep + batchStep);
+    checkpointOutput.cols(checkpoint, checkpoint + batchStep) =
+        outParameter.cols(0, batchStep);
+    checkpointCell.cols(checkpoint, checkpoint + batchStep) =
+        cell.cols(0, batchStep);
+    forwardStep = 0;
+  }
 
-  if (forwardStep > 0)
+  if (forwardStepIdx > 0 && useCellState)
   {
-    if (useCellState)
+    if (!cellState.is_empty())
     {
-      if (!cellState.is_empty())
-      {
-        cell.cols(forwardStep - batchSize,
-            forwardStep - batchSize + batchStep) = cellState;
-      }
-      else
-      {
-        throw std::runtime_error("Cell parameter is empty.");
-      }
+      cell.cols(forwardStep, forwardStep + batchStep) = cellState;
+    }
+    else
+    {
+      throw std::runtime_error("Cell parameter is empty.");
     }
-    inputGate.cols(forwardStep, forwardStep + batchStep) +=
-        arma::repmat(cell2GateInputWeight, 1, batchSize) %
-        cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep);
-
-    forgetGate.cols(forwardStep, forwardStep + batchStep) +=
-        arma::repmat(cell2GateForgetWeight, 1, batchSize) %
-        cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep);
   }
 
-  inputGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
-      (1 + arma::exp(-inputGate.cols(forwardStep, forwardStep + batchStep)));
-
-  forgetGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
-      (1 + arma::exp(-forgetGate.cols(forwardStep, forwardStep + batchStep)));
-
-  hiddenLayer.cols(forwardStep, forwardStep + batchStep) = input2HiddenWeight *
-      input + output2HiddenWeight * outParameter.cols(
+  // The input and output contributions to all four gates.
+  gates = input2GateWeight * input + output2GateWeight * outParameter.cols(
       forwardStep, forwardStep + batchStep);
 
-  hiddenLayer.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2HiddenBias;
-
-  hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep) =
-      arma::tanh(hiddenLayer.cols(forwardStep, forwardStep + batchStep));
-
-  if (forwardStep == 0)
-  {
-    cell.cols(forwardStep, forwardStep + batchStep) =
-        inputGateActivation.cols(forwardStep, forwardStep + batchStep) %
-        hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep);
-  }
-  else
+  // Add the bias and the peephole connections, apply the activations and
+  // update the cell and the output, one unit at a time.
+  const ElemType* bias = input2GateBias.memptr();
+  for (size_t b = 0; b < batchSize; ++b)
   {
-    cell.cols(forwardStep, forwardStep + batchStep) =
-        forgetGateActivation.cols(forwardStep, forwardStep + batchStep) %
-        cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep)
-        + inputGateActivation.cols(forwardStep, forwardStep + batchStep) %
-        hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep);
-  }
-
-  outputGate.cols(forwardStep, forwardStep + batchStep) = input2GateOutputWeight
-      * input + output2GateOutputWeight * outParameter.cols(
-      forwardStep, forwardStep + batchStep) + cell.cols(forwardStep,
-      forwardStep + batchStep).each_col() % cell2GateOutputWeight;
-
-  outputGate.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2GateOutputBias;
+    const size_t col = forwardStep + b;
+    const ElemType* gate = gates.colptr(b);
+    const ElemType* prevCell = cell.colptr(col);
+
+    ElemType* inputAct = inputGateActivation.colptr(col);
+    ElemType* forgetAct = forgetGateActivation.colptr(col);
+    ElemType* hiddenAct = hiddenLayerActivation.colptr(col);
+    ElemType* outputAct = outputGateActivation.colptr(col);
+    ElemType* cellCol = cell.colptr(col + batchSize);
+    ElemType* cellAct = cellActivation.colptr(col);
+    ElemType* out = outParameter.colptr(col + batchSize);
+
+    for (size_t j = 0; j < outSize; ++j)
+    {
+      const ElemType i = gate[j] + bias[j] +
+          cell2GateInputWeight[j] * prevCell[j];
+      const ElemType f = gate[outSize + j] + bias[outSize + j] +
+          cell2GateForgetWeight[j] * prevCell[j];
 
-  outputGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
-      (1 + arma::exp(-outputGate.cols(forwardStep, forwardStep + batchStep)));
+      inputAct[j] = 1.0 / (1.0 + std::exp(-i));
+      forgetAct[j] = 1.0 / (1.0 + std::exp(-f));
+      hiddenAct[j] = std::tanh(gate[2 * outSize + j] + bias[2 * outSize + j]);
 
-  cellActivation.cols(forwardStep, forwardStep + batchStep) =
-      arma::tanh(cell.cols(forwardStep, forwardStep + batchStep));
+      cellCol[j] = inputAct[j] * hiddenAct[j] + forgetAct[j] * prevCell[j];
 
-  outParameter.cols(forwardStep + batchSize,
-      forwardStep + batchSize + batchStep) =
-      cellActivation.cols(forwardStep, forwardStep + batchStep) %
-      outputGateActivation.cols(forwardStep, forwardStep + batchStep);
+      outputAct[j] = 1.0 / (1.0 + std::exp(-(gate[3 * outSize + j] +
+          bias[3 * outSize + j] + cell2GateOutputWeight[j] * cellCol[j])));
+      cellAct[j] = std::tanh(cellCol[j]);
+      out[j] = cellAct[j] * outputAct[j];
+    }
+  }
 
   output = OutputType(outParameter.memptr() +
       (forwardStep + batchSize) * outSize, outSize, batchSize, false, false);
 
   cellState = OutputType(cell.memptr() +
-      forwardStep * outSize, outSize, batchSize, false, false);
+      (forwardStep + batchSize) * outSize, outSize, batchSize, false, false);
+
+  // The backward pass starts with the last computed step.
+  backwardStep = forwardStep + batchStep;
+  gradientStep = forwardStep + batchStep;
 
   forwardStep += batchSize;
-  if ((forwardStep / batchSize) == bpttSteps)
-  {
-    forwardStep = 0;
-  }
+  forwardStepIdx++;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -362,6 +362,8 @@ template<typename InputType, typename ErrorType, typename GradientType>
 void LSTM<InputDataType, OutputDataType>::Backward(
   const InputType& /* input */, const ErrorType& gy, GradientType& g)
 {
+  typedef typename OutputDataType::elem_type ElemType;
+
   ErrorType gyLocal;
   if (gradientStepIdx > 0)
   {
@@ -374,57 +376,56 @@ void LSTM<InputDataType, OutputDataType>::Backward(
         false);
   }
 
-  outputGateError =
-      gyLocal % cellActivation.cols(backwardStep - batchStep, backwardStep) %
-      (outputGateActivation.cols(backwardStep - batchStep, backwardStep) %
-      (1.0 - outputGateActivation.cols(backwardStep - batchStep,
-      backwardStep)));
-
-  OutputDataType cellError = gyLocal %
-      outputGateActivation.cols(backwardStep - batchStep, backwardStep) %
-      (1 - arma::pow(cellActivation.cols(backwardStep -
-      batchStep, backwardStep), 2)) + outputGateError.each_col() %
-      cell2GateOutputWeight;
-
-  if (gradientStepIdx > 0)
-  {
-    cellError += inputCellError;
-  }
+  gateError.set_size(4 * outSize, batchSize);
+  inputCellError.set_size(outSize, batchSize);
 
-  if (backwardStep > batchStep)
-  {
-    forgetGateError = cell.cols((backwardStep - batchSize) - batchStep,
-      (backwardStep - batchSize)) % cellError % (forgetGateActivation.cols(
-      backwardStep - batchStep, backwardStep) % (1.0 -
-      forgetGateActivation.cols(backwardStep - batchStep, backwardStep)));
-  }
-  else
+  // Compute the error of all four gates, and the error passed to the cell of
+  // the previous step, one unit at a time.
+  for (size_t b = 0; b < batchSize; ++b)
   {
-    forgetGateError.zeros();
+    const size_t col = backwardStep - batchStep + b;
+    const ElemType* error = gyLocal.colptr(b);
+    const ElemType* prevCell = cell.colptr(col);
+
+    const ElemType* inputAct = inputGateActivation.colptr(col);
+    const ElemType* forgetAct = forgetGateActivation.colptr(col);
+    const ElemType* hiddenAct = hiddenLayerActivation.colptr(col);
+    const ElemType* outputAct = outputGateActivation.colptr(col);
+    const ElemType* cellAct = cellActivation.colptr(col);
+    ElemType* cellError = inputCellError.colptr(b);
+    ElemType* gateErr = gateError.colptr(b);
+
+    for (size_t j = 0; j < outSize; ++j)
+    {
+      const ElemType outputGateError = error[j] * cellAct[j] *
+          (outputAct[j] * (1.0 - outputAct[j]));
+
+      ElemType cellErr = error[j] * outputAct[j] *
+          (1.0 - cellAct[j] * cellAct[j]) +
+          outputGateError * cell2GateOutputWeight[j];
+      if (gradientStepIdx > 0)
+        cellErr += cellError[j];
+
+      const ElemType forgetGateError = prevCell[j] * cellErr *
+          (forgetAct[j] * (1.0 - forgetAct[j]));
+      const ElemType inputGateError = hiddenAct[j] * cellErr *
+          (inputAct[j] * (1.0 - inputAct[j]));
+      const ElemType hiddenError = inputAct[j] * cellErr *
+          (1.0 - hiddenAct[j] * hiddenAct[j]);
+
+      cellError[j] = forgetAct[j] * cellErr +
+          forgetGateError * cell2GateForgetWeight[j] +
+          inputGateError * cell2GateInputWeight[j];
+
+      gateErr[j] = inputGateError;
+      gateErr[outSize + j] = forgetGateError;
+      gateErr[2 * outSize + j] = hiddenError;
+      gateErr[3 * outSize + j] = outputGateError;
+    }
   }
 
-  inputGateError = hiddenLayerActivation.cols(backwardStep - batchStep,
-      backwardStep) % cellError %
-      (inputGateActivation.cols(backwardStep - batchStep, backwardStep) %
-      (1.0 - inputGateActivation.cols(backwardStep - batchStep, backwardStep)));
-
-  hiddenError = inputGateActivation.cols(backwardStep - batchStep,
-      backwardStep) % cellError % (1 - arma::pow(hiddenLayerActivation.cols(
-      backwardStep - batchStep, backwardStep), 2));
-
-  inputCellError = forgetGateActivation.cols(backwardStep - batchStep,
-      backwardStep) % cellError + forgetGateError.each_col() %
-      cell2GateForgetWeight + inputGateError.each_col() % cell2GateInputWeight;
-
-  g = input2GateInputWeight.t() * inputGateError +
-      input2HiddenWeight.t() * hiddenError +
-      input2GateForgetWeight.t() * forgetGateError +
-      input2GateOutputWeight.t() * outputGateError;
-
-  prevError = output2GateOutputWeight.t() * outputGateError +
-      output2GateForgetWeight.t() * forgetGateError +
-      output2GateInputWeight.t() * inputGateError +
-      output2HiddenWeight.t() * hiddenError;
+  g = input2GateWeight.t() * gateError;
+  prevError = output2GateWeight.t() * gateError;
 
   backwardStep -= batchSize;
   gradientStepIdx++;
@@ -442,93 +443,38 @@ void LSTM<InputDataType, OutputDataType>::Gradient(
     const ErrorType& /* error */,
     GradientType& gradient)
 {
-  // Input2GateOutputWeight and input2GateOutputBias gradients.
-  gradient.submat(0, 0, input2GateOutputWeight.n_elem - 1, 0) =
-      arma::vectorise(outputGateError * input.t());
-  gradient.submat(input2GateOutputWeight.n_elem, 0,
-      input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem - 1, 0) =
-      arma::sum(outputGateError, 1);
-  size_t offset = input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem;
-
-  // Input2GateForgetWeight and input2GateForgetBias gradients.
-  gradient.submat(offset, 0, offset + input2GateForgetWeight.n_elem - 1, 0) =
-      arma::vectorise(forgetGateError * input.t());
-  gradient.submat(offset + input2GateForgetWeight.n_elem, 0,
-      offset + input2GateForgetWeight.n_elem +
-      input2GateForgetBias.n_elem - 1, 0) = arma::sum(forgetGateError, 1);
-  offset += input2GateForgetWeight.n_elem + input2GateForgetBias.n_elem;
-
-  // Input2GateInputWeight and input2GateInputBias gradients.
-  gradient.submat(offset, 0, offset + input2GateInputWeight.n_elem - 1, 0) =
-      arma::vectorise(inputGateError * input.t());
-  gradient.submat(offset + input2GateInputWeight.n_elem, 0,
-      offset + input2GateInputWeight.n_elem +
-      input2GateInputBias.n_elem - 1, 0) = arma::sum(inputGateError, 1);
-  offset += input2GateInputWeight.n_elem + input2GateInputBias.n_elem;
-
-  // Input2HiddenWeight and input2HiddenBias gradients.
-  gradient.submat(offset, 0, offset + input2HiddenWeight.n_elem - 1, 0) =
-      arma::vectorise(hiddenError * input.t());
-  gradient.submat(offset + input2HiddenWeight.n_elem, 0,
-      offset + input2HiddenWeight.n_elem + input2HiddenBias.n_elem - 1, 0) =
-      arma::sum(hiddenError, 1);
-  offset += input2HiddenWeight.n_elem + input2HiddenBias.n_elem;
-
-  // Output2GateOutputWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateOutputWeight.n_elem - 1, 0) =
-      arma::vectorise(outputGateError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2GateOutputWeight.n_elem;
-
-  // Output2GateForgetWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateForgetWeight.n_elem - 1, 0) =
-      arma::vectorise(forgetGateError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2GateForgetWeight.n_elem;
-
-  // Output2GateInputWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateInputWeight.n_elem - 1, 0) =
-      arma::vectorise(inputGateError *
+  // Input2GateWeight and input2GateBias gradients.
+  gradient.submat(0, 0, input2GateWeight.n_elem - 1, 0) =
+      arma::vectorise(gateError * input.t());
+  gradient.submat(input2GateWeight.n_elem, 0,
+      input2GateWeight.n_elem + input2GateBias.n_elem - 1, 0) =
+      arma::sum(gateError, 1);
+  size_t offset = input2GateWeight.n_elem + input2GateBias.n_elem;
+
+  // Output2GateWeight gradients.
+  gradient.submat(offset, 0, offset + output2GateWeight.n_elem - 1, 0) =
+      arma::vectorise(gateError *
       outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2GateInputWeight.n_elem;
+  offset += output2GateWeight.n_elem;
 
-  // Output2HiddenWeight gradients.
-  gradient.submat(offset, 0, offset + output2HiddenWeight.n_elem - 1, 0) =
-      arma::vectorise(hiddenError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2HiddenWeight.n_elem;
+  // Cell2GateInputWeight and cell2GateForgetWeight gradients.
+  gradient.submat(offset, 0, offset + cell2GateInputWeight.n_elem - 1, 0) =
+      arma::sum(gateError.rows(0, outSize - 1) %
+      cell.cols(gradientStep - batchStep, gradientStep), 1);
+  gradient.submat(offset + cell2GateInputWeight.n_elem, 0, offset +
+      cell2GateInputWeight.n_elem + cell2GateForgetWeight.n_elem - 1, 0) =
+      arma::sum(gateError.rows(outSize, 2 * outSize - 1) %
+      cell.cols(gradientStep - batchStep, gradientStep), 1);
+  offset += cell2GateInputWeight.n_elem + cell2GateForgetWeight.n_elem;
 
   // Cell2GateOutputWeight gradients.
   gradient.submat(offset, 0, offset + cell2GateOutputWeight.n_elem - 1, 0) =
-      arma::sum(outputGateError %
-      cell.cols(gradientStep - batchStep, gradientStep), 1);
-  offset += cell2GateOutputWeight.n_elem;
+      arma::sum(gateError.rows(3 * outSize, 4 * outSize - 1) %
+      cell.cols(gradientStep + 1, gradientStep + batchSize), 1);
 
-  // Cell2GateForgetWeight and cell2GateInputWeight gradients.
-  if (gradientStep > batchStep)
+  if (gradientStep == batchStep)
   {
-    gradient.submat(offset, 0, offset + cell2GateForgetWeight.n_elem - 1, 0) =
-        arma::sum(forgetGateError %
-                  cell.cols((gradientStep - batchSize) - batchStep,
-                            (gradientStep - batchSize)), 1);
-    gradient.submat(offset + cell2GateForgetWeight.n_elem, 0, offset +
-        cell2GateForgetWeight.n_elem + cell2GateInputWeight.n_elem - 1, 0) =
-        arma::sum(inputGateError %
-                  cell.cols((gradientStep - batchSize) - batchStep,
-                            (gradientStep - batchSize)), 1);
-  }
-  else
-  {
-    gradient.submat(offset, 0, offset +
-        cell2GateForgetWeight.n_elem - 1, 0).zeros();
-    gradient.submat(offset + cell2GateForgetWeight.n_elem, 0, offset +
-        cell2GateForgetWeight.n_elem +
-        cell2GateInputWeight.n_elem - 1, 0).zeros();
-  }
-
-  if (gradientStep == 0)
-  {
-    gradientStep = batchSize * bpttSteps - 1;
+    gradientStep = batchSize * heldSteps - 1;
   }
   else
   {
@@ -539,8 +485,18 @@ void LSTM<InputDataType, OutputDataType>::Gradient(
 template<typename InputDataType, typename OutputDataType>
 template<typename Archive>
 void LSTM<InputDataType, OutputDataType>::serialize(
-    Archive& ar, const uint32_t /* version */)
+    Archive& ar, const uint32_t version)
 {
+  // Before version 1 the weights of each gate were stored separately.  The
+  // network that holds the layer stores the parameters in that order too, so
+  // they can't be converted here.
+  if (cereal::is_loading<Archive>() && version == 0)
+  {
+    throw std::runtime_error("LSTM::serialize(): the model was saved with an "
+        "older version of mlpack, which used a different layout for the LSTM "
+        "weights; the model has to be retrained.");
+  }
+
   ar(CEREAL_NVP(weights));
   ar(CEREAL_NVP(inSize));
   ar(CEREAL_NVP(outSize));
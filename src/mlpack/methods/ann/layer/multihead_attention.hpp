@@ -48,6 +48,11 @@ namespace ann /** Artificial Neural Network. */ {
  * of shape `(embedDim * tgtSeqLen, batchSize)`. The embeddings are stored
  * consequently.
  *
+ * The attention weights are never stored as a whole; they are computed for
+ * blocks of BlockSize source positions at a time, and recomputed during the
+ * backward pass.  This means the memory needed does not grow with
+ * `tgtSeqLen * srcSeqLen`.
+ *
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
  * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
@@ -174,6 +179,11 @@ class MultiheadAttention
   //! Modify the gradient.
   OutputDataType& Gradient() { return grad; }
 
+  //! Get whether the regularizer is added to the gradient.
+  bool Regularize() const { return regularize; }
+  //! Modify whether the regularizer is added to the gradient.
+  bool& Regularize() { return regularize; }
+
   //! Get the parameters.
   OutputDataType const& Parameters() const { return weights; }
   //! Modify the parameters.
@@ -188,6 +198,43 @@ class MultiheadAttention
   //! Element Type of the input.
   typedef typename OutputDataType::elem_type ElemType;
 
+  //! The number of source positions whose attention weights are computed at
+  //! once.
+  static constexpr size_t BlockSize = 64;
+
+  /**
+   * Compute the attention weights of the given slice of the projected query
+   * for the source positions begin to end (inclusive), with the masks applied.
+   * Each column of the result is normalized with the softmax function.
+   *
+   * @param slice Index of the slice (head and batch) of the projections.
+   * @param begin First source position.
+   * @param end Last source position.
+   * @param attention Matrix to store the attention weights in.
+   */
+  template<typename eT>
+  void AttentionWeights(const size_t slice,
+                        const size_t begin,
+                        const size_t end,
+                        arma::Mat<eT>& attention) const;
+
+  /**
+   * Propagate the error of the attention output back to the projected query,
+   * key and value, recomputing the attention weights block by block.  The
+   * error of the query is not yet divided by the scaling factor.
+   *
+   * @param gy The error of the attention output, of shape
+   *     (tgtSeqLen, headDim, numHeads * batchSize).
+   * @param dQuery Error of the projected query.
+   * @param dKey Error of the projected key.
+   * @param dValue Error of the projected value.
+   */
+  template<typename eT>
+  void AttentionBackward(const arma::Cube<eT>& gy,
+                         arma::Cube<eT>& dQuery,
+                         arma::Cube<eT>& dKey,
+                         arma::Cube<eT>& dValue) const;
+
   //! Target sequence length.
   size_t tgtSeqLen;
 
@@ -245,15 +292,9 @@ class MultiheadAttention
   //! Locally-stored projected value matrix over linear layer.
   arma::Cube<ElemType> vProj;
 
-  //! Locally-stored result of output of dropout layer.
-  arma::Cube<ElemType> scores;
-
   //! Locally-stored attention output weight to be fed to last linear layer.
   arma::Cube<ElemType> attnOut;
 
-  //! Softmax layer to represent the probabilities of next sequence.
-  Softmax<InputDataType, OutputDataType> softmax;
-
   //! Locally-stored delta object.
   OutputDataType delta;
 
@@ -265,6 +306,9 @@ class MultiheadAttention
 
   //! Locally-stored regularizer object.
   RegularizerType regularizer;
+
+  //! If true, the regularizer is added to the gradient.
+  bool regularize;
 }; // class MultiheadAttention
 } // namespace ann
 } // namespace mlpack
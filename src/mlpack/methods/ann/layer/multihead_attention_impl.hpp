@@ -29,7 +29,8 @@ MultiheadAttention() :
     srcSeqLen(0),
     embedDim(0),
     numHeads(0),
-    headDim(0)
+    headDim(0),
+    regularize(true)
 {
   // Nothing to do here.
 }
@@ -45,7 +46,8 @@ MultiheadAttention(
     tgtSeqLen(tgtSeqLen),
     srcSeqLen(srcSeqLen),
     embedDim(embedDim),
-    numHeads(numHeads)
+    numHeads(numHeads),
+    regularize(true)
 {
   if (embedDim % numHeads != 0)
   {
@@ -139,43 +141,39 @@ Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
   kProj.reshape(srcSeqLen, headDim, numHeads * batchSize);
   vProj.reshape(srcSeqLen, headDim, numHeads * batchSize);
 
-  // Calculate the scores i.e. perform the matrix multiplication operation
-  // on qProj and kProj. Here score = qProj . kProj'
-  scores = math::MultiplyCube2Cube(qProj, kProj, false, true);
-
-  // Apply the attention mask if provided. The attention mask is used to black-
-  // out future sequences and generally used in Encoder-Decoder attention.
-  // The attention mask has elements 0 or -infinity.
+  // The attention mask is used to black-out future sequences and generally
+  // used in Encoder-Decoder attention. The attention mask has elements 0 or
+  // -infinity.
   // The shape of the attention mask : (tgtSeqLen, srcSeqLen).
-  if (!attnMask.is_empty())
-  {
-    if (attnMask.n_rows != tgtSeqLen || attnMask.n_cols != srcSeqLen)
-      Log::Fatal << "The size of the 'attn_mask' is not correct.\n";
-    scores.each_slice() += attnMask;
-  }
+  if (!attnMask.is_empty() &&
+      (attnMask.n_rows != tgtSeqLen || attnMask.n_cols != srcSeqLen))
+    Log::Fatal << "The size of the 'attn_mask' is not correct.\n";
 
-  // Apply the key padding mask when provided. It blacks-out any particular
-  // word in the sequence.
+  // The key padding mask blacks-out any particular word in the sequence.
   // The key padding mask has elements 0 or -infinity.
   // The shape of keyPaddingMask : (1, srcSeqLen).
-  if (!keyPaddingMask.is_empty())
-  {
-    if (keyPaddingMask.n_rows != 1 || keyPaddingMask.n_cols != srcSeqLen)
-        Log::Fatal << "The size of the 'keyPaddingMask' is not correct.\n";
-    scores.each_slice() += arma::repmat(keyPaddingMask, tgtSeqLen, 1);
-  }
+  if (!keyPaddingMask.is_empty() &&
+      (keyPaddingMask.n_rows != 1 || keyPaddingMask.n_cols != srcSeqLen))
+    Log::Fatal << "The size of the 'keyPaddingMask' is not correct.\n";
+
+  // Calculate the attention output i.e. matrix multiplication of the attention
+  // weights and vProj, one block of source positions at a time, so that the
+  // full (tgtSeqLen, srcSeqLen) attention weights are never stored.
+  // The shape of attnOutput : (tgtSeqLen, headDim, numHeads * batchSize).
+  attnOut.zeros(tgtSeqLen, headDim, numHeads * batchSize);
 
-  for (size_t i = 0; i < numHeads * batchSize; ++i)
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) attnOut.n_slices; ++s)
   {
-    softmax.Forward(scores.slice(i), softmax.OutputParameter());
-    scores.slice(i) = softmax.OutputParameter();
+    arma::Mat<eT> attention;
+    for (size_t begin = 0; begin < srcSeqLen; begin += BlockSize)
+    {
+      const size_t end = std::min(begin + BlockSize, srcSeqLen) - 1;
+      AttentionWeights(s, begin, end, attention);
+      attnOut.slice(s) += attention * vProj.slice(s).rows(begin, end);
+    }
   }
 
-  // Calculate the attention output i.e. matrix multiplication of softmax
-  // output and vProj.
-  // The shape of attnOutput : (tgtSeqLen, headDim, numHeads * batchSize).
-  attnOut = math::MultiplyCube2Cube(scores, vProj, false, false);
-
   // Now we will concatenate output of all the heads i.e. we will reshape
   // attnOut to (tgtSeqLen, embedDim, batchSize).
   attnOut.reshape(tgtSeqLen, embedDim, batchSize);
@@ -223,60 +221,38 @@ Backward(const arma::Mat<eT>& /* input */,
   // The shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
   gyTemp.reshape(tgtSeqLen, headDim, numHeads * batchSize);
 
-  // Obtain backpropagted error of value.
-  // Shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
-  // Shape of scores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The shape of tmp : (srcSeqLen, headDim, numHeads * batchSize).
-  CubeType tmp = math::MultiplyCube2Cube(scores, gyTemp, true, false);
+  // Obtain the backpropagated errors of the projected query, key and value.
+  // The shape of dQuery : (tgtSeqLen, headDim, numHeads * batchSize).
+  // The shape of dKey, dValue : (srcSeqLen, headDim, numHeads * batchSize).
+  CubeType dQuery, dKey, dValue;
+  AttentionBackward(gyTemp, dQuery, dKey, dValue);
 
   // Concatenate results of all the attention heads.
-  tmp.reshape(srcSeqLen, embedDim, batchSize);
+  dValue.reshape(srcSeqLen, embedDim, batchSize);
 
   for (size_t i = 0; i < batchSize; ++i)
   {
     g.submat((tgtSeqLen + srcSeqLen) * embedDim, i, g.n_rows - 1, i)
-        = arma::vectorise(arma::trans(tmp.slice(i) * valueWt));
-  }
-
-  // The shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
-  // The shape of vProj : (srcSeqLen, headDim, numHeads * batchSize).
-  // So the new shape of gyTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  gyTemp = math::MultiplyCube2Cube(gyTemp, vProj, false, true);
-
-  for (size_t i = 0; i < numHeads * batchSize; ++i)
-  {
-    // We will perform backpropagation of softmax over each slice of gyTemp.
-    softmax.Backward(scores.slice(i), gyTemp.slice(i), gyTemp.slice(i));
+        = arma::vectorise(arma::trans(dValue.slice(i) * valueWt));
   }
 
-  // Obtain backpropagated error of key.
-  // The shape of qProj : (tgtSeqLen, headDim, numHeads * batchSize).
-  // The shape of gyTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The new shape of tmp : (srcSeqLen, headDim, numHeads * batchSize).
-  tmp = math::MultiplyCube2Cube(gyTemp, qProj, true, false);
-
   // Concatenate results of all the attention heads.
-  tmp.reshape(srcSeqLen, embedDim, batchSize);
+  dKey.reshape(srcSeqLen, embedDim, batchSize);
 
   for (size_t i = 0; i < batchSize; ++i)
   {
     g.submat(tgtSeqLen * embedDim, i, (tgtSeqLen + srcSeqLen) * embedDim - 1, i)
-        = arma::vectorise(arma::trans(tmp.slice(i) * keyWt));
+        = arma::vectorise(arma::trans(dKey.slice(i) * keyWt));
   }
 
-  // Obtain backpropagated error of the query.
-  // The shape of kProj : (srcSeqLen, headDim, numHeads * batchSize).
-  // The shape of gyTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The new shape of tmp : (tgtSeqLen, headDim, numHeads * batchSize).
-  tmp = math::MultiplyCube2Cube(gyTemp, kProj) / std::sqrt(headDim);
-
   // Concatenate results of all the attention heads.
-  tmp.reshape(tgtSeqLen, embedDim, batchSize);
+  dQuery.reshape(tgtSeqLen, embedDim, batchSize);
+  dQuery /= std::sqrt(headDim);
 
   for (size_t i = 0; i < batchSize; ++i)
   {
     g.submat(0, i, tgtSeqLen * embedDim - 1, i)
-        = arma::vectorise(arma::trans(tmp.slice(i) * queryWt));
+        = arma::vectorise(arma::trans(dQuery.slice(i) * queryWt));
   }
 }
 
@@ -343,91 +319,129 @@ Gradient(const arma::Mat<eT>& input,
   // (tgtSeqLen, headDim, numHeads * batchSize).
   gyTemp.reshape(tgtSeqLen, headDim, numHeads * batchSize);
 
-  // Shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
-  // Shape of scores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The new shape of errorTemp : (srcSeqLen, headDim, numHeads * batchSize).
-  errorTemp = math::MultiplyCube2Cube(scores, gyTemp, true, false);
+  // Obtain the backpropagated errors of the projected query, key and value.
+  // The shape of dQuery : (tgtSeqLen, headDim, numHeads * batchSize).
+  // The shape of dKey, dValue : (srcSeqLen, headDim, numHeads * batchSize).
+  CubeType dQuery, dKey, dValue;
+  AttentionBackward(gyTemp, dQuery, dKey, dValue);
 
   // Now we will concatenate the propagated errors from all heads i.e. we
-  // will reshape errorTemp to (srcSeqLen, embedDim, batchSize).
-  errorTemp.reshape(srcSeqLen, embedDim, batchSize);
+  // will reshape dValue to (srcSeqLen, embedDim, batchSize).
+  dValue.reshape(srcSeqLen, embedDim, batchSize);
 
-  // Gradient wrt. vBias, i.e. dL/d(vBias). We will take summation of errorTemp
+  // Gradient wrt. vBias, i.e. dL/d(vBias). We will take summation of dValue
   // over all the batches and over all the sequences.
   gradient.rows(4 * wtSize + 2 * embedDim, 4 * wtSize + 3 * embedDim - 1)
-      = arma::vectorise(arma::sum(arma::sum(errorTemp, 2), 0));
+      = arma::vectorise(arma::sum(arma::sum(dValue, 2), 0));
 
   // Shape of v : (srcSeqLen, embedDim, batchSize).
-  // Shape of errorTemp : (srcSeqLen, embedDim, bathSize).
+  // Shape of dValue : (srcSeqLen, embedDim, bathSize).
   // The new shape of errorTemp : (embedDim, embedDim, batchSize).
-  errorTemp = math::MultiplyCube2Cube(errorTemp, v, true, true);
+  errorTemp = math::MultiplyCube2Cube(dValue, v, true, true);
 
   // Gradient wrt. valueWt, i.e. dL/d(valueWt). We will take summation over all
   // batches of errorTemp.
   gradient.rows(2 * wtSize, 3 * wtSize - 1)
       = arma::vectorise(arma::sum(errorTemp, 2));
 
-  // Now, the shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
-  // The shape of vProj : (srcSeqLen, headDim, numHeads * batchSize).
-  // The new shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  errorTemp = math::MultiplyCube2Cube(gyTemp, vProj, false, true);
-
-  for (size_t i = 0; i < numHeads * batchSize; ++i)
-  {
-    // The shape of scores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-    // The shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-    // The new shape of errorTemp remain same.
-    softmax.Backward(scores.slice(i), errorTemp.slice(i), errorTemp.slice(i));
-  }
-
-  // The shape of qProj : (tgtSeqLen, headDim, numHeads * batchSize).
-  // The shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The shape of gyTemp : (srcSeqLen, headDim, numHeads * batchSize).
-  gyTemp = math::MultiplyCube2Cube(errorTemp, qProj, true, false);
-
   // We will now conctenate the propagated errors from all heads.
-  // The new shape of gyTemp : (srcSeqLen, embedDim, batchSize).
-  gyTemp.reshape(srcSeqLen, embedDim, batchSize);
+  // The new shape of dKey : (srcSeqLen, embedDim, batchSize).
+  dKey.reshape(srcSeqLen, embedDim, batchSize);
 
   // Gradient wrt. kBias, i.e. dL/d(kBias). We will take summation over all the
-  // batches of gyTemp and then over all the sequences.
+  // batches of dKey and then over all the sequences.
   gradient.rows(4 * wtSize + embedDim, 4 * wtSize + 2 * embedDim - 1)
-      = arma::vectorise(arma::sum(arma::sum(gyTemp, 2), 0));
+      = arma::vectorise(arma::sum(arma::sum(dKey, 2), 0));
 
   // The shape of k : (embedDim, srcSeqLen, batchSize).
-  // The shape of gyTemp : (srcSeqLen, embedDim, batchSize).
+  // The shape of dKey : (srcSeqLen, embedDim, batchSize).
   // The shape of dkeyWt : (embedDim, embedDim, batchSize).
-  gyTemp = math::MultiplyCube2Cube(gyTemp, k, true, true);
+  gyTemp = math::MultiplyCube2Cube(dKey, k, true, true);
 
   // Gradient wrt. keyWt, i.e. dL/d(keyWt). We will take summation over all the
   // batches of dkeyWt.
   gradient.rows(wtSize, 2 * wtSize - 1) = arma::vectorise(arma::sum(gyTemp, 2));
 
-  // The shape of kProj : (srcSeqLen, headDim, numHeads * batchSize).
-  // The shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
-  gyTemp = math::MultiplyCube2Cube(errorTemp, kProj, false, false);
-
   // Now, we will concatenate propagated error of all heads.
-  gyTemp.reshape(tgtSeqLen, embedDim, batchSize);
-  gyTemp /= std::sqrt(headDim);
+  dQuery.reshape(tgtSeqLen, embedDim, batchSize);
+  dQuery /= std::sqrt(headDim);
 
   // Gradient wrt. qBias, i.e. dL/d(qBias). We will take summation over all the
-  // batches of gyTemp and over all the sequences.
+  // batches of dQuery and over all the sequences.
   gradient.rows(4 * wtSize, 4 * wtSize + embedDim - 1)
-      = arma::vectorise(arma::sum(arma::sum(gyTemp, 2), 0));
+      = arma::vectorise(arma::sum(arma::sum(dQuery, 2), 0));
 
-  // The shape of gyTemp : (tgtSeqLen, embedDim, batchSize).
+  // The shape of dQuery : (tgtSeqLen, embedDim, batchSize).
   // The shape of q : (embedDim, tgtSeqLen, batchSize).
   // The shape of gyTemp : (embedDim, embedDim, batchSize).
-  gyTemp = math::MultiplyCube2Cube(gyTemp, q, true, true);
+  gyTemp = math::MultiplyCube2Cube(dQuery, q, true, true);
 
   // Gradient wrt. queryWt, i.e. dL/d(queryBias). We will take summation over
   // all the batches of gyTemp.
   gradient.rows(0, wtSize - 1) = arma::vectorise(arma::sum(gyTemp, 2));
 
   // Regularize according to the given regularization rule.
-  regularizer.Evaluate(weights, gradient);
+  if (regularize)
+    regularizer.Evaluate(weights, gradient);
+}
+
+template <typename InputDataType, typename OutputDataType,
+          typename RegularizerType>
+template <typename eT>
+void MultiheadAttention<InputDataType, OutputDataType, RegularizerType>::
+AttentionWeights(const size_t slice,
+                 const size_t begin,
+                 const size_t end,
+                 arma::Mat<eT>& attention) const
+{
+  // Here attention = qProj . kProj' for the source positions in the block.
+  attention = qProj.slice(slice) * kProj.slice(slice).rows(begin, end).t();
+
+  if (!attnMask.is_empty())
+    attention += attnMask.cols(begin, end);
+
+  if (!keyPaddingMask.is_empty())
+    attention.each_row() += keyPaddingMask.cols(begin, end);
+
+  // The softmax normalizes each source position over the target sequence, so
+  // every column of the block can be normalized on its own.
+  attention = arma::exp(attention.each_row() - arma::max(attention, 0));
+  attention.each_row() /= arma::sum(attention, 0);
+}
+
+template <typename InputDataType, typename OutputDataType,
+          typename RegularizerType>
+template <typename eT>
+void MultiheadAttention<InputDataType, OutputDataType, RegularizerType>::
+AttentionBackward(const arma::Cube<eT>& gy,
+                  arma::Cube<eT>& dQuery,
+                  arma::Cube<eT>& dKey,
+                  arma::Cube<eT>& dValue) const
+{
+  dQuery.zeros(tgtSeqLen, headDim, gy.n_slices);
+  dKey.set_size(srcSeqLen, headDim, gy.n_slices);
+  dValue.set_size(srcSeqLen, headDim, gy.n_slices);
+
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) gy.n_slices; ++s)
+  {
+    arma::Mat<eT> attention, dAttention;
+    for (size_t begin = 0; begin < srcSeqLen; begin += BlockSize)
+    {
+      const size_t end = std::min(begin + BlockSize, srcSeqLen) - 1;
+      AttentionWeights(s, begin, end, attention);
+
+      dValue.slice(s).rows(begin, end) = attention.t() * gy.slice(s);
+
+      // Backpropagate through the softmax of each column.
+      dAttention = gy.slice(s) * vProj.slice(s).rows(begin, end).t();
+      dAttention = attention % (dAttention.each_row() -
+          arma::sum(dAttention % attention, 0));
+
+      dKey.slice(s).rows(begin, end) = dAttention.t() * qProj.slice(s);
+      dQuery.slice(s) += dAttention * kProj.slice(s).rows(begin, end);
+    }
+  }
 }
 
 template <typename InputDataType, typename OutputDataType,
@@ -0,0 +1,193 @@
+/**
+ * @file methods/ann/layer/quantized_convolution_impl.hpp
+ *
+ * Implementation of the QuantizedConvolution layer class, a Convolution layer
+ * with 8-bit integer filters for inference.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "quantized_convolution.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+QuantizedConvolution<InputDataType, OutputDataType>::QuantizedConvolution() :
+    inSize(0),
+    outSize(0),
+    kernelWidth(0),
+    kernelHeight(0),
+    strideWidth(1),
+    strideHeight(1),
+    padWLeft(0),
+    padWRight(0),
+    padHBottom(0),
+    padHTop(0),
+    inputWidth(0),
+    inputHeight(0),
+    outputWidth(0),
+    outputHeight(0)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename ForwardConvolutionRule,
+         typename BackwardConvolutionRule,
+         typename GradientConvolutionRule>
+QuantizedConvolution<InputDataType, OutputDataType>::QuantizedConvolution(
+    const Convolution<ForwardConvolutionRule,
+                      BackwardConvolutionRule,
+                      GradientConvolutionRule,
+                      InputDataType,
+                      OutputDataType>& layer,
+    const double inputScale) :
+    inSize(layer.InputSize()),
+    outSize(layer.OutputSize()),
+    kernelWidth(layer.KernelWidth()),
+    kernelHeight(layer.KernelHeight()),
+    strideWidth(layer.StrideWidth()),
+    strideHeight(layer.StrideHeight()),
+    padWLeft(layer.PadWLeft()),
+    padWRight(layer.PadWRight()),
+    padHBottom(layer.PadHBottom()),
+    padHTop(layer.PadHTop()),
+    inputWidth(layer.InputWidth()),
+    inputHeight(layer.InputHeight()),
+    outputWidth(0),
+    outputHeight(0)
+{
+  if (inputWidth == 0 || inputHeight == 0)
+  {
+    Log::Fatal << "QuantizedConvolution::QuantizedConvolution(): the input "
+        << "width and height of the convolution layer have to be known!"
+        << std::endl;
+  }
+
+  outputWidth = (inputWidth + padWLeft + padWRight - kernelWidth) /
+      strideWidth + 1;
+  outputHeight = (inputHeight + padHTop + padHBottom - kernelHeight) /
+      strideHeight + 1;
+
+  // The filters of output map o are the contiguous slices o * inSize to
+  // (o + 1) * inSize - 1, in the same order as the rows of the im2col matrix.
+  typedef typename OutputDataType::elem_type ElemType;
+  const OutputDataType filters(const_cast<ElemType*>(
+      layer.Weight().memptr()), kernelWidth * kernelHeight * inSize, outSize,
+      false, true);
+  linear = QuantizedLinear<InputDataType, OutputDataType>(filters.t(),
+      layer.Bias(), inputScale);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedConvolution<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  const size_t batchSize = input.n_cols;
+  const size_t points = outputWidth * outputHeight;
+  const arma::Cube<eT> inputTemp(const_cast<arma::Mat<eT>&>(input).memptr(),
+      inputWidth, inputHeight, inSize * batchSize, false, true);
+
+  arma::Cube<eT> inputPadded;
+  const bool padded = (padWLeft != 0 || padWRight != 0 || padHTop != 0 ||
+      padHBottom != 0);
+  if (padded)
+  {
+    inputPadded.zeros(inputWidth + padWLeft + padWRight,
+        inputHeight + padHTop + padHBottom, inputTemp.n_slices);
+    for (size_t i = 0; i < inputTemp.n_slices; ++i)
+    {
+      inputPadded.slice(i).submat(padWLeft, padHTop,
+          padWLeft + inputWidth - 1, padHTop + inputHeight - 1) =
+          inputTemp.slice(i);
+    }
+  }
+
+  arma::Mat<eT> columns;
+  Im2ColConvolution<>::Im2Col(padded ? inputPadded : inputTemp, inSize,
+      kernelWidth, kernelHeight, outputWidth, outputHeight, strideWidth,
+      strideHeight, 1, 1, columns);
+
+  // Every column of the result holds all output maps of one position.
+  arma::Mat<eT> result;
+  linear.Forward(columns, result);
+
+  output.set_size(points * outSize, batchSize);
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) batchSize; ++b)
+  {
+    arma::Mat<eT> outputMaps(output.colptr(b), points, outSize, false, true);
+    outputMaps = result.cols(b * points, (b + 1) * points - 1).t();
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedConvolution<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+{
+  const size_t batchSize = gy.n_cols;
+  const size_t points = outputWidth * outputHeight;
+
+  arma::Mat<eT> errorMatrix(outSize, points * batchSize);
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) batchSize; ++b)
+  {
+    const arma::Mat<eT> errorMaps(const_cast<eT*>(gy.colptr(b)), points,
+        outSize, false, true);
+    errorMatrix.cols(b * points, (b + 1) * points - 1) = errorMaps.t();
+  }
+
+  arma::Mat<eT> columns;
+  linear.Backward(errorMatrix, errorMatrix, columns);
+
+  arma::Cube<eT> gPadded(inputWidth + padWLeft + padWRight,
+      inputHeight + padHTop + padHBottom, inSize * batchSize,
+      arma::fill::zeros);
+  Im2ColConvolution<>::Col2Im(columns, inSize, kernelWidth, kernelHeight,
+      outputWidth, outputHeight, strideWidth, strideHeight, 1, 1, gPadded);
+
+  g.set_size(inputWidth * inputHeight * inSize, batchSize);
+  arma::Cube<eT> gTemp(g.memptr(), inputWidth, inputHeight,
+      inSize * batchSize, false, true);
+  for (size_t i = 0; i < gTemp.n_slices; ++i)
+  {
+    gTemp.slice(i) = gPadded.slice(i).submat(padWLeft, padHTop,
+        padWLeft + inputWidth - 1, padHTop + inputHeight - 1);
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void QuantizedConvolution<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(inSize));
+  ar(CEREAL_NVP(outSize));
+  ar(CEREAL_NVP(kernelWidth));
+  ar(CEREAL_NVP(kernelHeight));
+  ar(CEREAL_NVP(strideWidth));
+  ar(CEREAL_NVP(strideHeight));
+  ar(CEREAL_NVP(padWLeft));
+  ar(CEREAL_NVP(padWRight));
+  ar(CEREAL_NVP(padHBottom));
+  ar(CEREAL_NVP(padHTop));
+  ar(CEREAL_NVP(inputWidth));
+  ar(CEREAL_NVP(inputHeight));
+  ar(CEREAL_NVP(outputWidth));
+  ar(CEREAL_NVP(outputHeight));
+  ar(CEREAL_NVP(linear));
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,198 @@
+/**
+ * @file methods/ann/layer/quantized_linear.hpp
+ *
+ * Definition of the QuantizedLinear layer class, a Linear layer with 8-bit
+ * integer weights for inference.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "layer_types.hpp"
+#include "linear.hpp"
+#include "linear_no_bias.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Implementation of the QuantizedLinear layer class.  This is the inference
+ * counterpart of the Linear and LinearNoBias layers: the weights are stored as
+ * 8-bit integers, with one scale per output unit (symmetric per-channel
+ * quantization), and the input is quantized to 8-bit integers with a single
+ * scale that is chosen on calibration data.  The products are accumulated in
+ * 32-bit integers and the result is scaled back and shifted by the bias, which
+ * is kept in full precision.
+ *
+ * The layer is usually not created directly but by FFN::Quantize().  It has no
+ * trainable parameters; the backward pass uses the dequantized weights, so
+ * errors can still be propagated through it.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class QuantizedLinear
+{
+ public:
+  //! Create the QuantizedLinear object.
+  QuantizedLinear();
+
+  /**
+   * Create the QuantizedLinear layer object by quantizing the given weights.
+   *
+   * @param weight The weights, one row per output unit.
+   * @param bias The bias of the output units; may be empty.
+   * @param inputScale The difference between two consecutive quantized input
+   *     values; inputs outside of [-127, 127] * inputScale are clipped.
+   */
+  QuantizedLinear(const OutputDataType& weight,
+                  const OutputDataType& bias,
+                  const double inputScale);
+
+  /**
+   * Create the QuantizedLinear layer object by quantizing the weights of the
+   * given Linear layer.
+   *
+   * @param layer The layer to quantize.
+   * @param inputScale The difference between two consecutive quantized input
+   *     values.
+   */
+  template<typename RegularizerType>
+  QuantizedLinear(
+      const Linear<InputDataType, OutputDataType, RegularizerType>& layer,
+      const double inputScale);
+
+  /**
+   * Create the QuantizedLinear layer object by quantizing the weights of the
+   * given LinearNoBias layer.
+   *
+   * @param layer The layer to quantize.
+   * @param inputScale The difference between two consecutive quantized input
+   *     values.
+   */
+  template<typename RegularizerType>
+  QuantizedLinear(
+      const LinearNoBias<InputDataType, OutputDataType, RegularizerType>& layer,
+      const double inputScale);
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f, using the dequantized weights.
+   *
+   * @param * (input) The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>& /* input */,
+                const arma::Mat<eT>& gy,
+                arma::Mat<eT>& g);
+
+  //! Get the weights, converted back from 8-bit integers.
+  OutputDataType DequantizedWeight() const;
+
+  //! Get the quantized weights, stored row by row.
+  const std::vector<int8_t>& QuantizedWeight() const { return weights; }
+
+  //! Get the scale of the quantized weights of each output unit.
+  OutputDataType const& WeightScale() const { return weightScale; }
+
+  //! Get the scale of the quantized input.
+  double InputScale() const { return inputScale; }
+
+  //! Get the bias of the layer.
+  OutputDataType const& Bias() const { return bias; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the input size.
+  size_t InputSize() const { return inSize; }
+
+  //! Get the output size.
+  size_t OutputSize() const { return outSize; }
+
+  //! Get the shape of the input.
+  size_t InputShape() const
+  {
+    return inSize;
+  }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Round the given value to the nearest 8-bit integer in [-127, 127].
+  static int8_t Quantize(const double value)
+  {
+    return (int8_t) std::max(-127.0, std::min(127.0, std::round(value)));
+  }
+
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of output units.
+  size_t outSize;
+
+  //! Locally-stored scale of the quantized input.
+  double inputScale;
+
+  //! Locally-stored quantized weights, stored row by row so that the weights
+  //! of an output unit are contiguous.
+  std::vector<int8_t> weights;
+
+  //! Locally-stored scale of the quantized weights of each output unit.
+  OutputDataType weightScale;
+
+  //! Locally-stored bias term parameters.
+  OutputDataType bias;
+
+  //! Locally-stored quantized input.
+  std::vector<int8_t> quantizedInput;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class QuantizedLinear
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_linear_impl.hpp"
+
+#endif
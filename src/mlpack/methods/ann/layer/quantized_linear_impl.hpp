@@ -0,0 +1,160 @@
+/**
+ * @file methods/ann/layer/quantized_linear_impl.hpp
+ *
+ * Implementation of the QuantizedLinear layer class, a Linear layer with 8-bit
+ * integer weights for inference.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "quantized_linear.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+QuantizedLinear<InputDataType, OutputDataType>::QuantizedLinear() :
+    inSize(0),
+    outSize(0),
+    inputScale(1.0)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+QuantizedLinear<InputDataType, OutputDataType>::QuantizedLinear(
+    const OutputDataType& weight,
+    const OutputDataType& bias,
+    const double inputScale) :
+    inSize(weight.n_cols),
+    outSize(weight.n_rows),
+    inputScale(inputScale)
+{
+  if (inputScale <= 0.0)
+  {
+    Log::Fatal << "QuantizedLinear::QuantizedLinear(): the input scale must "
+        << "be positive!" << std::endl;
+  }
+
+  if (!bias.is_empty() && bias.n_elem != outSize)
+  {
+    Log::Fatal << "QuantizedLinear::QuantizedLinear(): the bias has "
+        << bias.n_elem << " elements, but the layer has " << outSize
+        << " output units!" << std::endl;
+  }
+
+  if (bias.is_empty())
+    this->bias.zeros(outSize, 1);
+  else
+    this->bias = arma::vectorise(bias);
+
+  // Map the largest absolute weight of each output unit to 127.
+  weightScale.set_size(outSize, 1);
+  weights.resize(outSize * inSize);
+  for (size_t i = 0; i < outSize; ++i)
+  {
+    const double maxWeight = (inSize == 0) ? 0.0 :
+        (double) arma::abs(weight.row(i)).max();
+    weightScale(i) = (maxWeight > 0.0) ? maxWeight / 127.0 : 1.0;
+
+    for (size_t k = 0; k < inSize; ++k)
+      weights[i * inSize + k] = Quantize(weight(i, k) / weightScale(i));
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename RegularizerType>
+QuantizedLinear<InputDataType, OutputDataType>::QuantizedLinear(
+    const Linear<InputDataType, OutputDataType, RegularizerType>& layer,
+    const double inputScale) :
+    QuantizedLinear(layer.Weight(), layer.Bias(), inputScale)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename RegularizerType>
+QuantizedLinear<InputDataType, OutputDataType>::QuantizedLinear(
+    const LinearNoBias<InputDataType, OutputDataType, RegularizerType>& layer,
+    const double inputScale) :
+    QuantizedLinear(arma::reshape(layer.Parameters(), layer.OutputSize(),
+        layer.InputSize()), OutputDataType(), inputScale)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedLinear<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  const double inverseScale = 1.0 / inputScale;
+  quantizedInput.resize(input.n_elem);
+  for (size_t i = 0; i < input.n_elem; ++i)
+    quantizedInput[i] = Quantize(input[i] * inverseScale);
+
+  output.set_size(outSize, input.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) input.n_cols; ++j)
+  {
+    const int8_t* x = quantizedInput.data() + j * inSize;
+    eT* y = output.colptr(j);
+    for (size_t i = 0; i < outSize; ++i)
+    {
+      // The products of the 8-bit values are summed in 32-bit integers.  The
+      // loop is simple enough for the compiler to use the integer
+      // multiply-add instructions of the CPU.
+      const int8_t* w = weights.data() + i * inSize;
+      int32_t sum = 0;
+      for (size_t k = 0; k < inSize; ++k)
+        sum += (int32_t) w[k] * (int32_t) x[k];
+
+      y[i] = sum * (inputScale * weightScale(i)) + bias(i);
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedLinear<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+{
+  g = DequantizedWeight().t() * gy;
+}
+
+template<typename InputDataType, typename OutputDataType>
+OutputDataType
+QuantizedLinear<InputDataType, OutputDataType>::DequantizedWeight() const
+{
+  OutputDataType weight(outSize, inSize);
+  for (size_t k = 0; k < inSize; ++k)
+    for (size_t i = 0; i < outSize; ++i)
+      weight(i, k) = weights[i * inSize + k] * weightScale(i);
+
+  return weight;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void QuantizedLinear<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(inSize));
+  ar(CEREAL_NVP(outSize));
+  ar(CEREAL_NVP(inputScale));
+  ar(CEREAL_NVP(weights));
+  ar(CEREAL_NVP(weightScale));
+  ar(CEREAL_NVP(bias));
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
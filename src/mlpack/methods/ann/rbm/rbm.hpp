@@ -300,7 +300,12 @@ class RBM
   SampleSlab(InputType& slabMean, DataType& slab);
 
   /**
-   * This function does the k-step Gibbs Sampling.
+   * This function does the k-step Gibbs Sampling.  The binary RBM runs one
+   * chain for every column of the input, and samples all chains at once with
+   * block Gibbs steps; if Threads() is greater than one, the chains are split
+   * across that many threads.  The spike and slab RBM pools the input into a
+   * single chain.  With persistence, the chains continue from the samples of
+   * the previous call instead of the input.
    *
    * @param input Input to the Gibbs function.
    * @param output Used for storing the negative sample.
@@ -335,6 +340,16 @@ class RBM
   //! Return the number of steps of Gibbs Sampling.
   size_t NumSteps() const { return numSteps; }
 
+  /**
+   * Get the number of threads that share the chains of the Gibbs sampling.
+   * Each part of the chains is sampled with a random seed drawn from the
+   * mlpack random number generator, so that the samples don't depend on the
+   * scheduling of the threads.  Defaults to 1.
+   */
+  size_t Threads() const { return threads; }
+  //! Modify the number of threads that share the chains of the Gibbs sampling.
+  size_t& Threads() { return threads; }
+
   //! Return the parameters of the network.
   const arma::Mat<ElemType>& Parameters() const { return parameter; }
   //! Modify the parameters of the network.
@@ -440,8 +455,10 @@ class RBM
   arma::Mat<ElemType> tempNegativeGradient;
   //! Locally-stored gradient for positive phase.
   arma::Mat<ElemType> positiveGradient;
-  //! Locally-stored temporary output of Gibbs chain.
-  arma::Mat<ElemType> gibbsTemporary;
+  //! Locally-stored hidden samples of the Gibbs chains, one for each thread.
+  std::vector<arma::Mat<ElemType>> gibbsTemporary;
+  //! Locally-stored number of threads that share the Gibbs chains.
+  size_t threads;
   //! Locally-stored persistent CD-k boolean flag.
   bool persistence;
   //! Locally-stored reset variable.
@@ -47,6 +47,7 @@ RBM<InitializationRuleType, DataType, PolicyType>::RBM(
     steps(0),
     slabPenalty(slabPenalty),
     radius(2 * radius),
+    threads(1),
     persistence(persistence),
     reset(false)
 {
@@ -168,11 +169,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleHidden(
     arma::Mat<ElemType>& output)
 {
   HiddenMean(input, output);
-
-  for (size_t i = 0; i < output.n_elem; ++i)
-  {
-    output(i) = math::RandBernoulli(output(i));
-  }
+  output = arma::conv_to<arma::Mat<ElemType>>::from(
+      arma::randu<arma::Mat<ElemType>>(output.n_rows, output.n_cols) < output);
 }
 
 template<
@@ -187,11 +185,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleVisible(
     arma::Mat<ElemType>& output)
 {
   VisibleMean(input, output);
-
-  for (size_t i = 0; i < output.n_elem; ++i)
-  {
-    output(i) = math::RandBernoulli(output(i));
-  }
+  output = arma::conv_to<arma::Mat<ElemType>>::from(
+      arma::randu<arma::Mat<ElemType>>(output.n_rows, output.n_cols) < output);
 }
 
 template<
@@ -238,25 +233,65 @@ void RBM<InitializationRuleType, DataType, PolicyType>::Gibbs(
 {
   this->steps = (steps == SIZE_MAX) ? this->numSteps : steps;
 
-  if (persistence && !state.is_empty())
-  {
-    SampleHidden(state, gibbsTemporary);
-    SampleVisible(gibbsTemporary, output);
-  }
-  else
-  {
-    SampleHidden(input, gibbsTemporary);
-    SampleVisible(gibbsTemporary, output);
-  }
+  // The spike and slab RBM pools the whole input into one chain.
+  const size_t chains = std::is_same<PolicyType, BinaryRBM>::value ?
+      input.n_cols : 1;
+
+  // Continue the persistent chains; the batch may hold more points than the
+  // previous one, and the chains of the extra points start from the input.
+  const bool continueChains = persistence && !state.is_empty();
+  if (continueChains && state.n_cols < chains)
+    state.insert_cols(state.n_cols, input.cols(state.n_cols, chains - 1));
+
+  const arma::Mat<ElemType>& start = continueChains ? state : input;
+  const size_t startCols = continueChains ? chains : input.n_cols;
+
+  // Split the chains into parts of (nearly) the same size.
+  const size_t parts = std::max(size_t(1), std::min(threads, chains));
+  std::vector<size_t> bounds(parts + 1);
+  for (size_t t = 0; t < parts; ++t)
+    bounds[t] = t * chains / parts;
+  bounds[parts] = chains;
+  const math::ParallelSeeds seeds(parts);
 
-  for (size_t j = 1; j < this->steps; ++j)
+  if (gibbsTemporary.size() < parts)
+    gibbsTemporary.resize(parts);
+
+  output.set_size(visibleSize, chains);
+
+  // A single part is sampled with the generator of this thread.
+  #pragma omp parallel for if (parts > 1)
+  for (omp_size_t t = 0; t < (omp_size_t) parts; ++t)
   {
-    SampleHidden(output, gibbsTemporary);
-    SampleVisible(gibbsTemporary, output);
+    seeds.Seed(t);
+
+    // Wrap matrices around the chains of the part to avoid copies.
+    const size_t begin = bounds[t];
+    const size_t cols = (parts > 1) ? bounds[t + 1] - begin : startCols;
+    const arma::Mat<ElemType> partStart(const_cast<ElemType*>(
+        start.colptr(begin)), start.n_rows, cols, false, true);
+    arma::Mat<ElemType> partOutput(output.colptr(begin), visibleSize,
+        bounds[t + 1] - begin, false, true);
+    arma::Mat<ElemType>& hidden = gibbsTemporary[t];
+
+    SampleHidden(partStart, hidden);
+    SampleVisible(hidden, partOutput);
+
+    for (size_t j = 1; j < this->steps; ++j)
+    {
+      SampleHidden(partOutput, hidden);
+      SampleVisible(hidden, partOutput);
+    }
   }
+
+  seeds.Reseed();
+
   if (persistence)
   {
-    state = output;
+    if (continueChains)
+      state.cols(0, chains - 1) = output;
+    else
+      state = output;
   }
 }
 
@@ -277,7 +312,7 @@ void RBM<InitializationRuleType, DataType, PolicyType>::Gradient(
   Phase(predictors.cols(i, i + batchSize - 1),
       positiveGradient);
 
-  for (size_t i = 0; i < negSteps; ++i)
+  for (size_t j = 0; j < negSteps; ++j)
   {
     Gibbs(predictors.cols(i, i + batchSize - 1),
         negativeSamples);
@@ -75,12 +75,17 @@ RBM<InitializationRuleType, DataType, PolicyType>::FreeEnergy(
   freeEnergy -= 0.5 * hiddenSize * poolSize *
       std::log((2.0 * M_PI) / slabPenalty);
 
+  // The slices of the weight cube are the consecutive column blocks of a
+  // (visibleSize x poolSize * hiddenSize) matrix, so that all hidden units
+  // are projected at once.
+  const arma::Mat<ElemType> weights(const_cast<ElemType*>(weight.memptr()),
+      visibleSize, poolSize * hiddenSize, false, true);
+  const arma::Mat<ElemType> sums = arma::sum(arma::reshape(arma::sum(
+      arma::square(input.t() * weights)), poolSize, hiddenSize)) /
+      (2.0 * slabPenalty);
+
   for (size_t i = 0; i < hiddenSize; ++i)
-  {
-    ElemType sum = arma::accu(arma::square(input.t() * weight.slice(i))) /
-        (2.0 * slabPenalty);
-    freeEnergy -= SoftplusFunction::Fn(spikeBias(i) - sum);
-  }
+    freeEnergy -= SoftplusFunction::Fn(spikeBias(i) - sums(i));
 
   return freeEnergy;
 }
@@ -96,8 +101,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::Phase(
     const InputType& input,
     DataType& gradient)
 {
-  arma::Cube<ElemType> weightGrad = arma::Cube<ElemType>
-      (gradient.memptr(), visibleSize, poolSize, hiddenSize, false, false);
+  arma::Mat<ElemType> weightGrad(gradient.memptr(), visibleSize,
+      poolSize * hiddenSize, false, true);
 
   DataType spikeBiasGrad = DataType(gradient.memptr() + weightGrad.n_elem,
       hiddenSize, 1, false, false);
@@ -106,11 +111,11 @@ RBM<InitializationRuleType, DataType, PolicyType>::Phase(
   SampleSpike(spikeMean, spikeSamples);
   SlabMean(input, spikeSamples, slabMean);
 
-  for (size_t i = 0 ; i < hiddenSize; ++i)
-  {
-    weightGrad.slice(i) = input * arma::repmat(slabMean.col(i).t(),
-        input.n_cols, 1) * spikeMean(i);
-  }
+  // Every slice of the weight gradient is the outer product of the sum of the
+  // inputs with the slab mean of the hidden unit, scaled by its spike mean.
+  arma::Mat<ElemType> hidden = slabMean;
+  hidden.each_row() %= spikeMean.t();
+  weightGrad = arma::sum(input, 1) * arma::vectorise(hidden).t();
 
   spikeBiasGrad = spikeMean;
   // Setting visiblePenaltyGrad.
@@ -160,10 +165,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleVisible(
 
   for (k = 0; k < numMaxTrials; ++k)
   {
-    for (size_t i = 0; i < visibleSize; ++i)
-    {
-      output(i) = math::RandNormal(visibleMean(i), 1.0 / visiblePenalty(0));
-    }
+    output = visibleMean + (1.0 / visiblePenalty(0)) *
+        arma::randn<arma::Mat<ElemType>>(visibleSize, 1);
     if (arma::norm(output, 2) < radius)
     {
       break;
@@ -190,18 +193,16 @@ RBM<InitializationRuleType, DataType, PolicyType>::VisibleMean(
     InputType& input,
     DataType& output)
 {
-  output.zeros(visibleSize, 1);
-
   DataType spike(input.memptr(), hiddenSize, 1, false, false);
   DataType slab(input.memptr() + hiddenSize, poolSize, hiddenSize, false,
       false);
 
-  for (size_t i = 0; i < hiddenSize; ++i)
-  {
-    output += weight.slice(i) * slab.col(i) * spike(i);
-  }
+  const arma::Mat<ElemType> weights(const_cast<ElemType*>(weight.memptr()),
+      visibleSize, poolSize * hiddenSize, false, true);
+  arma::Mat<ElemType> hidden = slab;
+  hidden.each_row() %= spike.t();
 
-  output = ((1.0 / visiblePenalty(0)) * output);
+  output = (1.0 / visiblePenalty(0)) * (weights * arma::vectorise(hidden));
 }
 
 template<
@@ -237,12 +238,16 @@ RBM<InitializationRuleType, DataType, PolicyType>::SpikeMean(
     const InputType& visible,
     DataType& spikeMean)
 {
-  for (size_t i = 0; i < hiddenSize; ++i)
-  {
-    spikeMean(i) = LogisticFunction::Fn(0.5 * (1.0 / slabPenalty) * arma::accu(
-        visible.t() * (weight.slice(i) * weight.slice(i).t()) * visible)
-        / std::pow(visible.n_cols, 2) + spikeBias(i));
-  }
+  // The sum of v_j^T W_i W_i^T v_k over all pairs of inputs is the squared
+  // norm of the projection of the sum of the inputs onto W_i.
+  const arma::Mat<ElemType> weights(const_cast<ElemType*>(weight.memptr()),
+      visibleSize, poolSize * hiddenSize, false, true);
+  const arma::Mat<ElemType> projection = weights.t() * arma::sum(visible, 1);
+
+  spikeMean = 0.5 * (1.0 / slabPenalty) * arma::sum(arma::reshape(
+      arma::square(projection), poolSize, hiddenSize)).t() /
+      std::pow(visible.n_cols, 2) + spikeBias;
+  LogisticFunction::Fn(spikeMean, spikeMean);
 }
 
 template<
@@ -256,10 +261,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleSpike(
     InputType& spikeMean,
     DataType& spike)
 {
-  for (size_t i = 0; i < hiddenSize; ++i)
-  {
-    spike(i) = math::RandBernoulli(spikeMean(i));
-  }
+  spike = arma::conv_to<arma::Mat<ElemType>>::from(
+      arma::randu<arma::Mat<ElemType>>(hiddenSize, 1) < spikeMean);
 }
 
 template<
@@ -274,11 +277,12 @@ RBM<InitializationRuleType, DataType, PolicyType>::SlabMean(
     DataType& spike,
     DataType& slabMean)
 {
-  for (size_t i = 0; i < hiddenSize; ++i)
-  {
-    slabMean.col(i) = arma::mean((1.0 / slabPenalty) * spike(i) *
-        weight.slice(i).t() * visible, 1);
-  }
+  const arma::Mat<ElemType> weights(const_cast<ElemType*>(weight.memptr()),
+      visibleSize, poolSize * hiddenSize, false, true);
+
+  slabMean = arma::reshape(weights.t() * arma::mean(visible, 1), poolSize,
+      hiddenSize) * (1.0 / slabPenalty);
+  slabMean.each_row() %= spike.t();
 }
 
 template<
@@ -292,13 +296,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleSlab(
     InputType& slabMean,
     DataType& slab)
 {
-  for (size_t i = 0; i < hiddenSize; ++i)
-  {
-    for (size_t j = 0; j < poolSize; ++j)
-    {
-      slab(j, i) = math::RandNormal(slabMean(j, i), 1.0 / slabPenalty);
-    }
-  }
+  slab = slabMean + (1.0 / slabPenalty) *
+      arma::randn<arma::Mat<ElemType>>(poolSize, hiddenSize);
 }
 
 } // namespace ann
@@ -20,6 +20,7 @@
 #include "visitor/reset_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "util/batch_prefetcher.hpp"
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
@@ -194,6 +195,10 @@ class RNN
    * So, e.g., predictors(i, j, k) is the i'th dimension of the j'th data point
    * at time slice k.  The responses will be in the same format.
    *
+   * The sequences are passed through the network in batches of batchSize
+   * points, and the state of the recurrent layers is reset at the start of
+   * each batch, so the predictions do not depend on the batch size.
+   *
    * @param predictors Input predictors.
    * @param results Matrix to put output predictions of responses into.
    * @param batchSize Number of points to predict at once.
@@ -303,6 +308,23 @@ class RNN
   //! Modify the maximum length of backpropagation through time.
   size_t& Rho() { return rho; }
 
+  /**
+   * Get the number of time steps whose layer outputs are held at once during
+   * backpropagation through time.  If 0 (the default), the outputs of every
+   * step are saved during the forward pass.  Otherwise, the steps are split
+   * into segments of the given length, and right before the backward pass of a
+   * segment its forward pass is computed again from the state that the
+   * recurrent cells kept for the step before it.  This costs one more forward
+   * pass, but only the outputs and the cell states of one segment are held in
+   * memory, along with the cell state at the start of every segment.  If a
+   * module of the network can't compute a step again (see RewindVisitor), the
+   * outputs of every step are saved.
+   */
+  size_t CheckpointInterval() const { return checkpointInterval; }
+  //! Modify the number of time steps whose layer outputs are held at once
+  //! during backpropagation through time.
+  size_t& CheckpointInterval() { return checkpointInterval; }
+
   //! Get the matrix of responses to the input data points.
   const arma::cube& Responses() const { return responses; }
   //! Modify the matrix of responses to the input data points.
@@ -369,6 +391,13 @@ class RNN
    */
   void ResetGradients(arma::mat& gradient);
 
+  /**
+   * Collect the output parameter and the delta of every layer, so that each
+   * step of the forward and backward passes dispatches on the layer type only
+   * once.
+   */
+  void ResetLayerGraph();
+
   //! Number of steps to backpropagate through time (BPTT).
   size_t rho;
 
@@ -394,15 +423,28 @@ class RNN
     //! Only predict the last element of the input sequence.
   bool single;
 
+  //! The number of time steps whose layer outputs are held at once during
+  //! BPTT; 0 holds the outputs of all steps.
+  size_t checkpointInterval;
+
   //! Locally-stored model modules.
   std::vector<LayerTypes<CustomLayers...> > network;
 
+  //! The output parameter of each layer in the network.
+  std::vector<arma::mat*> layerOutputs;
+
+  //! The delta of each layer in the network.
+  std::vector<arma::mat*> layerDeltas;
+
   //! The matrix of data points (predictors).
   arma::cube predictors;
 
   //! The matrix of responses to the input data points.
   arma::cube responses;
 
+  //! Gathers the batches of the data points after Shuffle().
+  BatchPrefetcher<arma::cube> batchPrefetcher;
+
   //! Matrix of (trained) parameters.
   arma::mat parameter;
 
@@ -20,6 +20,7 @@
 #include "visitor/forward_visitor.hpp"
 #include "visitor/backward_visitor.hpp"
 #include "visitor/reset_cell_visitor.hpp"
+#include "visitor/rewind_visitor.hpp"
 #include "visitor/deterministic_set_visitor.hpp"
 #include "visitor/gradient_set_visitor.hpp"
 #include "visitor/gradient_visitor.hpp"
@@ -45,6 +46,7 @@ RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
     targetSize(0),
     reset(false),
     single(single),
+    checkpointInterval(0),
     numFunctions(0),
     deterministic(true)
 {
@@ -63,6 +65,7 @@ RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
     targetSize(network.targetSize),
     reset(network.reset),
     single(network.single),
+    checkpointInterval(network.checkpointInterval),
     parameter(network.parameter),
     numFunctions(network.numFunctions),
     deterministic(network.deterministic)
@@ -87,7 +90,10 @@ RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
     targetSize(std::move(network.targetSize)),
     reset(std::move(network.reset)),
     single(std::move(network.single)),
+    checkpointInterval(std::move(network.checkpointInterval)),
     network(std::move(network.network)),
+    layerOutputs(std::move(network.layerOutputs)),
+    layerDeltas(std::move(network.layerDeltas)),
     parameter(std::move(network.parameter)),
     numFunctions(std::move(network.numFunctions)),
     deterministic(std::move(network.deterministic))
@@ -155,6 +161,7 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 
   numFunctions = responses.n_cols;
 
+  batchPrefetcher.Reset();
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
 
@@ -203,6 +210,7 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 
   numFunctions = responses.n_cols;
 
+  batchPrefetcher.Reset();
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
 
@@ -250,32 +258,38 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
     ResetDeterministic();
   }
 
-  const size_t effectiveBatchSize = std::min(batchSize,
-      size_t(predictors.n_cols));
-
-  Forward(arma::mat(predictors.slice(0).colptr(0), predictors.n_rows,
-      effectiveBatchSize, false, true));
-  arma::mat resultsTemp = boost::apply_visitor(outputParameterVisitor,
-      network.back());
+  if (batchSize == 0)
+  {
+    Log::Fatal << "RNN<>::Predict(): batchSize must be greater than 0!"
+        << std::endl;
+  }
 
-  outputSize = resultsTemp.n_rows;
-  results = arma::zeros<arma::cube>(outputSize, predictors.n_cols, rho);
-  results.slice(0).submat(0, 0, results.n_rows - 1,
-      effectiveBatchSize - 1) = resultsTemp;
+  results.clear();
 
   // Process in accordance with the given batch size.
   for (size_t begin = 0; begin < predictors.n_cols; begin += batchSize)
   {
     const size_t effectiveBatchSize = std::min(batchSize,
         size_t(predictors.n_cols - begin));
-    for (size_t seqNum = !begin; seqNum < rho; ++seqNum)
+
+    // Each batch holds new sequences, so start from a clean state.
+    if (begin > 0)
+      ResetCells();
+
+    for (size_t seqNum = 0; seqNum < rho; ++seqNum)
     {
       Forward(arma::mat(predictors.slice(seqNum).colptr(begin),
           predictors.n_rows, effectiveBatchSize, false, true));
 
-      results.slice(seqNum).submat(0, begin, results.n_rows - 1, begin +
-          effectiveBatchSize - 1) = boost::apply_visitor(outputParameterVisitor,
-          network.back());
+      const arma::mat& output = *layerOutputs.back();
+      if (results.is_empty())
+      {
+        outputSize = output.n_rows;
+        results = arma::zeros<arma::cube>(outputSize, predictors.n_cols, rho);
+      }
+
+      results.slice(seqNum).cols(begin, begin + effectiveBatchSize - 1) =
+          output;
     }
   }
 }
@@ -309,6 +323,17 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     targetSize = responses.n_rows;
   }
 
+  // Use the batch gathered in the shuffled order, if Shuffle() was called.
+  const bool shuffled = batchPrefetcher.Shuffled();
+  if (shuffled)
+    batchPrefetcher.Fetch(predictors, responses, begin, batchSize);
+
+  arma::cube& predictorsData = shuffled ? batchPrefetcher.Predictors() :
+      predictors;
+  arma::cube& responsesData = shuffled ? batchPrefetcher.Responses() :
+      responses;
+  const size_t first = shuffled ? 0 : begin;
+
   ResetCells();
 
   double performance = 0;
@@ -317,7 +342,7 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
   for (size_t seqNum = 0; seqNum < rho; ++seqNum)
   {
     // Wrap a matrix around our data to avoid a copy.
-    arma::mat stepData(predictors.slice(seqNum).colptr(begin),
+    arma::mat stepData(predictorsData.slice(seqNum).colptr(first),
         predictors.n_rows, batchSize, false, true);
     Forward(stepData);
     if (!single)
@@ -325,16 +350,14 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
       responseSeq = seqNum;
     }
 
-    performance += outputLayer.Forward(boost::apply_visitor(
-        outputParameterVisitor, network.back()),
-        arma::mat(responses.slice(responseSeq).colptr(begin),
+    performance += outputLayer.Forward(*layerOutputs.back(),
+        arma::mat(responsesData.slice(responseSeq).colptr(first),
             responses.n_rows, batchSize, false, true));
   }
 
   if (outputSize == 0)
   {
-    outputSize = boost::apply_visitor(outputParameterVisitor,
-        network.back()).n_elem / batchSize;
+    outputSize = layerOutputs.back()->n_elem / batchSize;
   }
 
   return performance;
@@ -390,16 +413,55 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     targetSize = responses.n_rows;
   }
 
+  // Use the batch gathered in the shuffled order, if Shuffle() was called.
+  const bool shuffled = batchPrefetcher.Shuffled();
+  if (shuffled)
+    batchPrefetcher.Fetch(predictors, responses, begin, batchSize);
+
+  arma::cube& predictorsData = shuffled ? batchPrefetcher.Predictors() :
+      predictors;
+  arma::cube& responsesData = shuffled ? batchPrefetcher.Responses() :
+      responses;
+  const size_t first = shuffled ? 0 : begin;
+
+  // The steps can only be computed again if every module can go back to an
+  // earlier step; otherwise the cells hold the state of every step.
+  bool checkpointing = (checkpointInterval > 0);
+  for (size_t l = 0; l < network.size(); ++l)
+  {
+    if (!boost::apply_visitor(RewindVisitor(0, checkpointInterval),
+        network[l]))
+    {
+      checkpointing = false;
+    }
+  }
+
+  if (!checkpointing && checkpointInterval > 0)
+  {
+    for (size_t l = 0; l < network.size(); ++l)
+      boost::apply_visitor(RewindVisitor(0, 0), network[l]);
+  }
+
   ResetCells();
 
+  // Every segment draws its random numbers (e.g. the dropout masks) from a
+  // seed of its own, so that its forward pass can be repeated exactly.
+  std::vector<int> seeds;
+
   double performance = 0;
   size_t responseSeq = 0;
   const size_t effectiveRho = std::min(rho, size_t(responses.size()));
 
   for (size_t seqNum = 0; seqNum < effectiveRho; ++seqNum)
   {
+    if (checkpointing && seqNum % checkpointInterval == 0)
+    {
+      seeds.push_back(math::RandInt(std::numeric_limits<int>::max()));
+      arma::arma_rng::set_seed(seeds.back());
+    }
+
     // Wrap a matrix around our data to avoid a copy.
-    arma::mat stepData(predictors.slice(seqNum).colptr(begin),
+    arma::mat stepData(predictorsData.slice(seqNum).colptr(first),
         predictors.n_rows, batchSize, false, true);
     Forward(stepData);
     if (!single)
@@ -407,22 +469,20 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       responseSeq = seqNum;
     }
 
-    for (size_t l = 0; l < network.size(); ++l)
+    for (size_t l = 0; l < network.size() && !checkpointing; ++l)
     {
       boost::apply_visitor(SaveOutputParameterVisitor(moduleOutputParameter),
           network[l]);
     }
 
-    performance += outputLayer.Forward(boost::apply_visitor(
-        outputParameterVisitor, network.back()),
-        arma::mat(responses.slice(responseSeq).colptr(begin),
+    performance += outputLayer.Forward(*layerOutputs.back(),
+        arma::mat(responsesData.slice(responseSeq).colptr(first),
             responses.n_rows, batchSize, false, true));
   }
 
   if (outputSize == 0)
   {
-    outputSize = boost::apply_visitor(outputParameterVisitor,
-        network.back()).n_elem / batchSize;
+    outputSize = layerOutputs.back()->n_elem / batchSize;
   }
 
   // Initialize current/working gradient.
@@ -436,6 +496,31 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
   for (size_t seqNum = 0; seqNum < effectiveRho; ++seqNum)
   {
+    // Compute the outputs of the segment that ends with this step again.
+    if (checkpointing && moduleOutputParameter.empty())
+    {
+      const size_t last = effectiveRho - seqNum - 1;
+      const size_t segment = last / checkpointInterval;
+      for (size_t l = 0; l < network.size(); ++l)
+      {
+        boost::apply_visitor(RewindVisitor(segment * checkpointInterval,
+            checkpointInterval), network[l]);
+      }
+
+      arma::arma_rng::set_seed(seeds[segment]);
+      for (size_t step = segment * checkpointInterval; step <= last; ++step)
+      {
+        Forward(arma::mat(predictorsData.slice(step).colptr(first),
+            predictors.n_rows, batchSize, false, true));
+
+        for (size_t l = 0; l < network.size(); ++l)
+        {
+          boost::apply_visitor(SaveOutputParameterVisitor(
+              moduleOutputParameter), network[l]);
+        }
+      }
+    }
+
     currentGradient.zeros();
     for (size_t l = 0; l < network.size(); ++l)
     {
@@ -449,26 +534,28 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     }
     else if (single && seqNum == 0)
     {
-      outputLayer.Backward(boost::apply_visitor(
-          outputParameterVisitor, network.back()),
-          arma::mat(responses.slice(0).colptr(begin),
+      outputLayer.Backward(*layerOutputs.back(),
+          arma::mat(responsesData.slice(0).colptr(first),
           responses.n_rows, batchSize, false, true), error);
     }
     else
     {
-      outputLayer.Backward(boost::apply_visitor(
-          outputParameterVisitor, network.back()),
-          arma::mat(responses.slice(effectiveRho - seqNum - 1).colptr(begin),
-          responses.n_rows, batchSize, false, true), error);
+      outputLayer.Backward(*layerOutputs.back(),
+          arma::mat(responsesData.slice(effectiveRho - seqNum - 1).colptr(
+          first), responses.n_rows, batchSize, false, true), error);
     }
 
     Backward();
     Gradient(
-        arma::mat(predictors.slice(effectiveRho - seqNum - 1).colptr(begin),
+        arma::mat(predictorsData.slice(effectiveRho - seqNum - 1).colptr(first),
         predictors.n_rows, batchSize, false, true));
     gradient += currentGradient;
   }
 
+  // Don't let the next batch draw the random numbers of the first segment.
+  if (checkpointing)
+    arma::arma_rng::set_seed(math::RandInt(std::numeric_limits<int>::max()));
+
   return performance;
 }
 
@@ -487,11 +574,7 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Shuffle()
 {
-  arma::cube newPredictors, newResponses;
-  math::ShuffleData(predictors, responses, newPredictors, newResponses);
-
-  predictors = std::move(newPredictors);
-  responses = std::move(newResponses);
+  batchPrefetcher.Shuffle(predictors.n_cols);
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -506,6 +589,9 @@ void RNN<OutputLayerType, InitializationRuleType,
                         CustomLayers...> networkInit(initializeRule);
   networkInit.Initialize(network, parameter);
 
+  // The structure of the network may have changed.
+  layerOutputs.clear();
+
   reset = true;
 }
 
@@ -542,22 +628,37 @@ void RNN<OutputLayerType, InitializationRuleType,
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ResetLayerGraph()
+{
+  layerOutputs.resize(network.size());
+  layerDeltas.resize(network.size());
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    layerOutputs[i] = &boost::apply_visitor(outputParameterVisitor,
+        network[i]);
+    layerDeltas[i] = &boost::apply_visitor(deltaVisitor, network[i]);
+  }
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename InputType>
 void RNN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Forward(const InputType& input)
 {
-  boost::apply_visitor(ForwardVisitor(input,
-      boost::apply_visitor(outputParameterVisitor, network.front())),
+  if (layerOutputs.size() != network.size())
+    ResetLayerGraph();
+
+  boost::apply_visitor(ForwardVisitor(input, *layerOutputs.front()),
       network.front());
 
   for (size_t i = 1; i < network.size(); ++i)
   {
-    boost::apply_visitor(ForwardVisitor(
-        boost::apply_visitor(outputParameterVisitor, network[i - 1]),
-        boost::apply_visitor(outputParameterVisitor, network[i])),
-        network[i]);
+    boost::apply_visitor(ForwardVisitor(*layerOutputs[i - 1],
+        *layerOutputs[i]), network[i]);
   }
 }
 
@@ -565,19 +666,14 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward()
 {
-  boost::apply_visitor(BackwardVisitor(
-        boost::apply_visitor(outputParameterVisitor, network.back()),
-        error, boost::apply_visitor(deltaVisitor,
-        network.back())), network.back());
+  boost::apply_visitor(BackwardVisitor(*layerOutputs.back(), error,
+      *layerDeltas.back()), network.back());
 
   for (size_t i = 2; i < network.size(); ++i)
   {
-    boost::apply_visitor(BackwardVisitor(
-        boost::apply_visitor(outputParameterVisitor,
-        network[network.size() - i]), boost::apply_visitor(
-        deltaVisitor, network[network.size() - i + 1]),
-        boost::apply_visitor(deltaVisitor, network[network.size() - i])),
-        network[network.size() - i]);
+    const size_t l = network.size() - i;
+    boost::apply_visitor(BackwardVisitor(*layerOutputs[l],
+        *layerDeltas[l + 1], *layerDeltas[l]), network[l]);
   }
 }
 
@@ -587,15 +683,13 @@ template<typename InputType>
 void RNN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Gradient(const InputType& input)
 {
-  boost::apply_visitor(GradientVisitor(input,
-      boost::apply_visitor(deltaVisitor, network[1])), network.front());
+  boost::apply_visitor(GradientVisitor(input, *layerDeltas[1]),
+      network.front());
 
   for (size_t i = 1; i < network.size() - 1; ++i)
   {
-    boost::apply_visitor(GradientVisitor(
-        boost::apply_visitor(outputParameterVisitor, network[i - 1]),
-        boost::apply_visitor(deltaVisitor, network[i + 1])),
-        network[i]);
+    boost::apply_visitor(GradientVisitor(*layerOutputs[i - 1],
+        *layerDeltas[i + 1]), network[i]);
   }
 }
 
@@ -618,6 +712,7 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
     std::for_each(network.begin(), network.end(),
         boost::apply_visitor(deleteVisitor));
     network.clear();
+    layerOutputs.clear();
   }
 
   ar(CEREAL_VECTOR_VARIANT_POINTER(network));
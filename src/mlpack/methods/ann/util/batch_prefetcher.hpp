@@ -0,0 +1,131 @@
+/**
+ * @file methods/ann/util/batch_prefetcher.hpp
+ *
+ * Definition of the BatchPrefetcher class, which gathers the mini-batches of a
+ * shuffled dataset in the background.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_UTIL_BATCH_PREFETCHER_HPP
+#define MLPACK_METHODS_ANN_UTIL_BATCH_PREFETCHER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <future>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The BatchPrefetcher visits the points of a dataset in a random order without
+ * moving the dataset itself: Shuffle() only draws a new permutation of the
+ * point indices, and Fetch() gathers the points of a mini-batch into a
+ * contiguous matrix.  Since optimizers usually visit the batches one after
+ * the other, Fetch() then starts to gather the next batch into a second
+ * buffer on a background thread, so that it is ready when it is requested
+ * while the current batch is being used.
+ *
+ * The points are the columns of a matrix, or the columns of every slice of a
+ * cube (as used for sequences).  The data passed to Fetch() must not change
+ * while a batch is being gathered, that is until the next call to Fetch(),
+ * Shuffle() or Reset().
+ *
+ * @tparam MatType Type of the data (arma::mat or arma::cube).
+ */
+template<typename MatType = arma::mat>
+class BatchPrefetcher
+{
+ public:
+  //! Create the BatchPrefetcher object; the points are visited in order.
+  BatchPrefetcher();
+
+  //! Wait for the batch that is being gathered.
+  ~BatchPrefetcher();
+
+  /**
+   * Draw a new random order of the points.
+   *
+   * @param points Number of points of the dataset.
+   */
+  void Shuffle(const size_t points);
+
+  //! Visit the points in order again, for example because the data changed.
+  void Reset();
+
+  //! Check whether the points are visited in a random order.
+  bool Shuffled() const { return !order.is_empty(); }
+
+  /**
+   * Gather the given batch of the shuffled points, and start to gather the
+   * batch that follows it in the background.
+   *
+   * @param predictors Input data of all points.
+   * @param responses Responses of all points.
+   * @param begin Position of the first point of the batch in the random order.
+   * @param batchSize Number of points of the batch.
+   */
+  void Fetch(const MatType& predictors,
+             const MatType& responses,
+             const size_t begin,
+             const size_t batchSize);
+
+  //! Get the input data of the fetched batch.
+  MatType& Predictors() { return predictorsBatch[current]; }
+
+  //! Get the responses of the fetched batch.
+  MatType& Responses() { return responsesBatch[current]; }
+
+ private:
+  //! Gather the given points of a matrix.
+  template<typename eT>
+  static void Gather(const arma::Mat<eT>& data,
+                     const arma::uvec& indices,
+                     arma::Mat<eT>& batch);
+
+  //! Gather the given points of each slice of a cube.
+  template<typename eT>
+  static void Gather(const arma::Cube<eT>& data,
+                     const arma::uvec& indices,
+                     arma::Cube<eT>& batch);
+
+  //! Gather the given batch of the shuffled points into the given buffer.
+  void Gather(const MatType& predictors,
+              const MatType& responses,
+              const size_t begin,
+              const size_t batchSize,
+              const size_t buffer);
+
+  //! Wait for the batch that is being gathered, if there is one.
+  void Wait();
+
+  //! The order in which the points are visited; empty if not shuffled.
+  arma::uvec order;
+
+  //! The buffers for the input data of the batches.
+  MatType predictorsBatch[2];
+
+  //! The buffers for the responses of the batches.
+  MatType responsesBatch[2];
+
+  //! The buffer that holds the fetched batch.
+  size_t current;
+
+  //! The position of the first point of the batch being gathered.
+  size_t pendingBegin;
+
+  //! The number of points of the batch being gathered.
+  size_t pendingSize;
+
+  //! The task that gathers the next batch.
+  std::future<void> pending;
+}; // class BatchPrefetcher
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "batch_prefetcher_impl.hpp"
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * @file methods/ann/util/batch_prefetcher_impl.hpp
+ *
+ * Implementation of the BatchPrefetcher class, which gathers the mini-batches
+ * of a shuffled dataset in the background.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_UTIL_BATCH_PREFETCHER_IMPL_HPP
+#define MLPACK_METHODS_ANN_UTIL_BATCH_PREFETCHER_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "batch_prefetcher.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename MatType>
+BatchPrefetcher<MatType>::BatchPrefetcher() :
+    current(0),
+    pendingBegin(0),
+    pendingSize(0)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+BatchPrefetcher<MatType>::~BatchPrefetcher()
+{
+  Wait();
+}
+
+template<typename MatType>
+void BatchPrefetcher<MatType>::Shuffle(const size_t points)
+{
+  Wait();
+  if (points == 0)
+    order.clear();
+  else
+    order = arma::shuffle(arma::linspace<arma::uvec>(0, points - 1, points));
+}
+
+template<typename MatType>
+void BatchPrefetcher<MatType>::Reset()
+{
+  Wait();
+  order.clear();
+  for (size_t i = 0; i < 2; ++i)
+  {
+    predictorsBatch[i].clear();
+    responsesBatch[i].clear();
+  }
+}
+
+template<typename MatType>
+void BatchPrefetcher<MatType>::Fetch(const MatType& predictors,
+                                     const MatType& responses,
+                                     const size_t begin,
+                                     const size_t batchSize)
+{
+  const bool prefetched = pending.valid() && pendingBegin == begin &&
+      pendingSize == batchSize;
+  Wait();
+
+  if (prefetched)
+    current = 1 - current;
+  else
+    Gather(predictors, responses, begin, batchSize, current);
+
+  // Optimizers visit the batches one after the other, so the next batch is
+  // likely to start where this one ends.
+  const size_t next = begin + batchSize;
+  if (next < order.n_elem)
+  {
+    const size_t nextSize = std::min(batchSize, size_t(order.n_elem - next));
+    const size_t buffer = 1 - current;
+    pendingBegin = next;
+    pendingSize = nextSize;
+    pending = std::async(std::launch::async,
+        [this, &predictors, &responses, next, nextSize, buffer]()
+    {
+      Gather(predictors, responses, next, nextSize, buffer);
+    });
+  }
+}
+
+template<typename MatType>
+template<typename eT>
+void BatchPrefetcher<MatType>::Gather(const arma::Mat<eT>& data,
+                                      const arma::uvec& indices,
+                                      arma::Mat<eT>& batch)
+{
+  batch = data.cols(indices);
+}
+
+template<typename MatType>
+template<typename eT>
+void BatchPrefetcher<MatType>::Gather(const arma::Cube<eT>& data,
+                                      const arma::uvec& indices,
+                                      arma::Cube<eT>& batch)
+{
+  batch.set_size(data.n_rows, indices.n_elem, data.n_slices);
+  for (size_t s = 0; s < data.n_slices; ++s)
+    batch.slice(s) = data.slice(s).cols(indices);
+}
+
+template<typename MatType>
+void BatchPrefetcher<MatType>::Gather(const MatType& predictors,
+                                      const MatType& responses,
+                                      const size_t begin,
+                                      const size_t batchSize,
+                                      const size_t buffer)
+{
+  const arma::uvec indices = order.subvec(begin, begin + batchSize - 1);
+  Gather(predictors, indices, predictorsBatch[buffer]);
+  Gather(responses, indices, responsesBatch[buffer]);
+}
+
+template<typename MatType>
+void BatchPrefetcher<MatType>::Wait()
+{
+  if (pending.valid())
+    pending.get();
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
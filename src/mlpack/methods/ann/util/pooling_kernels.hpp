@@ -0,0 +1,282 @@
+/**
+ * @file methods/ann/util/pooling_kernels.hpp
+ *
+ * Definition of the PoolingKernels class, which implements the max, mean and
+ * Lp pooling operations shared by the pooling layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_UTIL_POOLING_KERNELS_HPP
+#define MLPACK_METHODS_ANN_UTIL_POOLING_KERNELS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The PoolingKernels class pools every slice of a cube with windows of the
+ * given size that are moved over the slice with the given stride; windows
+ * that reach over the border of the slice are cut off.  The slices are pooled
+ * in parallel, and the pooling of a slice works on one column of the output at
+ * a time: for every element of the windows, all windows of the column are
+ * updated in a single loop that the compiler can vectorize (over contiguous
+ * memory for a stride of one; the maximum is taken with selects instead of
+ * branches), instead of extracting the windows one by one.
+ *
+ * The output cube has to be of the size of the pooled input; every element of
+ * it is overwritten.
+ */
+class PoolingKernels
+{
+ public:
+  /**
+   * Take the maximum of every window, and store the position of the maximum
+   * within the slice (as column-major index).  If a window holds the maximum
+   * more than once, the first position in column-major order is stored.
+   *
+   * @param input Slices to pool.
+   * @param kernelWidth Width of the pooling window.
+   * @param kernelHeight Height of the pooling window.
+   * @param strideWidth Stride of the window along the rows.
+   * @param strideHeight Stride of the window along the columns.
+   * @param output The maxima of the windows.
+   * @param indices The positions of the maxima, one column for every slice;
+   *     if NULL, the positions are not computed.
+   */
+  template<typename eT>
+  static void MaxPooling(const arma::Cube<eT>& input,
+                         const size_t kernelWidth,
+                         const size_t kernelHeight,
+                         const size_t strideWidth,
+                         const size_t strideHeight,
+                         arma::Cube<eT>& output,
+                         arma::Mat<arma::u32>* indices = NULL)
+  {
+    if (indices)
+    {
+      indices->set_size(output.n_rows * output.n_cols, output.n_slices);
+      MaxWindows<true>(input, kernelWidth, kernelHeight, strideWidth,
+          strideHeight, output, *indices);
+    }
+    else
+    {
+      arma::Mat<arma::u32> unused;
+      MaxWindows<false>(input, kernelWidth, kernelHeight, strideWidth,
+          strideHeight, output, unused);
+    }
+  }
+
+  /**
+   * Route the error of every window to the position of its maximum, as stored
+   * by MaxPooling().
+   *
+   * @param error The error of the pooled output.
+   * @param indices The positions of the maxima.
+   * @param output The error of the input; has to be set to zero beforehand.
+   */
+  template<typename eT>
+  static void MaxUnpooling(const arma::Cube<eT>& error,
+                           const arma::Mat<arma::u32>& indices,
+                           arma::Cube<eT>& output)
+  {
+    const size_t points = error.n_rows * error.n_cols;
+
+    #pragma omp parallel for
+    for (omp_size_t s = 0; s < (omp_size_t) error.n_slices; ++s)
+    {
+      const eT* e = error.slice_memptr(s);
+      const arma::u32* index = indices.colptr(s);
+      eT* g = output.slice_memptr(s);
+      for (size_t i = 0; i < points; ++i)
+        g[index[i]] += e[i];
+    }
+  }
+
+  /**
+   * Take the mean of every window.
+   *
+   * @param input Slices to pool.
+   * @param kernelWidth Width of the pooling window.
+   * @param kernelHeight Height of the pooling window.
+   * @param strideWidth Stride of the window along the rows.
+   * @param strideHeight Stride of the window along the columns.
+   * @param output The means of the windows.
+   */
+  template<typename eT>
+  static void MeanPooling(const arma::Cube<eT>& input,
+                          const size_t kernelWidth,
+                          const size_t kernelHeight,
+                          const size_t strideWidth,
+                          const size_t strideHeight,
+                          arma::Cube<eT>& output)
+  {
+    SumPooling<false>(input, 1, kernelWidth, kernelHeight, strideWidth,
+        strideHeight, output);
+  }
+
+  /**
+   * Take the Lp norm of every window, that is the p-th root of the sum of the
+   * p-th powers of its elements.
+   *
+   * @param input Slices to pool.
+   * @param normType The power p.
+   * @param kernelWidth Width of the pooling window.
+   * @param kernelHeight Height of the pooling window.
+   * @param strideWidth Stride of the window along the rows.
+   * @param strideHeight Stride of the window along the columns.
+   * @param output The norms of the windows.
+   */
+  template<typename eT>
+  static void LpPooling(const arma::Cube<eT>& input,
+                        const size_t normType,
+                        const size_t kernelWidth,
+                        const size_t kernelHeight,
+                        const size_t strideWidth,
+                        const size_t strideHeight,
+                        arma::Cube<eT>& output)
+  {
+    SumPooling<true>(input, normType, kernelWidth, kernelHeight, strideWidth,
+        strideHeight, output);
+  }
+
+ private:
+  //! Return the part of a window that starts at the given position and lies
+  //! within a dimension of the given size.
+  static size_t Cut(const size_t kernel, const size_t begin, const size_t size)
+  {
+    return (begin < size) ? std::min(kernel, size - begin) : 0;
+  }
+
+  //! Return the number of windows (of a total of outputSize) that still hold
+  //! the given row of the window within a dimension of the given size.
+  static size_t Windows(const size_t row,
+                        const size_t stride,
+                        const size_t size,
+                        const size_t outputSize)
+  {
+    return (row < size) ?
+        std::min(outputSize, (size - row + stride - 1) / stride) : 0;
+  }
+
+  /**
+   * Take the maximum of every window, and store the position of the maximum
+   * only if StoreIndices is true.
+   */
+  template<bool StoreIndices, typename eT>
+  static void MaxWindows(const arma::Cube<eT>& input,
+                         const size_t kernelWidth,
+                         const size_t kernelHeight,
+                         const size_t strideWidth,
+                         const size_t strideHeight,
+                         arma::Cube<eT>& output,
+                         arma::Mat<arma::u32>& indices)
+  {
+    #pragma omp parallel for
+    for (omp_size_t s = 0; s < (omp_size_t) output.n_slices; ++s)
+    {
+      const eT* slice = input.slice_memptr(s);
+      for (size_t j = 0; j < output.n_cols; ++j)
+      {
+        eT* out = output.slice_colptr(s, j);
+        std::fill(out, out + output.n_rows, std::numeric_limits<eT>::lowest());
+
+        arma::u32* index = NULL;
+        if (StoreIndices)
+        {
+          index = indices.colptr(s) + j * output.n_rows;
+          std::fill(index, index + output.n_rows, 0);
+        }
+
+        const size_t col = j * strideHeight;
+        const size_t cols = Cut(kernelHeight, col, input.n_cols);
+        for (size_t c = 0; c < cols; ++c)
+        {
+          const eT* column = slice + (col + c) * input.n_rows;
+          for (size_t r = 0; r < kernelWidth; ++r)
+          {
+            const size_t windows = Windows(r, strideWidth, input.n_rows,
+                output.n_rows);
+            const arma::u32 first = (arma::u32) (r + (col + c) * input.n_rows);
+            for (size_t i = 0; i < windows; ++i)
+            {
+              const eT value = column[i * strideWidth + r];
+              const bool greater = (value > out[i]);
+              out[i] = greater ? value : out[i];
+              if (StoreIndices)
+              {
+                index[i] = greater ? first + (arma::u32) (i * strideWidth) :
+                    index[i];
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Sum the elements (or their powers) of every window, and return the mean
+   * (or the root of the sum).
+   */
+  template<bool Power, typename eT>
+  static void SumPooling(const arma::Cube<eT>& input,
+                         const size_t power,
+                         const size_t kernelWidth,
+                         const size_t kernelHeight,
+                         const size_t strideWidth,
+                         const size_t strideHeight,
+                         arma::Cube<eT>& output)
+  {
+    const eT exponent = (eT) power;
+
+    #pragma omp parallel for
+    for (omp_size_t s = 0; s < (omp_size_t) output.n_slices; ++s)
+    {
+      const eT* slice = input.slice_memptr(s);
+      for (size_t j = 0; j < output.n_cols; ++j)
+      {
+        eT* out = output.slice_colptr(s, j);
+        std::fill(out, out + output.n_rows, eT(0));
+
+        const size_t col = j * strideHeight;
+        const size_t cols = Cut(kernelHeight, col, input.n_cols);
+        for (size_t c = 0; c < cols; ++c)
+        {
+          const eT* column = slice + (col + c) * input.n_rows;
+          for (size_t r = 0; r < kernelWidth; ++r)
+          {
+            const size_t windows = Windows(r, strideWidth, input.n_rows,
+                output.n_rows);
+            for (size_t i = 0; i < windows; ++i)
+            {
+              const eT value = column[i * strideWidth + r];
+              out[i] += Power ? std::pow(value, exponent) : value;
+            }
+          }
+        }
+
+        for (size_t i = 0; i < output.n_rows; ++i)
+        {
+          if (Power)
+          {
+            out[i] = std::pow(out[i], 1.0 / power);
+          }
+          else
+          {
+            out[i] /= (eT) (cols * Cut(kernelWidth, i * strideWidth,
+                input.n_rows));
+          }
+        }
+      }
+    }
+  }
+}; // class PoolingKernels
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,82 @@
+/**
+ * @file methods/ann/visitor/regularize_set_visitor.hpp
+ *
+ * This file provides an abstraction for the Regularize() function for
+ * different layers and automatically directs any parameter to the right layer
+ * type.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_REGULARIZE_SET_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_REGULARIZE_SET_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * RegularizeSetVisitor sets whether the layers add the penalty of their
+ * regularizer to the gradient.
+ */
+class RegularizeSetVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Set the regularize parameter given the regularize value.
+  RegularizeSetVisitor(const bool regularize = true);
+
+  //! Set the regularize parameter.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+  void operator()(MoreTypes layer) const;
+
+ private:
+  //! The regularize parameter.
+  const bool regularize;
+
+  //! Set the regularize parameter if the module implements the
+  //! Regularize() and Model() function.
+  template<typename T>
+  typename std::enable_if<
+      HasRegularizeCheck<T, bool&(T::*)(void)>::value &&
+      HasModelCheck<T>::value, void>::type
+  LayerRegularize(T* layer) const;
+
+  //! Set the regularize parameter if the module implements the
+  //! Model() function.
+  template<typename T>
+  typename std::enable_if<
+      !HasRegularizeCheck<T, bool&(T::*)(void)>::value &&
+      HasModelCheck<T>::value, void>::type
+  LayerRegularize(T* layer) const;
+
+  //! Set the regularize parameter if the module implements the
+  //! Regularize() function.
+  template<typename T>
+  typename std::enable_if<
+      HasRegularizeCheck<T, bool&(T::*)(void)>::value &&
+      !HasModelCheck<T>::value, void>::type
+  LayerRegularize(T* layer) const;
+
+  //! Do not set the regularize parameter if the module doesn't implement the
+  //! Regularize() or Model() function.
+  template<typename T>
+  typename std::enable_if<
+      !HasRegularizeCheck<T, bool&(T::*)(void)>::value &&
+      !HasModelCheck<T>::value, void>::type
+  LayerRegularize(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "regularize_set_visitor_impl.hpp"
+
+#endif
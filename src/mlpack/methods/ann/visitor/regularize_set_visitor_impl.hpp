@@ -0,0 +1,87 @@
+/**
+ * @file methods/ann/visitor/regularize_set_visitor_impl.hpp
+ *
+ * Implementation of the Regularize() function layer abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_REGULARIZE_SET_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_REGULARIZE_SET_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "regularize_set_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! RegularizeSetVisitor visitor class.
+inline RegularizeSetVisitor::RegularizeSetVisitor(
+    const bool regularize) : regularize(regularize)
+{
+  /* Nothing to do here. */
+}
+
+template<typename LayerType>
+inline void RegularizeSetVisitor::operator()(LayerType* layer) const
+{
+  LayerRegularize(layer);
+}
+
+inline void RegularizeSetVisitor::operator()(MoreTypes layer) const
+{
+  layer.apply_visitor(*this);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasRegularizeCheck<T, bool&(T::*)(void)>::value &&
+    HasModelCheck<T>::value, void>::type
+RegularizeSetVisitor::LayerRegularize(T* layer) const
+{
+  layer->Regularize() = regularize;
+
+  for (size_t i = 0; i < layer->Model().size(); ++i)
+  {
+    boost::apply_visitor(RegularizeSetVisitor(regularize),
+        layer->Model()[i]);
+  }
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasRegularizeCheck<T, bool&(T::*)(void)>::value &&
+    HasModelCheck<T>::value, void>::type
+RegularizeSetVisitor::LayerRegularize(T* layer) const
+{
+  for (size_t i = 0; i < layer->Model().size(); ++i)
+  {
+    boost::apply_visitor(RegularizeSetVisitor(regularize),
+        layer->Model()[i]);
+  }
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasRegularizeCheck<T, bool&(T::*)(void)>::value &&
+    !HasModelCheck<T>::value, void>::type
+RegularizeSetVisitor::LayerRegularize(T* layer) const
+{
+  layer->Regularize() = regularize;
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasRegularizeCheck<T, bool&(T::*)(void)>::value &&
+    !HasModelCheck<T>::value, void>::type
+RegularizeSetVisitor::LayerRegularize(T* /* input */) const
+{
+  /* Nothing to do here. */
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
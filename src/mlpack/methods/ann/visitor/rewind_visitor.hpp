@@ -0,0 +1,88 @@
+/**
+ * @file methods/ann/visitor/rewind_visitor.hpp
+ *
+ * Boost static visitor abstraction for calling the Rewind() function on RNN
+ * cells.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_REWIND_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_REWIND_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * RewindVisitor sets the checkpoint interval of the cells and executes the
+ * Rewind() function, and returns whether the given module can compute the given
+ * time step again.  This is the case for modules
+ * that implement Rewind() and for modules without state between the time
+ * steps, but not for cells that implement ResetCell() only or for the
+ * Recurrent and RecurrentAttention modules.
+ */
+class RewindVisitor : public boost::static_visitor<bool>
+{
+ public:
+  //! Rewind the cells to the given time step, which is the first step of a
+  //! segment of the given number of steps.
+  RewindVisitor(const size_t step, const size_t interval);
+
+  //! Execute the Rewind() function.
+  template<typename LayerType>
+  bool operator()(LayerType* layer) const;
+
+  //! The Recurrent module keeps the output of the last step in its modules.
+  template<typename... CustomLayers>
+  bool operator()(Recurrent<arma::mat, arma::mat, CustomLayers...>* layer)
+      const;
+
+  //! The RecurrentAttention module keeps the output of the last step in its
+  //! modules.
+  bool operator()(RecurrentAttention<arma::mat, arma::mat>* layer) const;
+
+  bool operator()(MoreTypes layer) const;
+
+ private:
+  size_t step;
+
+  size_t interval;
+
+  //! Execute the Rewind() function for a module which implements the Rewind()
+  //! function.
+  template<typename T>
+  typename std::enable_if<
+      HasRewindCheck<T, void(T::*)(const size_t)>::value, bool>::type
+  Rewind(T* layer) const;
+
+  //! Rewind the modules of a module which doesn't implement the Rewind()
+  //! function but the Model() function.
+  template<typename T>
+  typename std::enable_if<
+      !HasRewindCheck<T, void(T::*)(const size_t)>::value &&
+      HasModelCheck<T>::value, bool>::type
+  Rewind(T* layer) const;
+
+  //! Check whether a module which doesn't implement the Rewind() or Model()
+  //! function keeps no state between the time steps.
+  template<typename T>
+  typename std::enable_if<
+      !HasRewindCheck<T, void(T::*)(const size_t)>::value &&
+      !HasModelCheck<T>::value, bool>::type
+  Rewind(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "rewind_visitor_impl.hpp"
+
+#endif
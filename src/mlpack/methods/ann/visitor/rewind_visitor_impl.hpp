@@ -0,0 +1,90 @@
+/**
+ * @file methods/ann/visitor/rewind_visitor_impl.hpp
+ *
+ * Implementation of the Rewind() function layer abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_REWIND_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_REWIND_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "rewind_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! RewindVisitor visitor class.
+inline RewindVisitor::RewindVisitor(const size_t step,
+                                    const size_t interval) :
+    step(step),
+    interval(interval)
+{
+  /* Nothing to do here. */
+}
+
+//! RewindVisitor visitor class.
+template<typename LayerType>
+inline bool RewindVisitor::operator()(LayerType* layer) const
+{
+  return Rewind(layer);
+}
+
+template<typename... CustomLayers>
+inline bool RewindVisitor::operator()(
+    Recurrent<arma::mat, arma::mat, CustomLayers...>* /* layer */) const
+{
+  return false;
+}
+
+inline bool RewindVisitor::operator()(
+    RecurrentAttention<arma::mat, arma::mat>* /* layer */) const
+{
+  return false;
+}
+
+inline bool RewindVisitor::operator()(MoreTypes layer) const
+{
+  return layer.apply_visitor(*this);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasRewindCheck<T, void(T::*)(const size_t)>::value, bool>::type
+RewindVisitor::Rewind(T* layer) const
+{
+  layer->CheckpointInterval() = interval;
+  layer->Rewind(step);
+  return true;
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasRewindCheck<T, void(T::*)(const size_t)>::value &&
+    HasModelCheck<T>::value, bool>::type
+RewindVisitor::Rewind(T* layer) const
+{
+  bool rewound = !HasResetCellCheck<T, void(T::*)(const size_t)>::value;
+  for (size_t i = 0; i < layer->Model().size(); ++i)
+    rewound &= boost::apply_visitor(RewindVisitor(step, interval),
+        layer->Model()[i]);
+
+  return rewound;
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasRewindCheck<T, void(T::*)(const size_t)>::value &&
+    !HasModelCheck<T>::value, bool>::type
+RewindVisitor::Rewind(T* /* layer */) const
+{
+  return !HasResetCellCheck<T, void(T::*)(const size_t)>::value;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
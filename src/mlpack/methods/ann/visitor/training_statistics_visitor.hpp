@@ -0,0 +1,89 @@
+/**
+ * @file methods/ann/visitor/training_statistics_visitor.hpp
+ *
+ * This file provides an abstraction for the TrainingMean() and
+ * TrainingVariance() functions for different layers and automatically directs
+ * any parameter to the right layer type.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_TRAINING_STATISTICS_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_TRAINING_STATISTICS_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * TrainingStatisticsVisitor collects the running statistics of the layers that
+ * keep them during training (like BatchNorm): the training mean and variance,
+ * in that order, and the number of batches they were computed from.  The
+ * layers of a model are visited in the same order each time, so the
+ * statistics of two copies of a model correspond to each other.
+ */
+class TrainingStatisticsVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Collect the running statistics into the given vectors.
+  TrainingStatisticsVisitor(std::vector<arma::mat*>& statistics,
+                            std::vector<size_t*>& counts);
+
+  //! Collect the running statistics.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+  void operator()(MoreTypes layer) const;
+
+ private:
+  //! The collected training means and variances.
+  std::vector<arma::mat*>& statistics;
+
+  //! The collected numbers of batches.
+  std::vector<size_t*>& counts;
+
+  //! Collect the running statistics if the module implements the
+  //! TrainingMean() and Model() function.
+  template<typename T>
+  typename std::enable_if<
+      HasTrainingMeanCheck<T, arma::mat&(T::*)(void)>::value &&
+      HasModelCheck<T>::value, void>::type
+  LayerStatistics(T* layer) const;
+
+  //! Collect the running statistics if the module implements the Model()
+  //! function.
+  template<typename T>
+  typename std::enable_if<
+      !HasTrainingMeanCheck<T, arma::mat&(T::*)(void)>::value &&
+      HasModelCheck<T>::value, void>::type
+  LayerStatistics(T* layer) const;
+
+  //! Collect the running statistics if the module implements the
+  //! TrainingMean() function.
+  template<typename T>
+  typename std::enable_if<
+      HasTrainingMeanCheck<T, arma::mat&(T::*)(void)>::value &&
+      !HasModelCheck<T>::value, void>::type
+  LayerStatistics(T* layer) const;
+
+  //! Do not collect anything if the module doesn't implement the
+  //! TrainingMean() or Model() function.
+  template<typename T>
+  typename std::enable_if<
+      !HasTrainingMeanCheck<T, arma::mat&(T::*)(void)>::value &&
+      !HasModelCheck<T>::value, void>::type
+  LayerStatistics(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "training_statistics_visitor_impl.hpp"
+
+#endif
@@ -0,0 +1,89 @@
+/**
+ * @file methods/ann/visitor/training_statistics_visitor_impl.hpp
+ *
+ * Implementation of the TrainingMean() and TrainingVariance() function layer
+ * abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_TRAINING_STATISTICS_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_TRAINING_STATISTICS_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "training_statistics_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! TrainingStatisticsVisitor visitor class.
+inline TrainingStatisticsVisitor::TrainingStatisticsVisitor(
+    std::vector<arma::mat*>& statistics,
+    std::vector<size_t*>& counts) :
+    statistics(statistics),
+    counts(counts)
+{
+  /* Nothing to do here. */
+}
+
+template<typename LayerType>
+inline void TrainingStatisticsVisitor::operator()(LayerType* layer) const
+{
+  LayerStatistics(layer);
+}
+
+inline void TrainingStatisticsVisitor::operator()(MoreTypes layer) const
+{
+  layer.apply_visitor(*this);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasTrainingMeanCheck<T, arma::mat&(T::*)(void)>::value &&
+    HasModelCheck<T>::value, void>::type
+TrainingStatisticsVisitor::LayerStatistics(T* layer) const
+{
+  statistics.push_back(&layer->TrainingMean());
+  statistics.push_back(&layer->TrainingVariance());
+  counts.push_back(&layer->Count());
+
+  for (size_t i = 0; i < layer->Model().size(); ++i)
+    boost::apply_visitor(*this, layer->Model()[i]);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasTrainingMeanCheck<T, arma::mat&(T::*)(void)>::value &&
+    HasModelCheck<T>::value, void>::type
+TrainingStatisticsVisitor::LayerStatistics(T* layer) const
+{
+  for (size_t i = 0; i < layer->Model().size(); ++i)
+    boost::apply_visitor(*this, layer->Model()[i]);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasTrainingMeanCheck<T, arma::mat&(T::*)(void)>::value &&
+    !HasModelCheck<T>::value, void>::type
+TrainingStatisticsVisitor::LayerStatistics(T* layer) const
+{
+  statistics.push_back(&layer->TrainingMean());
+  statistics.push_back(&layer->TrainingVariance());
+  counts.push_back(&layer->Count());
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasTrainingMeanCheck<T, arma::mat&(T::*)(void)>::value &&
+    !HasModelCheck<T>::value, void>::type
+TrainingStatisticsVisitor::LayerStatistics(T* /* input */) const
+{
+  /* Nothing to do here. */
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
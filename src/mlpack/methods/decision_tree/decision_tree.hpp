@@ -17,10 +17,15 @@
 #include "gini_gain.hpp"
 #include "information_gain.hpp"
 #include "best_binary_numeric_split.hpp"
+#include "histogram_numeric_split.hpp"
 #include "all_categorical_split.hpp"
 #include "all_dimension_select.hpp"
 #include <type_traits>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace tree {
 
@@ -30,6 +35,16 @@ namespace tree {
  *
  * The class inherits from the auxiliary split information in order to prevent
  * an empty auxiliary split information struct from taking any extra size.
+ *
+ * When OpenMP is enabled, training uses multiple threads.  At nodes with many
+ * points the candidate dimensions are evaluated in parallel, and when the
+ * dimension selection policy is deterministic (AllDimensionSelect), the
+ * subtrees of smaller nodes are built in parallel as OpenMP tasks.  The trained
+ * tree is the same as the one built by a single thread.  The parallel
+ * evaluation of dimensions assumes that, like the split types in mlpack, a
+ * split type that does not improve on a given gain will also not improve on a
+ * larger one, and that the gain it reports does not depend on the gain it was
+ * asked to improve on.
  */
 template<typename FitnessFunction = GiniGain,
          template<typename> class NumericSplitType = BestBinaryNumericSplit,
@@ -57,7 +72,8 @@ class DecisionTree :
    * minimumGainSplit too small may cause the tree to overfit, but setting them
    * too large may cause it to underfit.
    *
-   * Use std::move if data or labels are no longer needed to avoid copies.
+   * The data is not copied.  Use std::move if labels are no longer needed to
+   * avoid copies.
    *
    * @param data Dataset to train on.
    * @param datasetInfo Type information for each dimension of the dataset.
@@ -69,7 +85,7 @@ class DecisionTree :
    * @param dimensionSelector Instantiated dimension selection policy.
    */
   template<typename MatType, typename LabelsType>
-  DecisionTree(MatType data,
+  DecisionTree(const MatType& data,
                const data::DatasetInfo& datasetInfo,
                LabelsType labels,
                const size_t numClasses,
@@ -111,8 +127,8 @@ class DecisionTree :
    * and minimumGainSplit too small may cause the tree to overfit, but setting
    * them too large may cause it to underfit.
    *
-   * Use std::move if data, labels or weights are no longer needed to avoid
-   * copies.
+   * The data is not copied.  Use std::move if labels or weights are no longer
+   * needed to avoid copies.
    *
    * @param data Dataset to train on.
    * @param datasetInfo Type information for each dimension of the dataset.
@@ -126,7 +142,7 @@ class DecisionTree :
    */
   template<typename MatType, typename LabelsType, typename WeightsType>
   DecisionTree(
-      MatType data,
+      const MatType& data,
       const data::DatasetInfo& datasetInfo,
       LabelsType labels,
       const size_t numClasses,
@@ -281,7 +297,8 @@ class DecisionTree :
    * minimumGainSplit too small may cause the tree to overfit, but setting them
    * too large may cause it to underfit.
    *
-   * Use std::move if data or labels are no longer needed to avoid copies.
+   * The data is not copied.  Use std::move if labels are no longer needed to
+   * avoid copies.
    *
    * @param data Dataset to train on.
    * @param datasetInfo Type information for each dimension.
@@ -294,7 +311,7 @@ class DecisionTree :
    * @return The final entropy of decision tree.
    */
   template<typename MatType, typename LabelsType>
-  double Train(MatType data,
+  double Train(const MatType& data,
                const data::DatasetInfo& datasetInfo,
                LabelsType labels,
                const size_t numClasses,
@@ -338,8 +355,8 @@ class DecisionTree :
    * minimumGainSplit too small may cause the tree to overfit, but setting them
    * too large may cause it to underfit.
    *
-   * Use std::move if data, labels or weights are no longer needed to avoid
-   * copies.
+   * The data is not copied.  Use std::move if labels or weights are no longer
+   * needed to avoid copies.
    *
    * @param data Dataset to train on.
    * @param datasetInfo Type information for each dimension.
@@ -353,7 +370,7 @@ class DecisionTree :
    * @return The final entropy of decision tree.
    */
   template<typename MatType, typename LabelsType, typename WeightsType>
-  double Train(MatType data,
+  double Train(const MatType& data,
                const data::DatasetInfo& datasetInfo,
                LabelsType labels,
                const size_t numClasses,
@@ -398,6 +415,77 @@ class DecisionTree :
                const std::enable_if_t<arma::is_arma_type<typename
                    std::remove_reference<WeightsType>::type>::value>* = 0);
 
+  /**
+   * The bins of the numeric dimensions of the points a tree is trained on.
+   * When the numeric split type works on histograms (see UsesHistograms), the
+   * root of the tree bins each numeric dimension once, and every node of the
+   * tree builds its histograms from these bins.  This takes one byte per
+   * dimension for each column of the dataset.  Trees trained on subsets of the
+   * same dataset (like those of a random forest) can share the bins of the
+   * whole dataset; see BinData().
+   */
+  struct BinnedData
+  {
+    //! bins(j, i) is the bin of dimension i of the point data.col(j).
+    arma::Mat<uint8_t> bins;
+    //! The bin boundaries of each dimension (empty for categorical
+    //! dimensions).
+    std::vector<std::vector<ElemType>> boundaries;
+  };
+
+  /**
+   * Bin each numeric dimension of the whole dataset with the quantile bins of
+   * the dimension.  The bins can then be given to the indexed Train() of every
+   * tree trained on points of this dataset.
+   *
+   * @param data Dataset to bin.
+   * @param datasetInfo Type information for each dimension.
+   * @param binned Set to the bins of the dataset.
+   */
+  template<typename MatType>
+  static void BinData(const MatType& data,
+                      const data::DatasetInfo& datasetInfo,
+                      BinnedData& binned);
+
+  /**
+   * Train the decision tree on the points of the given dataset selected by the
+   * given indices, without copying the dataset.  An index may appear more than
+   * once (as in a bootstrap sample), in which case the corresponding point is
+   * used that many times.  Only the indices, labels, and weights are copied, so
+   * the extra memory needed is O(indices.n_elem) instead of the size of the
+   * dataset.  The data may have numeric and categorical types, specified by the
+   * datasetInfo parameter.
+   *
+   * @tparam UseWeights Whether or not to use the given weights.
+   * @param data Dataset to train on.
+   * @param indices Indices of the points (columns) of the dataset to use.
+   * @param datasetInfo Type information for each dimension.
+   * @param labels Labels for each point in the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of each point in the dataset (ignored if UseWeights
+   *      is false).
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @param binned Bins of the whole dataset given by BinData(), or NULL to let
+   *      the tree bin its points itself.  This is ignored if the numeric split
+   *      type doesn't work on histograms.
+   * @return The final entropy of decision tree.
+   */
+  template<bool UseWeights, typename MatType>
+  double Train(const MatType& data,
+               const arma::uvec& indices,
+               const data::DatasetInfo& datasetInfo,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const arma::rowvec& weights,
+               const size_t minimumLeafSize,
+               const double minimumGainSplit,
+               const size_t maximumDepth,
+               DimensionSelectionType dimensionSelector,
+               const BinnedData* binned = NULL);
+
   /**
    * Classify the given point, using the entire tree.  The predicted label is
    * returned.
@@ -465,6 +553,15 @@ class DecisionTree :
   //! trained tree).
   size_t SplitDimension() const { return splitDimension; }
 
+  //! Get the type of the split dimension (only meaningful if this is a
+  //! non-leaf in a trained tree).
+  data::Datatype SplitType() const
+  { return (data::Datatype) dimensionTypeOrMajorityClass; }
+
+  //! Get the class probabilities if this is a leaf, or the split information
+  //! used by the split type's CalculateDirection() if this is a non-leaf.
+  const arma::vec& ClassProbabilities() const { return classProbabilities; }
+
   /**
    * Given a point and that this node is not a leaf, calculate the index of the
    * child node this point would go towards.  This method is primarily used by
@@ -513,16 +610,269 @@ class DecisionTree :
                                    const size_t numClasses,
                                    const WeightsRowType& weights);
 
+  //! Nodes with at least this many points evaluate their candidate dimensions
+  //! in parallel.
+  static constexpr size_t MinimumParallelSplitSize = 4096;
+  //! Nodes with at least this many points build their subtrees in parallel
+  //! (if the dimension selection policy allows it).
+  static constexpr size_t MinimumParallelChildrenSize = 128;
+  //! Whether subtrees can be built in parallel with the same result as serial
+  //! training; this is only possible if the dimension selection policy does
+  //! not use the random number generator.
+  static constexpr bool ParallelChildren =
+      std::is_same<DimensionSelectionType, AllDimensionSelect>::value;
+
+  /**
+   * Find the best split of the points of a node over the given dimensions by
+   * evaluating the dimensions in parallel.  The result,
+   * including the split information stored in classProbabilities and in the
+   * auxiliary split information, is the same as that of evaluating the
+   * dimensions one at a time in the given order.
+   *
+   * Each dimension is first evaluated against the gain of the node.  Then the
+   * results are visited in order: a dimension that did not improve on the gain
+   * of the node cannot improve on a better gain, and a dimension whose gain is
+   * not better than the best gain found so far is skipped; the remaining
+   * dimensions (only the ones that set a new best gain) are evaluated again
+   * against the best gain found so far, exactly as serial training does.
+   *
+   * @param data Dataset to train on.
+   * @param indices Indices of the points in the dataset, or NULL if the points
+   *      of the node are data.cols(begin, begin + count - 1).
+   * @param begin Index of the first point (or index) that belongs to this
+   *      node.
+   * @param count Number of points in this node.
+   * @param datasetInfo Type information for each dimension, or NULL if all
+   *      dimensions are numeric.
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of all the labels.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param dimensions Dimensions to evaluate, in order.
+   * @param bestDim Set to the best dimension if any dimension improves on
+   *      bestGain; otherwise it is left unchanged.
+   * @param bestGain Gain of the node; set to the gain of the best split.
+   */
+  template<bool UseWeights, typename MatType>
+  void ParallelSplitSearch(const MatType& data,
+                           const arma::uvec* indices,
+                           const size_t begin,
+                           const size_t count,
+                           const data::DatasetInfo* datasetInfo,
+                           const arma::Row<size_t>& labels,
+                           const size_t numClasses,
+                           const arma::rowvec& weights,
+                           const size_t minimumLeafSize,
+                           const double minimumGainSplit,
+                           const std::vector<size_t>& dimensions,
+                           size_t& bestDim,
+                           double& bestGain);
+
+  /**
+   * Store the values of the given dimension for the points of a node in
+   * dimData.
+   *
+   * @param data Dataset to train on.
+   * @param indices Indices of the points in the dataset, or NULL if the points
+   *      of the node are data.cols(begin, begin + count - 1).
+   * @param begin Index of the first point (or index) that belongs to this
+   *      node.
+   * @param count Number of points in this node.
+   * @param dimension Dimension to gather.
+   * @param dimData Set to the values of the dimension.
+   */
+  template<typename MatType>
+  static void GatherDimension(const MatType& data,
+                              const arma::uvec* indices,
+                              const size_t begin,
+                              const size_t count,
+                              const size_t dimension,
+                              arma::Row<typename MatType::elem_type>& dimData);
+
+  /**
+   * Bin each numeric dimension of the points data.col(indices[begin]) through
+   * data.col(indices[begin + count - 1]) with the quantile bins of the
+   * dimension over these points.
+   *
+   * @param data Dataset to train on.
+   * @param indices Indices of the points in the dataset.
+   * @param begin Index of the first element of indices to bin.
+   * @param count Number of points to bin.
+   * @param datasetInfo Type information for each dimension.
+   * @param binned Set to the bins of the points.
+   */
+  template<typename MatType>
+  static void BinData(const MatType& data,
+                      const arma::uvec& indices,
+                      const size_t begin,
+                      const size_t count,
+                      const data::DatasetInfo& datasetInfo,
+                      BinnedData& binned);
+
+  /**
+   * Build the histogram of the given dimension for the points of a node from
+   * the bins of the tree.
+   *
+   * @param indices Indices of the points in the dataset.
+   * @param begin Index of the first point (or index) that belongs to the node.
+   * @param count Number of points in the node.
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of all the labels.
+   * @param binned Bins of the tree.
+   * @param dimension Dimension to build the histogram of.
+   * @param histogram Set to the histogram of the dimension.
+   */
+  template<bool UseWeights>
+  static void BuildHistogram(const arma::uvec& indices,
+                             const size_t begin,
+                             const size_t count,
+                             const arma::Row<size_t>& labels,
+                             const size_t numClasses,
+                             const arma::rowvec& weights,
+                             const BinnedData& binned,
+                             const size_t dimension,
+                             arma::mat& histogram);
+
+  /**
+   * Find the best split of the points of a node, evaluating the numeric
+   * dimensions from their histograms.  The histograms the node does not have
+   * yet are built from the bins of the tree, in parallel if the node is large.
+   *
+   * @param data Dataset to train on.
+   * @param indices Indices of the points in the dataset.
+   * @param begin Index of the first point (or index) that belongs to this
+   *      node.
+   * @param count Number of points in this node.
+   * @param datasetInfo Type information for each dimension.
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of all the labels.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param binned Bins of the tree.
+   * @param histograms Histograms of each dimension for this node (empty if not
+   *      built yet).
+   * @param dimensionSelector Dimension selection policy.
+   * @param bestDim Set to the best dimension if any dimension improves on
+   *      bestGain; otherwise it is left unchanged.
+   * @param bestGain Gain of the node; set to the gain of the best split.
+   */
+  template<bool UseWeights, typename MatType>
+  void HistogramSplitSearch(const MatType& data,
+                            const arma::uvec& indices,
+                            const size_t begin,
+                            const size_t count,
+                            const data::DatasetInfo& datasetInfo,
+                            const arma::Row<size_t>& labels,
+                            const size_t numClasses,
+                            const arma::rowvec& weights,
+                            const size_t minimumLeafSize,
+                            const double minimumGainSplit,
+                            const BinnedData& binned,
+                            std::vector<arma::mat>& histograms,
+                            DimensionSelectionType& dimensionSelector,
+                            size_t& bestDim,
+                            double& bestGain);
+
+  /**
+   * Compute the histograms of the children of a node from the histograms of the
+   * node.  The histograms of every child but the largest one are built from the
+   * bins of the tree, and the histograms of the largest child are the
+   * histograms of the node minus those of its siblings.  Only the dimensions
+   * the node has a histogram of are computed, and only for children that may
+   * be split.  The histograms of the node are released.
+   *
+   * @param indices Indices of the points in the dataset, reordered so that the
+   *      points of each child are contiguous.
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of all the labels.
+   * @param binned Bins of the tree.
+   * @param childBegins Index of the first point of each child.
+   * @param childCounts Number of points of each child.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param maximumDepth Maximum depth for the tree (counting the node).
+   * @param histograms Histograms of the node.
+   * @param childHistograms Set to the histograms of each child.
+   */
+  template<bool UseWeights>
+  static void SplitHistograms(
+      const arma::uvec& indices,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const arma::rowvec& weights,
+      const BinnedData& binned,
+      const std::vector<size_t>& childBegins,
+      const arma::Row<size_t>& childCounts,
+      const size_t minimumLeafSize,
+      const size_t maximumDepth,
+      std::vector<arma::mat>& histograms,
+      std::vector<std::vector<arma::mat>>& childHistograms);
+
+  /**
+   * Call NumericSplit::SplitIfBetter() on the histogram of a dimension.  This
+   * overload is used when the numeric split type works on histograms.
+   */
+  template<bool UseWeights, typename SplitType = NumericSplit>
+  double HistogramSplitIfBetter(
+      const double bestGain,
+      const arma::mat& histogram,
+      const std::vector<ElemType>& boundaries,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      const std::enable_if_t<UsesHistograms<SplitType>::value>* = 0);
+
+  /**
+   * This overload is used when the numeric split type does not work on
+   * histograms; it is never called, since no bins are built for such trees.
+   */
+  template<bool UseWeights, typename SplitType = NumericSplit>
+  double HistogramSplitIfBetter(
+      const double /* bestGain */,
+      const arma::mat& /* histogram */,
+      const std::vector<ElemType>& /* boundaries */,
+      const size_t /* minimumLeafSize */,
+      const double /* minimumGainSplit */,
+      const std::enable_if_t<!UsesHistograms<SplitType>::value>* = 0)
+  {
+    return DBL_MAX;
+  }
+
+  /**
+   * Call train(i) for each child i in [0, numChildren).  If parallel is true
+   * and OpenMP tasks are available, the children are trained as OpenMP tasks
+   * (in a new parallel region if this is not called from one already).
+   *
+   * @param numChildren Number of children to train.
+   * @param parallel Whether or not the children may be trained in parallel.
+   * @param train Function that trains the child with the given index.
+   */
+  template<typename TrainFunctionType>
+  static void TrainChildren(const size_t numChildren,
+                            const bool parallel,
+                            const TrainFunctionType& train);
+
+  //! Return whether we are running in an OpenMP parallel region.
+  static bool InParallelRegion()
+  {
+    #ifdef HAS_OPENMP
+      return omp_in_parallel();
+    #else
+      return false;
+    #endif
+  }
+
   /**
    * Corresponding to the public Train() method, this method is designed for
-   * avoiding unnecessary copies during training.  This function is called to
-   * train children.
+   * avoiding unnecessary copies during training.  This method is called for
+   * training children.
    *
    * @param data Dataset to train on.
    * @param begin Index of the starting point in the dataset that belongs to
    *      this node.
    * @param count Number of points in this node.
-   * @param datasetInfo Type information for each dimension.
    * @param labels Labels for each training point.
    * @param numClasses Number of classes in the dataset.
    * @param minimumLeafSize Minimum number of points in each leaf node.
@@ -534,7 +884,6 @@ class DecisionTree :
   double Train(MatType& data,
                const size_t begin,
                const size_t count,
-               const data::DatasetInfo& datasetInfo,
                arma::Row<size_t>& labels,
                const size_t numClasses,
                arma::rowvec& weights,
@@ -544,32 +893,45 @@ class DecisionTree :
                DimensionSelectionType& dimensionSelector);
 
   /**
-   * Corresponding to the public Train() method, this method is designed for
-   * avoiding unnecessary copies during training.  This method is called for
-   * training children.
+   * Corresponding to the public Train() methods that take a DatasetInfo, this
+   * method trains on the points data.col(indices[begin]) through
+   * data.col(indices[begin + count - 1]).  The indices, labels, and weights are
+   * reordered during training; the dataset itself is never modified.  This
+   * method is called for training children.
    *
    * @param data Dataset to train on.
-   * @param begin Index of the starting point in the dataset that belongs to
-   *      this node.
+   * @param indices Indices of the points in the dataset; labels and weights
+   *      are aligned with these indices.
+   * @param begin Index of the first element of indices that belongs to this
+   *      node.
    * @param count Number of points in this node.
+   * @param datasetInfo Type information for each dimension.
    * @param labels Labels for each training point.
    * @param numClasses Number of classes in the dataset.
    * @param minimumLeafSize Minimum number of points in each leaf node.
    * @param minimumGainSplit Minimum gain for the node to split.
    * @param maximumDepth Maximum depth for the tree.
+   * @param binned Bins of the tree, or NULL at the root of the tree (the root
+   *      bins the data if the numeric split type works on histograms).
+   * @param histograms Histograms of this node computed by its parent (ignored
+   *      if binned is NULL), or NULL at the root of the tree.
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType>
-  double Train(MatType& data,
+  double Train(const MatType& data,
+               arma::uvec& indices,
                const size_t begin,
                const size_t count,
+               const data::DatasetInfo& datasetInfo,
                arma::Row<size_t>& labels,
                const size_t numClasses,
                arma::rowvec& weights,
                const size_t minimumLeafSize,
                const double minimumGainSplit,
                const size_t maximumDepth,
-               DimensionSelectionType& dimensionSelector);
+               DimensionSelectionType& dimensionSelector,
+               const BinnedData* binned = NULL,
+               std::vector<arma::mat>* histograms = NULL);
 };
 
 /**
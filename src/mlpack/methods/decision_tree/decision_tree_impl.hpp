@@ -31,7 +31,7 @@ DecisionTree<FitnessFunction,
              DimensionSelectionType,
              ElemType,
              NoRecursion>::DecisionTree(
-    MatType data,
+    const MatType& data,
     const data::DatasetInfo& datasetInfo,
     LabelsType labels,
     const size_t numClasses,
@@ -40,20 +40,20 @@ DecisionTree<FitnessFunction,
     const size_t maximumDepth,
     DimensionSelectionType dimensionSelector)
 {
-  using TrueMatType = typename std::decay<MatType>::type;
   using TrueLabelsType = typename std::decay<LabelsType>::type;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move the labels; the data is only indexed.
   TrueLabelsType tmpLabels(std::move(labels));
 
   // Set the correct dimensionality for the dimension selector.
-  dimensionSelector.Dimensions() = tmpData.n_rows;
+  dimensionSelector.Dimensions() = data.n_rows;
 
   // Pass off work to the Train() method.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols);
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
-      weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+  Train<false>(data, indices, 0, data.n_cols, datasetInfo, tmpLabels,
+      numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
 
@@ -109,7 +109,7 @@ DecisionTree<FitnessFunction,
              DimensionSelectionType,
              ElemType,
              NoRecursion>::DecisionTree(
-    MatType data,
+    const MatType& data,
     const data::DatasetInfo& datasetInfo,
     LabelsType labels,
     const size_t numClasses,
@@ -121,21 +121,21 @@ DecisionTree<FitnessFunction,
     const std::enable_if_t<arma::is_arma_type<
         typename std::remove_reference<WeightsType>::type>::value>*)
 {
-  using TrueMatType = typename std::decay<MatType>::type;
   using TrueLabelsType = typename std::decay<LabelsType>::type;
   using TrueWeightsType = typename std::decay<WeightsType>::type;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move the labels and weights; the data is only indexed.
   TrueLabelsType tmpLabels(std::move(labels));
   TrueWeightsType tmpWeights(std::move(weights));
 
   // Set the correct dimensionality for the dimension selector.
-  dimensionSelector.Dimensions() = tmpData.n_rows;
+  dimensionSelector.Dimensions() = data.n_rows;
 
-  // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
-      tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
+  // Pass off work to the Train() method.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols);
+  Train<true>(data, indices, 0, data.n_cols, datasetInfo, tmpLabels,
+      numClasses, tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
 
@@ -459,7 +459,7 @@ double DecisionTree<FitnessFunction,
                     DimensionSelectionType,
                     ElemType,
                     NoRecursion>::Train(
-    MatType data,
+    const MatType& data,
     const data::DatasetInfo& datasetInfo,
     LabelsType labels,
     const size_t numClasses,
@@ -471,21 +471,21 @@ double DecisionTree<FitnessFunction,
   // Sanity check on data.
   util::CheckSameSizes(data, labels, "DecisionTree::Train()");
 
-  using TrueMatType = typename std::decay<MatType>::type;
   using TrueLabelsType = typename std::decay<LabelsType>::type;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move the labels; the data is only indexed.
   TrueLabelsType tmpLabels(std::move(labels));
 
   // Set the correct dimensionality for the dimension selector.
-  dimensionSelector.Dimensions() = tmpData.n_rows;
+  dimensionSelector.Dimensions() = data.n_rows;
 
   // Pass off work to the Train() method.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols);
   arma::rowvec weights; // Fake weights, not used.
-  return Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels,
-      numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
-      dimensionSelector);
+  return Train<false>(data, indices, 0, data.n_cols, datasetInfo,
+      tmpLabels, numClasses, weights, minimumLeafSize, minimumGainSplit,
+      maximumDepth, dimensionSelector);
 }
 
 //! Train on the given data, assuming all dimensions are numeric.
@@ -523,8 +523,19 @@ double DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
-  // Pass off work to the Train() method.
+  // Pass off work to the Train() method.  Split types that work on histograms
+  // use the indexed Train(), which bins the data once for the whole tree.
   arma::rowvec weights; // Fake weights, not used.
+  if (UsesHistograms<NumericSplit>::value)
+  {
+    arma::uvec indices = arma::linspace<arma::uvec>(0, tmpData.n_cols - 1,
+        tmpData.n_cols);
+    data::DatasetInfo datasetInfo(tmpData.n_rows);
+    return Train<false>(tmpData, indices, 0, tmpData.n_cols, datasetInfo,
+        tmpLabels, numClasses, weights, minimumLeafSize, minimumGainSplit,
+        maximumDepth, dimensionSelector);
+  }
+
   return Train<false>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses,
       weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
@@ -544,7 +555,7 @@ double DecisionTree<FitnessFunction,
                     DimensionSelectionType,
                     ElemType,
                     NoRecursion>::Train(
-    MatType data,
+    const MatType& data,
     const data::DatasetInfo& datasetInfo,
     LabelsType labels,
     const size_t numClasses,
@@ -561,22 +572,22 @@ double DecisionTree<FitnessFunction,
   // Sanity check on data.
   util::CheckSameSizes(data, labels, "DecisionTree::Train()");
 
-  using TrueMatType = typename std::decay<MatType>::type;
   using TrueLabelsType = typename std::decay<LabelsType>::type;
   using TrueWeightsType = typename std::decay<WeightsType>::type;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move the labels and weights; the data is only indexed.
   TrueLabelsType tmpLabels(std::move(labels));
   TrueWeightsType tmpWeights(std::move(weights));
 
   // Set the correct dimensionality for the dimension selector.
-  dimensionSelector.Dimensions() = tmpData.n_rows;
+  dimensionSelector.Dimensions() = data.n_rows;
 
   // Pass off work to the Train() method.
-  return Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels,
-      numClasses, tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
-      dimensionSelector);
+  arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols);
+  return Train<true>(data, indices, 0, data.n_cols, datasetInfo,
+      tmpLabels, numClasses, tmpWeights, minimumLeafSize, minimumGainSplit,
+      maximumDepth, dimensionSelector);
 }
 
 //! Train on the given weighted data.
@@ -621,13 +632,24 @@ double DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
-  // Pass off work to the Train() method.
+  // Pass off work to the Train() method.  Split types that work on histograms
+  // use the indexed Train(), which bins the data once for the whole tree.
+  if (UsesHistograms<NumericSplit>::value)
+  {
+    arma::uvec indices = arma::linspace<arma::uvec>(0, tmpData.n_cols - 1,
+        tmpData.n_cols);
+    data::DatasetInfo datasetInfo(tmpData.n_rows);
+    return Train<true>(tmpData, indices, 0, tmpData.n_cols, datasetInfo,
+        tmpLabels, numClasses, tmpWeights, minimumLeafSize, minimumGainSplit,
+        maximumDepth, dimensionSelector);
+  }
+
   return Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses,
       tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
 
-//! Train on the given data, assuming all dimensions are numeric.
+//! Train on the given indices of the data, without copying the data.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
@@ -641,176 +663,44 @@ double DecisionTree<FitnessFunction,
                     DimensionSelectionType,
                     ElemType,
                     NoRecursion>::Train(
-    MatType& data,
-    const size_t begin,
-    const size_t count,
+    const MatType& data,
+    const arma::uvec& indices,
     const data::DatasetInfo& datasetInfo,
-    arma::Row<size_t>& labels,
+    const arma::Row<size_t>& labels,
     const size_t numClasses,
-    arma::rowvec& weights,
+    const arma::rowvec& weights,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     const size_t maximumDepth,
-    DimensionSelectionType& dimensionSelector)
+    DimensionSelectionType dimensionSelector,
+    const BinnedData* binned)
 {
-  // Clear children if needed.
-  for (size_t i = 0; i < children.size(); ++i)
-    delete children[i];
-  children.clear();
-
-  // Look through the list of dimensions and obtain the gain of the best split.
-  // We'll cache the best numeric and categorical split auxiliary information in
-  // numericAux and categoricalAux (and clear them later if we make no split),
-  // and use classProbabilities as auxiliary information.  Later we'll overwrite
-  // classProbabilities to the empirical class probabilities if we do not split.
-  double bestGain = FitnessFunction::template Evaluate<UseWeights>(
-      labels.subvec(begin, begin + count - 1),
-      numClasses,
-      UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
-  size_t bestDim = datasetInfo.Dimensionality(); // This means "no split".
-  const size_t end = dimensionSelector.End();
-
-  if (maximumDepth != 1)
+  // Sanity check on data.
+  util::CheckSameSizes(data, labels, "DecisionTree::Train()");
+  if (UseWeights)
+    util::CheckSameSizes(data, weights, "DecisionTree::Train()", "weights");
+  if (binned != NULL && UsesHistograms<NumericSplit>::value)
   {
-    for (size_t i = dimensionSelector.Begin(); i != end;
-         i = dimensionSelector.Next())
-    {
-      double dimGain = -DBL_MAX;
-      if (datasetInfo.Type(i) == data::Datatype::categorical)
-      {
-        dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
-            datasetInfo.NumMappings(i),
-            labels.subvec(begin, begin + count - 1),
-            numClasses,
-            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-            minimumLeafSize,
-            minimumGainSplit,
-            classProbabilities,
-            *this);
-      }
-      else if (datasetInfo.Type(i) == data::Datatype::numeric)
-      {
-        dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
-            labels.subvec(begin, begin + count - 1),
-            numClasses,
-            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-            minimumLeafSize,
-            minimumGainSplit,
-            classProbabilities,
-            *this);
-      }
-
-      // If the splitter reported that it did not split, move to the next
-      // dimension.
-      if (dimGain == DBL_MAX)
-        continue;
-
-      // Was there an improvement?  If so mark that it's the new best dimension.
-      bestDim = i;
-      bestGain = dimGain;
-
-      // If the gain is the best possible, no need to keep looking.
-      if (bestGain >= 0.0)
-        break;
-    }
+    util::CheckSameSizes(data, (size_t) binned->bins.n_rows,
+        "DecisionTree::Train()", "binned points");
   }
 
-  // Did we split or not?  If so, then split the data and create the children.
-  if (bestDim != datasetInfo.Dimensionality())
-  {
-    dimensionTypeOrMajorityClass = (size_t) datasetInfo.Type(bestDim);
-    splitDimension = bestDim;
-
-    // Get the number of children we will have.
-    size_t numChildren = 0;
-    if (datasetInfo.Type(bestDim) == data::Datatype::categorical)
-      numChildren = CategoricalSplit::NumChildren(classProbabilities, *this);
-    else
-      numChildren = NumericSplit::NumChildren(classProbabilities, *this);
-
-    // Calculate all child assignments.
-    arma::Row<size_t> childAssignments(count);
-    if (datasetInfo.Type(bestDim) == data::Datatype::categorical)
-    {
-      for (size_t j = begin; j < begin + count; ++j)
-        childAssignments[j - begin] = CategoricalSplit::CalculateDirection(
-            data(bestDim, j), classProbabilities, *this);
-    }
-    else
-    {
-      for (size_t j = begin; j < begin + count; ++j)
-      {
-        childAssignments[j - begin] = NumericSplit::CalculateDirection(
-            data(bestDim, j), classProbabilities, *this);
-      }
-    }
-
-    // Figure out counts of children.
-    arma::Row<size_t> childCounts(numChildren, arma::fill::zeros);
-    for (size_t i = begin; i < begin + count; ++i)
-      childCounts[childAssignments[i - begin]]++;
-
-    // Initialize bestGain if recursive split is allowed.
-    if (!NoRecursion)
-    {
-      bestGain = 0.0;
-    }
-
-    // Split into children.
-    size_t currentCol = begin;
-    for (size_t i = 0; i < numChildren; ++i)
-    {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
-      {
-        if (childAssignments[j - begin] == i)
-        {
-          childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
-          labels.swap_cols(currentCol, j);
-          if (UseWeights)
-            weights.swap_cols(currentCol, j);
-          ++currentCol;
-        }
-      }
-
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, currentCol - currentChildBegin, minimumGainSplit,
-            maximumDepth - 1, dimensionSelector);
-      }
-      else
-      {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
-      }
-      children.push_back(child);
-    }
-  }
-  else
-  {
-    // Clear auxiliary info objects.
-    NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
-    CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
+  // Only the indices, labels, and weights of the selected points are copied,
+  // since those are reordered during training.
+  arma::uvec tmpIndices(indices);
+  arma::Row<size_t> tmpLabels = labels.cols(indices);
+  arma::rowvec tmpWeights;
+  if (UseWeights)
+    tmpWeights = weights.cols(indices);
 
-    // Calculate class probabilities because we are a leaf.
-    CalculateClassProbabilities<UseWeights>(
-        labels.subvec(begin, begin + count - 1),
-        numClasses,
-        UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
-  }
+  // Set the correct dimensionality for the dimension selector.
+  dimensionSelector.Dimensions() = data.n_rows;
 
-  return -bestGain;
+  // Pass off work to the Train() method.
+  return Train<UseWeights>(data, tmpIndices, 0, tmpIndices.n_elem,
+      datasetInfo, tmpLabels, numClasses, tmpWeights, minimumLeafSize,
+      minimumGainSplit, maximumDepth, dimensionSelector,
+      UsesHistograms<NumericSplit>::value ? binned : NULL);
 }
 
 //! Train on the given data, assuming all dimensions are numeric.
@@ -857,7 +747,20 @@ double DecisionTree<FitnessFunction,
       UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
   size_t bestDim = data.n_rows; // This means "no split".
 
-  if (maximumDepth != 1)
+  if (maximumDepth != 1 && count >= MinimumParallelSplitSize &&
+      !InParallelRegion())
+  {
+    // This node is large, so evaluate the dimensions in parallel.
+    std::vector<size_t> dimensions;
+    for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
+         i = dimensionSelector.Next())
+      dimensions.push_back(i);
+
+    ParallelSplitSearch<UseWeights>(data, (const arma::uvec*) NULL, begin,
+        count, (const data::DatasetInfo*) NULL, labels, numClasses, weights,
+        minimumLeafSize, minimumGainSplit, dimensions, bestDim, bestGain);
+  }
+  else if (maximumDepth != 1)
   {
     for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
          i = dimensionSelector.Next())
@@ -918,11 +821,15 @@ double DecisionTree<FitnessFunction,
       bestGain = 0.0;
     }
 
+    // Move the points of each child to a contiguous block before any child is
+    // built, so that the children only touch their own block and can be built
+    // in any order.
+    std::vector<size_t> childBegins(numChildren);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = currentCol; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
@@ -935,25 +842,29 @@ double DecisionTree<FitnessFunction,
         }
       }
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            currentCol - currentChildBegin, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-      }
-      else
-      {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
-      }
-      children.push_back(child);
+      children.push_back(new DecisionTree());
+    }
+
+    // Now build the children recursively.
+    const bool parallel = ParallelChildren &&
+        count >= MinimumParallelChildrenSize &&
+        count < MinimumParallelSplitSize;
+    std::vector<double> childGains(numChildren, 0.0);
+    TrainChildren(numChildren, parallel, [&](const size_t i)
+    {
+      // Each task needs its own dimension selector.
+      DimensionSelectionType childSelector(dimensionSelector);
+      childGains[i] = children[i]->Train<UseWeights>(data,
+          childBegins[i], childCounts[i], labels, numClasses, weights,
+          NoRecursion ? childCounts[i] : minimumLeafSize, minimumGainSplit,
+          maximumDepth - 1, parallel ? childSelector : dimensionSelector);
+    });
+
+    // During recursion entropy of child node may change.
+    if (!NoRecursion)
+    {
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
     }
   }
   else
@@ -971,54 +882,306 @@ double DecisionTree<FitnessFunction,
   return -bestGain;
 }
 
-//! Return the class.
+//! Train on the given indices of the data.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename DimensionSelectionType,
          typename ElemType,
          bool NoRecursion>
-template<typename VecType>
-size_t DecisionTree<FitnessFunction,
+template<bool UseWeights, typename MatType>
+double DecisionTree<FitnessFunction,
                     NumericSplitType,
                     CategoricalSplitType,
                     DimensionSelectionType,
                     ElemType,
-                    NoRecursion>::Classify(const VecType& point) const
+                    NoRecursion>::Train(
+    const MatType& data,
+    arma::uvec& indices,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo& datasetInfo,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType& dimensionSelector,
+    const BinnedData* binned,
+    std::vector<arma::mat>* histograms)
 {
-  if (children.size() == 0)
+  // Clear children if needed.
+  for (size_t i = 0; i < children.size(); ++i)
+    delete children[i];
+  children.clear();
+
+  // If the numeric split type works on histograms, the root bins the numeric
+  // dimensions once (unless it was given the bins of the dataset); every node
+  // of the tree builds its histograms from these bins.
+  BinnedData rootBinned;
+  std::vector<arma::mat> rootHistograms;
+  if (binned == NULL && UsesHistograms<NumericSplit>::value &&
+      maximumDepth != 1)
   {
-    // Return cached max of probabilities.
-    return dimensionTypeOrMajorityClass;
+    BinData(data, indices, begin, count, datasetInfo, rootBinned);
+    binned = &rootBinned;
   }
+  if (binned != NULL && histograms == NULL)
+    histograms = &rootHistograms;
 
-  return children[CalculateDirection(point)]->Classify(point);
-}
+  // Look through the list of dimensions and obtain the gain of the best split.
+  // We'll cache the best numeric and categorical split auxiliary information in
+  // numericAux and categoricalAux (and clear them later if we make no split),
+  // and use classProbabilities as auxiliary information.  Later we'll overwrite
+  // classProbabilities to the empirical class probabilities if we do not split.
+  double bestGain = FitnessFunction::template Evaluate<UseWeights>(
+      labels.subvec(begin, begin + count - 1),
+      numClasses,
+      UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+  size_t bestDim = datasetInfo.Dimensionality(); // This means "no split".
+  const size_t end = dimensionSelector.End();
 
-//! Return class probabilities for a given point.
-template<typename FitnessFunction,
-         template<typename> class NumericSplitType,
-         template<typename> class CategoricalSplitType,
-         typename DimensionSelectionType,
-         typename ElemType,
-         bool NoRecursion>
-template<typename VecType>
-void DecisionTree<FitnessFunction,
-                  NumericSplitType,
-                  CategoricalSplitType,
-                  DimensionSelectionType,
-                  ElemType,
-                  NoRecursion>::Classify(const VecType& point,
-                                         size_t& prediction,
-                                         arma::vec& probabilities) const
-{
-  if (children.size() == 0)
+  if (maximumDepth != 1 && binned != NULL)
   {
-    prediction = dimensionTypeOrMajorityClass;
-    probabilities = classProbabilities;
-    return;
+    HistogramSplitSearch<UseWeights>(data, indices, begin, count,
+        datasetInfo, labels, numClasses, weights, minimumLeafSize,
+        minimumGainSplit, *binned, *histograms, dimensionSelector, bestDim,
+        bestGain);
   }
-
+  else if (maximumDepth != 1 && count >= MinimumParallelSplitSize &&
+      !InParallelRegion())
+  {
+    // This node is large, so evaluate the dimensions in parallel.
+    std::vector<size_t> dimensions;
+    for (size_t i = dimensionSelector.Begin(); i != end;
+         i = dimensionSelector.Next())
+      dimensions.push_back(i);
+
+    ParallelSplitSearch<UseWeights>(data, &indices, begin, count,
+        &datasetInfo, labels, numClasses, weights, minimumLeafSize,
+        minimumGainSplit, dimensions, bestDim, bestGain);
+  }
+  else if (maximumDepth != 1)
+  {
+    // The values of the current dimension for the points in this node.
+    arma::Row<typename MatType::elem_type> dimData;
+
+    for (size_t i = dimensionSelector.Begin(); i != end;
+         i = dimensionSelector.Next())
+    {
+      GatherDimension(data, &indices, begin, count, i, dimData);
+
+      double dimGain = -DBL_MAX;
+      if (datasetInfo.Type(i) == data::Datatype::categorical)
+      {
+        dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
+            dimData,
+            datasetInfo.NumMappings(i),
+            labels.subvec(begin, begin + count - 1),
+            numClasses,
+            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+            minimumLeafSize,
+            minimumGainSplit,
+            classProbabilities,
+            *this);
+      }
+      else if (datasetInfo.Type(i) == data::Datatype::numeric)
+      {
+        dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
+            dimData,
+            labels.subvec(begin, begin + count - 1),
+            numClasses,
+            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+            minimumLeafSize,
+            minimumGainSplit,
+            classProbabilities,
+            *this);
+      }
+
+      // If the splitter reported that it did not split, move to the next
+      // dimension.
+      if (dimGain == DBL_MAX)
+        continue;
+
+      // Was there an improvement?  If so mark that it's the new best dimension.
+      bestDim = i;
+      bestGain = dimGain;
+
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
+    }
+  }
+
+  // Did we split or not?  If so, then split the data and create the children.
+  if (bestDim != datasetInfo.Dimensionality())
+  {
+    dimensionTypeOrMajorityClass = (size_t) datasetInfo.Type(bestDim);
+    splitDimension = bestDim;
+
+    // Get the number of children we will have.
+    size_t numChildren = 0;
+    if (datasetInfo.Type(bestDim) == data::Datatype::categorical)
+      numChildren = CategoricalSplit::NumChildren(classProbabilities, *this);
+    else
+      numChildren = NumericSplit::NumChildren(classProbabilities, *this);
+
+    // Calculate all child assignments.
+    arma::Row<size_t> childAssignments(count);
+    if (datasetInfo.Type(bestDim) == data::Datatype::categorical)
+    {
+      for (size_t j = begin; j < begin + count; ++j)
+        childAssignments[j - begin] = CategoricalSplit::CalculateDirection(
+            data(bestDim, indices[j]), classProbabilities, *this);
+    }
+    else
+    {
+      for (size_t j = begin; j < begin + count; ++j)
+      {
+        childAssignments[j - begin] = NumericSplit::CalculateDirection(
+            data(bestDim, indices[j]), classProbabilities, *this);
+      }
+    }
+
+    // Figure out counts of children.
+    arma::Row<size_t> childCounts(numChildren, arma::fill::zeros);
+    for (size_t i = begin; i < begin + count; ++i)
+      childCounts[childAssignments[i - begin]]++;
+
+    // Initialize bestGain if recursive split is allowed.
+    if (!NoRecursion)
+    {
+      bestGain = 0.0;
+    }
+
+    // Split into children.  Only the indices (and the labels and weights
+    // aligned with them) are reordered; the points of each child are moved to
+    // a contiguous block before any child is built, so that the children only
+    // touch their own block and can be built in any order.
+    std::vector<size_t> childBegins(numChildren);
+    size_t currentCol = begin;
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      childBegins[i] = currentCol;
+      for (size_t j = currentCol; j < begin + count; ++j)
+      {
+        if (childAssignments[j - begin] == i)
+        {
+          childAssignments.swap_cols(currentCol - begin, j - begin);
+          indices.swap_rows(currentCol, j);
+          labels.swap_cols(currentCol, j);
+          if (UseWeights)
+            weights.swap_cols(currentCol, j);
+          ++currentCol;
+        }
+      }
+
+      children.push_back(new DecisionTree());
+    }
+
+    // Compute the histograms of the children from those of this node.  (Without
+    // recursion the children are never split, so they need none.)
+    std::vector<std::vector<arma::mat>> childHistograms(numChildren);
+    if (binned != NULL && !NoRecursion)
+    {
+      SplitHistograms<UseWeights>(indices, labels, numClasses, weights,
+          *binned, childBegins, childCounts, minimumLeafSize, maximumDepth,
+          *histograms, childHistograms);
+    }
+
+    // Now build the children recursively.
+    const bool parallel = ParallelChildren &&
+        count >= MinimumParallelChildrenSize &&
+        count < MinimumParallelSplitSize;
+    std::vector<double> childGains(numChildren, 0.0);
+    TrainChildren(numChildren, parallel, [&](const size_t i)
+    {
+      // Each task needs its own dimension selector.
+      DimensionSelectionType childSelector(dimensionSelector);
+      childGains[i] = children[i]->Train<UseWeights>(data, indices,
+          childBegins[i], childCounts[i], datasetInfo, labels, numClasses,
+          weights, NoRecursion ? childCounts[i] : minimumLeafSize,
+          minimumGainSplit, maximumDepth - 1,
+          parallel ? childSelector : dimensionSelector, binned,
+          &childHistograms[i]);
+    });
+
+    // During recursion entropy of child node may change.
+    if (!NoRecursion)
+    {
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
+    }
+  }
+  else
+  {
+    // Clear auxiliary info objects.
+    NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
+    CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
+
+    // A leaf does not need its histograms anymore.
+    if (binned != NULL)
+      histograms->clear();
+
+    // Calculate class probabilities because we are a leaf.
+    CalculateClassProbabilities<UseWeights>(
+        labels.subvec(begin, begin + count - 1),
+        numClasses,
+        UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+  }
+
+  return -bestGain;
+}
+
+//! Return the class.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename VecType>
+size_t DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::Classify(const VecType& point) const
+{
+  if (children.size() == 0)
+  {
+    // Return cached max of probabilities.
+    return dimensionTypeOrMajorityClass;
+  }
+
+  return children[CalculateDirection(point)]->Classify(point);
+}
+
+//! Return class probabilities for a given point.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename VecType>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::Classify(const VecType& point,
+                                         size_t& prediction,
+                                         arma::vec& probabilities) const
+{
+  if (children.size() == 0)
+  {
+    prediction = dimensionTypeOrMajorityClass;
+    probabilities = classProbabilities;
+    return;
+  }
+
   children[CalculateDirection(point)]->Classify(point, prediction,
       probabilities);
 }
@@ -1047,7 +1210,8 @@ void DecisionTree<FitnessFunction,
   }
 
   // Loop over each point.
-  for (size_t i = 0; i < data.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
     predictions[i] = Classify(data.col(i));
 }
 
@@ -1083,7 +1247,8 @@ void DecisionTree<FitnessFunction,
     node = &node->Child(0);
   probabilities.set_size(node->classProbabilities.n_elem, data.n_cols);
 
-  for (size_t i = 0; i < data.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
   {
     arma::vec v = probabilities.unsafe_col(i); // Alias of column.
     Classify(data.col(i), predictions[i], v);
@@ -1167,6 +1332,554 @@ size_t DecisionTree<FitnessFunction,
     return children[0]->NumClasses();
 }
 
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::ParallelSplitSearch(
+    const MatType& data,
+    const arma::uvec* indices,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo* datasetInfo,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const std::vector<size_t>& dimensions,
+    size_t& bestDim,
+    double& bestGain)
+{
+  // The labels and weights of the points in this node are shared by all
+  // threads.
+  const arma::Row<size_t> nodeLabels = labels.subvec(begin, begin + count - 1);
+  arma::rowvec nodeWeights;
+  if (UseWeights)
+    nodeWeights = weights.subvec(begin, begin + count - 1);
+
+  // Evaluate each dimension against the gain of the node.  Each dimension gets
+  // its own split information.
+  const double nodeGain = bestGain;
+  std::vector<double> gains(dimensions.size());
+  std::vector<arma::vec> splitInfo(dimensions.size());
+  std::vector<NumericAuxiliarySplitInfo> numericAux(dimensions.size());
+  std::vector<CategoricalAuxiliarySplitInfo> categoricalAux(dimensions.size());
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t d = 0; d < (omp_size_t) dimensions.size(); ++d)
+  {
+    const size_t i = dimensions[d];
+    arma::Row<typename MatType::elem_type> dimData;
+    GatherDimension(data, indices, begin, count, i, dimData);
+    if (datasetInfo != NULL &&
+        datasetInfo->Type(i) == data::Datatype::categorical)
+    {
+      gains[d] = CategoricalSplit::template SplitIfBetter<UseWeights>(nodeGain,
+          dimData, datasetInfo->NumMappings(i), nodeLabels, numClasses,
+          nodeWeights, minimumLeafSize, minimumGainSplit, splitInfo[d],
+          categoricalAux[d]);
+    }
+    else
+    {
+      gains[d] = NumericSplit::template SplitIfBetter<UseWeights>(nodeGain,
+          dimData, nodeLabels, numClasses, nodeWeights, minimumLeafSize,
+          minimumGainSplit, splitInfo[d], numericAux[d]);
+    }
+  }
+
+  // Now visit the dimensions in the order serial training would, to pick the
+  // same split.
+  for (size_t d = 0; d < dimensions.size(); ++d)
+  {
+    // If the dimension could not improve on the gain of the node, it can't
+    // improve on the best gain so far either.
+    if (gains[d] == DBL_MAX)
+      continue;
+
+    const size_t i = dimensions[d];
+    const bool categorical = (datasetInfo != NULL &&
+        datasetInfo->Type(i) == data::Datatype::categorical);
+    if (bestGain != nodeGain)
+    {
+      // An earlier dimension already improved on the gain of the node.  If this
+      // dimension is clearly not better, serial training would not have split
+      // on it.  (The tolerance accounts for floating-point error in the
+      // splitters' comparisons.)
+      const double tolerance = 1e-10 * (1.0 + std::abs(bestGain));
+      if (gains[d] <= bestGain - tolerance)
+        continue;
+
+      // Otherwise, evaluate it again against the best gain so far, exactly as
+      // serial training does.
+      arma::Row<typename MatType::elem_type> dimData;
+      GatherDimension(data, indices, begin, count, i, dimData);
+      double dimGain;
+      if (categorical)
+      {
+        dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(
+            bestGain, dimData, datasetInfo->NumMappings(i), nodeLabels,
+            numClasses, nodeWeights, minimumLeafSize, minimumGainSplit,
+            classProbabilities, *this);
+      }
+      else
+      {
+        dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
+            dimData, nodeLabels, numClasses, nodeWeights, minimumLeafSize,
+            minimumGainSplit, classProbabilities, *this);
+      }
+
+      if (dimGain == DBL_MAX)
+        continue;
+
+      bestDim = i;
+      bestGain = dimGain;
+    }
+    else
+    {
+      // This is exactly the result serial training would get.
+      bestDim = i;
+      bestGain = gains[d];
+      classProbabilities = std::move(splitInfo[d]);
+      if (categorical)
+      {
+        CategoricalAuxiliarySplitInfo::operator=(
+            std::move(categoricalAux[d]));
+      }
+      else
+      {
+        NumericAuxiliarySplitInfo::operator=(std::move(numericAux[d]));
+      }
+    }
+
+    // If the gain is the best possible, no need to keep looking.
+    if (bestGain >= 0.0)
+      break;
+  }
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename MatType>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::GatherDimension(
+    const MatType& data,
+    const arma::uvec* indices,
+    const size_t begin,
+    const size_t count,
+    const size_t dimension,
+    arma::Row<typename MatType::elem_type>& dimData)
+{
+  if (indices == NULL)
+  {
+    dimData = data.cols(begin, begin + count - 1).row(dimension);
+    return;
+  }
+
+  dimData.set_size(count);
+  for (size_t j = 0; j < count; ++j)
+    dimData[j] = data(dimension, (*indices)[begin + j]);
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename MatType>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::BinData(
+    const MatType& data,
+    const data::DatasetInfo& datasetInfo,
+    BinnedData& binned)
+{
+  const arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols);
+  BinData(data, indices, 0, data.n_cols, datasetInfo, binned);
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename MatType>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::BinData(
+    const MatType& data,
+    const arma::uvec& indices,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo& datasetInfo,
+    BinnedData& binned)
+{
+  typedef HistogramNumericSplit<FitnessFunction> HistogramSplit;
+
+  binned.bins.set_size(data.n_cols, data.n_rows);
+  binned.boundaries.clear();
+  binned.boundaries.resize(data.n_rows);
+
+  #pragma omp parallel for schedule(dynamic) if (!InParallelRegion())
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_rows; ++i)
+  {
+    if (datasetInfo.Type(i) != data::Datatype::numeric)
+      continue;
+
+    arma::Row<typename MatType::elem_type> dimData;
+    GatherDimension(data, &indices, begin, count, i, dimData);
+
+    std::vector<typename MatType::elem_type> boundaries;
+    HistogramSplit::BinBoundaries(dimData, boundaries);
+    binned.boundaries[i].assign(boundaries.begin(), boundaries.end());
+
+    arma::Row<uint8_t> dimBins;
+    HistogramSplit::Bin(dimData, boundaries, dimBins);
+    uint8_t* bins = binned.bins.colptr(i);
+    for (size_t j = 0; j < count; ++j)
+      bins[indices[begin + j]] = dimBins[j];
+  }
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::BuildHistogram(
+    const arma::uvec& indices,
+    const size_t begin,
+    const size_t count,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    const BinnedData& binned,
+    const size_t dimension,
+    arma::mat& histogram)
+{
+  const uint8_t* bins = binned.bins.colptr(dimension);
+  arma::Row<uint8_t> nodeBins(count);
+  for (size_t j = 0; j < count; ++j)
+    nodeBins[j] = bins[indices[begin + j]];
+
+  HistogramNumericSplit<FitnessFunction>::template Histogram<UseWeights>(
+      nodeBins,
+      labels.subvec(begin, begin + count - 1),
+      numClasses,
+      UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+      binned.boundaries[dimension].size() + 1,
+      histogram);
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::HistogramSplitSearch(
+    const MatType& data,
+    const arma::uvec& indices,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo& datasetInfo,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const BinnedData& binned,
+    std::vector<arma::mat>& histograms,
+    DimensionSelectionType& dimensionSelector,
+    size_t& bestDim,
+    double& bestGain)
+{
+  std::vector<size_t> dimensions;
+  const size_t end = dimensionSelector.End();
+  for (size_t i = dimensionSelector.Begin(); i != end;
+       i = dimensionSelector.Next())
+    dimensions.push_back(i);
+
+  // The numeric split can't split a pure node or a node that is too small, so
+  // there is no need to build histograms for those.
+  const bool numericSplittable = (bestGain != 0.0 &&
+      count >= 2 * minimumLeafSize);
+  histograms.resize(data.n_rows);
+
+  // If this node is large, build the histograms it does not have yet in
+  // parallel.
+  if (numericSplittable && count >= MinimumParallelSplitSize &&
+      !InParallelRegion())
+  {
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t d = 0; d < (omp_size_t) dimensions.size(); ++d)
+    {
+      const size_t i = dimensions[d];
+      if (datasetInfo.Type(i) == data::Datatype::numeric &&
+          histograms[i].is_empty())
+      {
+        BuildHistogram<UseWeights>(indices, begin, count, labels, numClasses,
+            weights, binned, i, histograms[i]);
+      }
+    }
+  }
+
+  // Now evaluate the dimensions in order, exactly as without histograms.
+  arma::Row<typename MatType::elem_type> dimData;
+  for (size_t d = 0; d < dimensions.size(); ++d)
+  {
+    const size_t i = dimensions[d];
+    double dimGain = DBL_MAX;
+    if (datasetInfo.Type(i) == data::Datatype::categorical)
+    {
+      GatherDimension(data, &indices, begin, count, i, dimData);
+      dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
+          dimData,
+          datasetInfo.NumMappings(i),
+          labels.subvec(begin, begin + count - 1),
+          numClasses,
+          UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+          minimumLeafSize,
+          minimumGainSplit,
+          classProbabilities,
+          *this);
+    }
+    else if (numericSplittable &&
+        datasetInfo.Type(i) == data::Datatype::numeric)
+    {
+      if (histograms[i].is_empty())
+      {
+        BuildHistogram<UseWeights>(indices, begin, count, labels, numClasses,
+            weights, binned, i, histograms[i]);
+      }
+
+      dimGain = HistogramSplitIfBetter<UseWeights>(bestGain, histograms[i],
+          binned.boundaries[i], minimumLeafSize, minimumGainSplit);
+    }
+
+    // If the splitter reported that it did not split, move to the next
+    // dimension.
+    if (dimGain == DBL_MAX)
+      continue;
+
+    // Was there an improvement?  If so mark that it's the new best dimension.
+    bestDim = i;
+    bestGain = dimGain;
+
+    // If the gain is the best possible, no need to keep looking.
+    if (bestGain >= 0.0)
+      break;
+  }
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::SplitHistograms(
+    const arma::uvec& indices,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    const BinnedData& binned,
+    const std::vector<size_t>& childBegins,
+    const arma::Row<size_t>& childCounts,
+    const size_t minimumLeafSize,
+    const size_t maximumDepth,
+    std::vector<arma::mat>& histograms,
+    std::vector<std::vector<arma::mat>>& childHistograms)
+{
+  const size_t numChildren = childCounts.n_elem;
+
+  // Only children that may be split need histograms.
+  std::vector<bool> needed(numChildren);
+  bool anyNeeded = false;
+  for (size_t c = 0; c < numChildren; ++c)
+  {
+    needed[c] = (maximumDepth != 2 && childCounts[c] >= 2 * minimumLeafSize);
+    anyNeeded = anyNeeded || needed[c];
+  }
+
+  if (anyNeeded)
+  {
+    // The histograms of the largest child are obtained by subtraction, if it
+    // needs them; the histograms of its siblings then have to be built even if
+    // they will not be split.
+    const size_t largest = childCounts.index_max();
+    const bool subtract = needed[largest];
+    size_t buildCount = 0;
+    for (size_t c = 0; c < numChildren; ++c)
+    {
+      if (c != largest && (subtract || needed[c]))
+        buildCount += childCounts[c];
+      childHistograms[c].resize(histograms.size());
+    }
+
+    #pragma omp parallel for schedule(dynamic) \
+        if (buildCount >= MinimumParallelSplitSize && !InParallelRegion())
+    for (omp_size_t i = 0; i < (omp_size_t) histograms.size(); ++i)
+    {
+      if (histograms[i].is_empty())
+        continue;
+
+      for (size_t c = 0; c < numChildren; ++c)
+      {
+        if (c == largest || !(subtract || needed[c]))
+          continue;
+
+        BuildHistogram<UseWeights>(indices, childBegins[c], childCounts[c],
+            labels, numClasses, weights, binned, i, childHistograms[c][i]);
+      }
+
+      if (subtract)
+      {
+        arma::mat& histogram = childHistograms[largest][i];
+        histogram = histograms[i];
+        for (size_t c = 0; c < numChildren; ++c)
+        {
+          if (c != largest)
+            histogram -= childHistograms[c][i];
+        }
+      }
+    }
+
+    // Drop the histograms that were only built for the subtraction.
+    for (size_t c = 0; c < numChildren; ++c)
+    {
+      if (!needed[c])
+        childHistograms[c].clear();
+    }
+  }
+
+  // The node does not need its histograms anymore.
+  histograms.clear();
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename SplitType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::HistogramSplitIfBetter(
+    const double bestGain,
+    const arma::mat& histogram,
+    const std::vector<ElemType>& boundaries,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const std::enable_if_t<UsesHistograms<SplitType>::value>*)
+{
+  return SplitType::template SplitIfBetter<UseWeights>(bestGain, histogram,
+      boundaries, minimumLeafSize, minimumGainSplit, classProbabilities, *this);
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename TrainFunctionType>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::TrainChildren(const size_t numChildren,
+                                              const bool parallel,
+                                              const TrainFunctionType& train)
+{
+  // OpenMP tasks need OpenMP 3.0, which some compilers (e.g. MSVC) do not
+  // support; in that case the children are built one at a time.
+  #if defined(HAS_OPENMP) && (_OPENMP >= 200805)
+  if (parallel && numChildren > 1)
+  {
+    if (InParallelRegion())
+    {
+      for (size_t i = 0; i < numChildren; ++i)
+      {
+        #pragma omp task firstprivate(i) shared(train)
+        train(i);
+      }
+      #pragma omp taskwait
+    }
+    else
+    {
+      #pragma omp parallel
+      {
+        #pragma omp single
+        {
+          for (size_t i = 0; i < numChildren; ++i)
+          {
+            #pragma omp task firstprivate(i) shared(train)
+            train(i);
+          }
+          #pragma omp taskwait
+        }
+      }
+    }
+    return;
+  }
+  #else
+  (void) parallel;
+  #endif
+
+  for (size_t i = 0; i < numChildren; ++i)
+    train(i);
+}
+
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
@@ -0,0 +1,218 @@
+/**
+ * @file methods/decision_tree/histogram_numeric_split.hpp
+ *
+ * A tree splitter that finds the best binary numeric split by first
+ * quantizing the dimension into a small number of quantile bins, and then
+ * searching only the bin boundaries.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The HistogramNumericSplit is a splitting function for decision trees that
+ * approximates the search performed by BestBinaryNumericSplit.  Instead of
+ * sorting the points in the dimension, the values are mapped to at most
+ * MaxBins quantile bins (so that each bin index fits in a uint8_t), a
+ * histogram of class counts (or class weight sums) is built for each bin, and
+ * only the bin boundaries are considered as split points.  The statistics of
+ * the right child at every boundary are obtained by subtracting the running
+ * left-hand statistics from the node totals, so each candidate costs
+ * O(numClasses) instead of a pass over the points.
+ *
+ * The quantile boundaries are estimated from a strided subsample of at most
+ * MaxSampleSize points.  When a dimension holds fewer than MaxBins distinct
+ * values in the subsample, every distinct value becomes its own bin and the
+ * search is exact (although the split value will be the left-hand value itself
+ * rather than the midpoint).
+ *
+ * DecisionTree (and so RandomForest) recognizes this splitter through
+ * UsesHistograms: each numeric dimension is then binned once for the whole
+ * tree, every node builds the histograms of its points from the bins in
+ * O(n), and the histograms of the larger child of a split are obtained by
+ * subtracting those of the smaller child from the histograms of the parent.
+ * When SplitIfBetter() is called on the values of a dimension instead, the
+ * bins are computed for that call, in O(n log MaxBins).
+ *
+ * @tparam FitnessFunction Fitness function to use to calculate gain.
+ */
+template<typename FitnessFunction>
+class HistogramNumericSplit
+{
+ public:
+  //! The maximum number of bins a dimension is quantized into.
+  static constexpr size_t MaxBins = 256;
+  //! The maximum number of points used to estimate the bin boundaries.
+  static constexpr size_t MaxSampleSize = 16384;
+
+  // No extra info needed for split.
+  template<typename ElemType>
+  class AuxiliarySplitInfo { };
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return DBL_MAX.  If a split is made, then classProbabilities and aux may be
+   * modified.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights associated with labels.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param classProbabilities Class probabilities vector, which may be filled
+   *      with split information a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::Col<typename VecType::elem_type>& classProbabilities,
+      AuxiliarySplitInfo<typename VecType::elem_type>& aux);
+
+  /**
+   * Check if we can split a node, given the histogram of a dimension of the
+   * node built by Histogram() and the bin boundaries the histogram was built
+   * with.  If we can split a node in a way that improves on 'bestGain', then we
+   * return the improved gain.  Otherwise we return DBL_MAX.  If a split is
+   * made, then classProbabilities and aux may be modified.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param histogram Histogram of the dimension for the points of the node.
+   * @param boundaries Bin boundaries of the dimension.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param classProbabilities Class probabilities vector, which may be filled
+   *      with split information a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename ElemType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const arma::mat& histogram,
+      const std::vector<ElemType>& boundaries,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::Col<ElemType>& classProbabilities,
+      AuxiliarySplitInfo<ElemType>& aux);
+
+  /**
+   * Build the histogram of a dimension: column b holds the count (or the
+   * weight sum, if UseWeights is true) of each class in bin b, followed by
+   * the number of points in bin b.
+   *
+   * @param bins Bin of each point, computed by Bin().
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights associated with labels.
+   * @param numBins Number of bins of the dimension.
+   * @param histogram Matrix to store the histogram in.
+   */
+  template<bool UseWeights, typename BinVecType, typename LabelsType,
+           typename WeightVecType>
+  static void Histogram(const BinVecType& bins,
+                        const LabelsType& labels,
+                        const size_t numClasses,
+                        const WeightVecType& weights,
+                        const size_t numBins,
+                        arma::mat& histogram);
+
+  /**
+   * Compute the (sorted, unique) upper boundaries of the quantile bins for the
+   * given dimension.  At most MaxBins - 1 boundaries are returned; a value x
+   * belongs to the first bin whose boundary is greater than or equal to x, or
+   * to the last bin if x is greater than every boundary.
+   *
+   * @param data The dimension of data points to compute bin boundaries for.
+   * @param boundaries Vector to store the bin boundaries in.
+   */
+  template<typename VecType>
+  static void BinBoundaries(
+      const VecType& data,
+      std::vector<typename VecType::elem_type>& boundaries);
+
+  /**
+   * Map each value in the given dimension to its bin, using the boundaries
+   * computed by BinBoundaries().
+   *
+   * @param data The dimension of data points to quantize.
+   * @param boundaries Bin boundaries computed by BinBoundaries().
+   * @param bins Vector to store the bin index of each point in.
+   */
+  template<typename VecType>
+  static void Bin(const VecType& data,
+                  const std::vector<typename VecType::elem_type>& boundaries,
+                  arma::Row<uint8_t>& bins);
+
+  /**
+   * Returns 2, since the binary split always has two children.
+   */
+  template<typename ElemType>
+  static size_t NumChildren(const arma::Col<ElemType>& /* classProbabilities */,
+                            const AuxiliarySplitInfo<ElemType>& /* aux */)
+  {
+    return 2;
+  }
+
+  /**
+   * Given a point, calculate which child it should go to (left or right).
+   *
+   * @param point Point to calculate direction of.
+   * @param classProbabilities Auxiliary information for the split.
+   * @param * (aux) Auxiliary information for the split (Unused).
+   */
+  template<typename ElemType>
+  static size_t CalculateDirection(
+      const ElemType& point,
+      const arma::Col<ElemType>& classProbabilities,
+      const AuxiliarySplitInfo<ElemType>& /* aux */);
+};
+
+/**
+ * UsesHistograms<NumericSplitType>::value is true if DecisionTree should bin
+ * each numeric dimension once per tree and hand the numeric split type the
+ * histogram of each dimension of a node (see HistogramNumericSplit), instead of
+ * the values of the dimension.
+ */
+template<typename NumericSplitType>
+struct UsesHistograms
+{
+  static const bool value = false;
+};
+
+template<typename FitnessFunction>
+struct UsesHistograms<HistogramNumericSplit<FitnessFunction>>
+{
+  static const bool value = true;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "histogram_numeric_split_impl.hpp"
+
+#endif
@@ -0,0 +1,258 @@
+/**
+ * @file methods/decision_tree/histogram_numeric_split_impl.hpp
+ *
+ * Implementation of strategy that finds the best binary numeric split using
+ * quantile histograms.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+
+namespace mlpack {
+namespace tree {
+
+// Out-of-class definitions of the static constants (needed if odr-used).
+template<typename FitnessFunction>
+constexpr size_t HistogramNumericSplit<FitnessFunction>::MaxBins;
+
+template<typename FitnessFunction>
+constexpr size_t HistogramNumericSplit<FitnessFunction>::MaxSampleSize;
+
+template<typename FitnessFunction>
+template<typename VecType>
+void HistogramNumericSplit<FitnessFunction>::BinBoundaries(
+    const VecType& data,
+    std::vector<typename VecType::elem_type>& boundaries)
+{
+  typedef typename VecType::elem_type ElemType;
+
+  boundaries.clear();
+  if (data.n_elem == 0)
+    return;
+
+  // Take a strided subsample of the points, so that the cost of estimating the
+  // quantiles does not depend on the number of points.
+  const size_t stride = (data.n_elem + MaxSampleSize - 1) / MaxSampleSize;
+  std::vector<ElemType> sample;
+  sample.reserve(data.n_elem / stride + 1);
+  for (size_t i = 0; i < data.n_elem; i += stride)
+    sample.push_back(data[i]);
+  std::sort(sample.begin(), sample.end());
+
+  // The k'th boundary is the largest sampled value below the k'th quantile.
+  // Duplicate boundaries are dropped, and so is the maximum sampled value,
+  // since nothing in the sample could go to the right of it.
+  const size_t sampleSize = sample.size();
+  for (size_t k = 1; k < MaxBins; ++k)
+  {
+    const size_t index = (k * sampleSize) / MaxBins;
+    if (index == 0)
+      continue;
+
+    const ElemType value = sample[index - 1];
+    if (value == sample[sampleSize - 1])
+      break;
+    if (boundaries.empty() || value > boundaries.back())
+      boundaries.push_back(value);
+  }
+}
+
+template<typename FitnessFunction>
+template<typename VecType>
+void HistogramNumericSplit<FitnessFunction>::Bin(
+    const VecType& data,
+    const std::vector<typename VecType::elem_type>& boundaries,
+    arma::Row<uint8_t>& bins)
+{
+  bins.set_size(data.n_elem);
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    bins[i] = (uint8_t) (std::lower_bound(boundaries.begin(), boundaries.end(),
+        data[i]) - boundaries.begin());
+  }
+}
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename BinVecType, typename LabelsType,
+         typename WeightVecType>
+void HistogramNumericSplit<FitnessFunction>::Histogram(
+    const BinVecType& bins,
+    const LabelsType& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t numBins,
+    arma::mat& histogram)
+{
+  histogram.zeros(numClasses + 1, numBins);
+  for (size_t i = 0; i < bins.n_elem; ++i)
+  {
+    double* binColumn = histogram.colptr(bins[i]);
+    if (UseWeights)
+      binColumn[labels[i]] += weights[i];
+    else
+      binColumn[labels[i]] += 1.0;
+    binColumn[numClasses] += 1.0;
+  }
+}
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename WeightVecType>
+double HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<typename VecType::elem_type>& classProbabilities,
+    AuxiliarySplitInfo<typename VecType::elem_type>& aux)
+{
+  typedef typename VecType::elem_type ElemType;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  // Quantize the dimension.  If there are no boundaries, all the points have
+  // the same value (at least in the sample), and we can't split.
+  std::vector<ElemType> boundaries;
+  BinBoundaries(data, boundaries);
+  if (boundaries.empty())
+    return DBL_MAX;
+
+  arma::Row<uint8_t> bins;
+  Bin(data, boundaries, bins);
+
+  arma::mat histogram;
+  Histogram<UseWeights>(bins, labels, numClasses, weights,
+      boundaries.size() + 1, histogram);
+
+  return SplitIfBetter<UseWeights>(bestGain, histogram, boundaries,
+      minimumLeafSize, minimumGainSplit, classProbabilities, aux);
+}
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename ElemType>
+double HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const arma::mat& histogram,
+    const std::vector<ElemType>& boundaries,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<ElemType>& classProbabilities,
+    AuxiliarySplitInfo<ElemType>& /* aux */)
+{
+  const size_t numClasses = histogram.n_rows - 1;
+  const size_t numBins = histogram.n_cols;
+
+  // The last row of the histogram holds the number of points in each bin.
+  const arma::rowvec binCounts = histogram.row(numClasses);
+  const size_t numPoints = (size_t) arma::accu(binCounts);
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (numPoints < (minimumLeafSize * 2) || numBins < 2)
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  // Loop through all bin boundaries, choosing the best one.  Also, force a
+  // minimum leaf size of 1 (empty children don't make sense).
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bool improved = false;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  // The statistics of the right child are always the node totals minus the
+  // statistics of the left child, so we only need to keep running sums for
+  // the left child.  Without weights, the class rows hold counts.
+  const arma::vec totalSums = arma::sum(
+      histogram.rows(0, numClasses - 1), 1);
+  const double totalWeight = UseWeights ? arma::accu(totalSums) : numPoints;
+  arma::vec leftSums(numClasses, arma::fill::zeros);
+  arma::vec rightSums(numClasses);
+  bestFoundGain *= totalWeight;
+
+  size_t leftCount = 0;
+  for (size_t bin = 0; bin < numBins - 1; ++bin)
+  {
+    // Move the points of this bin to the left child.
+    const size_t binCount = (size_t) binCounts[bin];
+    leftCount += binCount;
+    leftSums += histogram.unsafe_col(bin).subvec(0, numClasses - 1);
+
+    // Make sure that both children are large enough.
+    if (leftCount < minimum)
+      continue;
+    const size_t rightCount = numPoints - leftCount;
+    if (rightCount < minimum)
+      break;
+
+    // Skip empty bins: they would give the same split as the previous one.
+    if (binCount == 0)
+      continue;
+
+    // Calculate the gain for the left and right child.
+    rightSums = totalSums - leftSums;
+    const double totalLeftWeight = UseWeights ? arma::accu(leftSums) :
+        leftCount;
+    const double totalRightWeight = UseWeights ? totalWeight - totalLeftWeight :
+        rightCount;
+    const double leftGain = FitnessFunction::template EvaluatePtr<UseWeights>(
+        leftSums.memptr(), numClasses, totalLeftWeight);
+    const double rightGain = FitnessFunction::template EvaluatePtr<UseWeights>(
+        rightSums.memptr(), numClasses, totalRightWeight);
+    const double gain = totalLeftWeight * leftGain +
+        totalRightWeight * rightGain;
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      // We can take a shortcut: no split will be better than this, so just take
+      // this one.  Everything less than or equal to the upper boundary of the
+      // bin goes left.
+      classProbabilities.set_size(1);
+      classProbabilities[0] = boundaries[bin];
+
+      return gain;
+    }
+    else if (gain > bestFoundGain)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      classProbabilities.set_size(1);
+      classProbabilities[0] = boundaries[bin];
+      improved = true;
+    }
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (!improved)
+    return DBL_MAX;
+
+  return bestFoundGain / totalWeight;
+}
+
+template<typename FitnessFunction>
+template<typename ElemType>
+size_t HistogramNumericSplit<FitnessFunction>::CalculateDirection(
+    const ElemType& point,
+    const arma::Col<ElemType>& classProbabilities,
+    const AuxiliarySplitInfo<ElemType>& /* aux */)
+{
+  if (point <= classProbabilities[0])
+    return 0; // Go left.
+  else
+    return 1; // Go right.
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -98,6 +98,39 @@ double DiagonalGMM::Probability(const arma::vec& observation,
   return exp(LogProbability(observation, component));
 }
 
+/**
+ * Compute the log probability of each observation being from each component in
+ * the mixture.
+ */
+void DiagonalGMM::LogProbability(const arma::mat& observations,
+                                 arma::mat& logProbabilities,
+                                 arma::mat& workspace) const
+{
+  logProbabilities.set_size(observations.n_cols, gaussians);
+  for (size_t j = 0; j < gaussians; ++j)
+  {
+    // Write the log probabilities of component j directly into an alias of
+    // its column.
+    arma::vec logProbAlias = logProbabilities.unsafe_col(j);
+    dists[j].LogProbability(observations, logProbAlias, workspace);
+    logProbAlias += log(weights[j]);
+  }
+}
+
+/**
+ * Compute the log probability of each observation being from this mixture.
+ */
+void DiagonalGMM::LogProbability(const arma::mat& observations,
+                                 arma::vec& logProbabilities) const
+{
+  arma::mat componentLogProbs, workspace;
+  LogProbability(observations, componentLogProbs, workspace);
+
+  logProbabilities.set_size(observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+    logProbabilities[i] = math::AccuLog(componentLogProbs.row(i));
+}
+
 /**
  * Return a randomly generated observation according to the probability
  * distribution defined by this object.
@@ -130,7 +163,11 @@ arma::vec DiagonalGMM::Random() const
 void DiagonalGMM::Classify(const arma::mat& observations,
                            arma::Row<size_t>& labels) const
 {
-  // This is not the best way to do this!
+  // Compute the log probabilities of every point under every component at
+  // once.  We have to use log probabilities, otherwise the probabilities
+  // would underflow easily.
+  arma::mat logProbabilities, workspace;
+  LogProbability(observations, logProbabilities, workspace);
 
   // We should not have to fill this with values, because each one should be
   // overwritten.
@@ -138,13 +175,12 @@ void DiagonalGMM::Classify(const arma::mat& observations,
   for (size_t i = 0; i < observations.n_cols; ++i)
   {
     // Find maximum probability component.
-    double probability = 0;
+    double probability = -std::numeric_limits<double>::infinity();
     for (size_t j = 0; j < gaussians; ++j)
     {
-      double newProb = Probability(observations.unsafe_col(i), j);
-      if (newProb >= probability)
+      if (logProbabilities(i, j) >= probability)
       {
-        probability = newProb;
+        probability = logProbabilities(i, j);
         labels[i] = j;
       }
     }
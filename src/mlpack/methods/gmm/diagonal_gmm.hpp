@@ -193,6 +193,34 @@ class DiagonalGMM
    */
   double LogProbability(const arma::vec& observation,
                         const size_t component) const;
+
+  /**
+   * Compute the log probability of each observation in the given matrix under
+   * every component of this distribution, including the prior weight of each
+   * component.  Element (i, j) of logProbabilities is the log probability of
+   * observation i coming from component j.  All points are evaluated against
+   * one component at a time with a single matrix product, and the workspace is
+   * shared between components, so repeated calls with the same number of
+   * points do not allocate memory.
+   *
+   * @param observations Matrix of observations to evaluate.
+   * @param logProbabilities Output matrix of size (observations.n_cols,
+   *     Gaussians()).
+   * @param workspace Matrix for intermediate results, owned by the caller.
+   */
+  void LogProbability(const arma::mat& observations,
+                      arma::mat& logProbabilities,
+                      arma::mat& workspace) const;
+
+  /**
+   * Compute the log probability of each observation in the given matrix
+   * coming from this distribution.
+   *
+   * @param observations Matrix of observations to evaluate.
+   * @param logProbabilities Output log probabilities for each observation.
+   */
+  void LogProbability(const arma::mat& observations,
+                      arma::vec& logProbabilities) const;
   /**
    * Return a randomly generated observation according to the probability
    * distribution defined by this object.
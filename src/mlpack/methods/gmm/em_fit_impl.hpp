@@ -79,6 +79,11 @@ Estimate(const arma::mat& observations,
   double lOld = -DBL_MAX;
   arma::mat condLogProb(observations.n_cols, dists.size());
 
+  // Scratch space for the log probability computations; it is shared by all
+  // components and reused across iterations, so that no temporaries are
+  // allocated for the E-step.
+  arma::mat workspace;
+
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
   while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
@@ -93,7 +98,7 @@ Estimate(const arma::mat& observations,
       // Store conditional log probabilities into condLogProb vector for each
       // Gaussian.  First we make an alias of the condLogProb vector.
       arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
+      dists[i].LogProbability(observations, condLogProbAlias, workspace);
       condLogProbAlias += log(weights[i]);
     }
 
@@ -187,6 +192,11 @@ Estimate(const arma::mat& observations,
   double lOld = -DBL_MAX;
   arma::mat condLogProb(observations.n_cols, dists.size());
 
+  // Scratch space for the log probability computations; it is shared by all
+  // components and reused across iterations, so that no temporaries are
+  // allocated for the E-step.
+  arma::mat workspace;
+
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
   while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
@@ -198,7 +208,7 @@ Estimate(const arma::mat& observations,
       // Store conditional log probabilities into condLogProb vector for each
       // Gaussian.  First we make an alias of the condLogProb vector.
       arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
+      dists[i].LogProbability(observations, condLogProbAlias, workspace);
       condLogProbAlias += log(weights[i]);
     }
 
@@ -384,12 +394,13 @@ LogLikelihood(const arma::mat& observations,
   double logLikelihood = 0;
 
   arma::vec logPhis;
+  arma::mat workspace;
   arma::mat logLikelihoods(dists.size(), observations.n_cols);
 
   // It has to be LogProbability() otherwise Probability() would overflow easily
   for (size_t i = 0; i < dists.size(); ++i)
   {
-    dists[i].LogProbability(observations, logPhis);
+    dists[i].LogProbability(observations, logPhis, workspace);
     logLikelihoods.row(i) = log(weights(i)) + trans(logPhis);
   }
   // Now sum over every point.
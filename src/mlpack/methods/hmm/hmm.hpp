@@ -40,6 +40,13 @@ namespace hmm /** Hidden Markov Models. */ {
  *   // Return the probability of the given observation.
  *   double Probability(const DataType& observation) const;
  *
+ *   // Return the log probability of the given observation.
+ *   double LogProbability(const DataType& observation) const;
+ *
+ *   // Compute the log probability of each of the given observations (columns).
+ *   void LogProbability(const arma::mat& observations,
+ *                       arma::vec& logProbabilities) const;
+ *
  *   // Estimate the distribution based on the given observations.
  *   double Train(const std::vector<DataType>& observations);
  *
@@ -163,6 +170,12 @@ class HMM
    * is called, it uses the current parameters of the HMM as a starting point
    * for training.
    *
+   * @note
+   * If mlpack is compiled with OpenMP, the forward-backward pass over each
+   * sequence is run in parallel, and the sufficient statistics collected by
+   * each thread are combined in a fixed order.  For a fixed number of threads,
+   * the result of training is therefore deterministic.
+   *
    * @param dataSeq Vector of observation sequences.
    * @return Log-likelihood of state sequence.
    */
@@ -282,6 +295,21 @@ class HMM
   double Predict(const arma::mat& dataSeq,
                  arma::Row<size_t>& stateSeq) const;
 
+  /**
+   * Compute the most probable hidden state sequence for each of the given data
+   * sequences, using the Viterbi algorithm.  If mlpack is compiled with OpenMP,
+   * the sequences are processed in parallel.
+   *
+   * @param dataSeq Vector of observation sequences.
+   * @param stateSeq Vector in which the most probable state sequence for each
+   *    observation sequence will be stored.
+   * @param logLikelihoods Vector in which the log-likelihood of the most
+   *    probable state sequence of each observation sequence will be stored.
+   */
+  void Predict(const std::vector<arma::mat>& dataSeq,
+               std::vector<arma::Row<size_t>>& stateSeq,
+               arma::vec& logLikelihoods) const;
+
   /**
    * Compute the log-likelihood of the given data sequence.
    *
@@ -290,6 +318,31 @@ class HMM
    */
   double LogLikelihood(const arma::mat& dataSeq) const;
 
+  /**
+   * Compute the log-likelihood of each of the given data sequences.  If mlpack
+   * is compiled with OpenMP, the sequences are processed in parallel.
+   *
+   * @param dataSeq Vector of data sequences to evaluate the likelihood of.
+   * @param logLikelihoods Vector in which the log-likelihood of each sequence
+   *    will be stored.
+   */
+  void LogLikelihood(const std::vector<arma::mat>& dataSeq,
+                     arma::vec& logLikelihoods) const;
+
+  /**
+   * Compute the log probability of each observation in the given data sequence
+   * under the emission distribution of each hidden state.  The emission
+   * distributions are evaluated on the whole sequence at once.  The returned
+   * matrix has rows equal to the number of hidden states and columns equal to
+   * the number of observations; it can be used with EmissionLogLikelihood().
+   *
+   * @param dataSeq Sequence of observations.
+   * @param emissionLogProb Matrix in which the emission log probabilities will
+   *    be stored.
+   */
+  void EmissionLogProbability(const arma::mat& dataSeq,
+                              arma::mat& emissionLogProb) const;
+
   /**
    * Compute the log of the scaling factor of the given emission probability
    * at time t. To calculate the log-likelihood for the whole sequence,
@@ -493,6 +546,42 @@ class HMM
                 const arma::vec& logScales,
                 arma::mat& backwardLogProb) const;
 
+  /**
+   * The Forward algorithm, given the emission log probabilities of each state
+   * for each observation (as computed by EmissionLogProbability()).
+   *
+   * @param emissionLogProb Emission log probabilities of the data sequence.
+   * @param logScales Vector in which the log of scaling factors will be saved.
+   * @param forwardLogProb Matrix in which forward probabilities will be saved.
+   */
+  void ForwardFromEmission(const arma::mat& emissionLogProb,
+                           arma::vec& logScales,
+                           arma::mat& forwardLogProb) const;
+
+  /**
+   * The Backward algorithm, given the emission log probabilities of each state
+   * for each observation (as computed by EmissionLogProbability()).
+   *
+   * @param emissionLogProb Emission log probabilities of the data sequence.
+   * @param logScales Vector of log of scaling factors.
+   * @param backwardLogProb Matrix to store the backward probabilities in.
+   */
+  void BackwardFromEmission(const arma::mat& emissionLogProb,
+                            const arma::vec& logScales,
+                            arma::mat& backwardLogProb) const;
+
+  /**
+   * The Viterbi algorithm, given the emission log probabilities of each state
+   * for each observation (as computed by EmissionLogProbability()).
+   *
+   * @param emissionLogProb Emission log probabilities of the data sequence.
+   * @param stateSeq Vector in which the most probable state sequence will be
+   *    stored.
+   * @return Log-likelihood of most probable state sequence.
+   */
+  double PredictFromEmission(const arma::mat& emissionLogProb,
+                             arma::Row<size_t>& stateSeq) const;
+
   //! Set of emission probability distributions; one for each state.
   std::vector<Distribution> emission;
 
@@ -101,10 +101,14 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   // Maximum iterations?
   size_t iterations = 1000;
 
-  // Find length of all sequences and ensure they are the correct size.
+  // Find length of all sequences and ensure they are the correct size.  We also
+  // store the offset of each sequence in the list of emissions, so that each
+  // sequence can be processed independently of the others.
   size_t totalLength = 0;
+  std::vector<size_t> seqOffsets(dataSeq.size());
   for (size_t seq = 0; seq < dataSeq.size(); seq++)
   {
+    seqOffsets[seq] = totalLength;
     totalLength += dataSeq[seq].n_cols;
 
     if (dataSeq[seq].n_rows != dimensionality)
@@ -114,39 +118,83 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   }
 
   // These are used later for training of each distribution.  We initialize it
-  // all now so we don't have to do any allocation later on.
+  // all now so we don't have to do any allocation later on.  The list of
+  // emission observations does not change between iterations, so we fill it
+  // only once.
   std::vector<arma::vec> emissionProb(logTransition.n_cols,
       arma::vec(totalLength));
   arma::mat emissionList(dimensionality, totalLength);
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    if (dataSeq[seq].n_cols > 0)
+    {
+      emissionList.cols(seqOffsets[seq],
+          seqOffsets[seq] + dataSeq[seq].n_cols - 1) = dataSeq[seq];
+    }
+  }
+
+  // The sequences are processed in parallel.  Each thread accumulates the
+  // sufficient statistics for the sequences it is given into its own
+  // accumulators, and these are reduced in thread order after all sequences
+  // are processed.  Since the sequences are statically scheduled, the result
+  // is deterministic for a given number of threads.
+  #ifdef HAS_OPENMP
+    const size_t numThreads = (size_t) omp_get_max_threads();
+  #else
+    const size_t numThreads = 1;
+  #endif
+  std::vector<arma::vec> threadLogInitial(numThreads);
+  std::vector<arma::mat> threadLogTransition(numThreads);
+  arma::vec threadLoglik(numThreads);
 
   // This should be the Baum-Welch algorithm (EM for HMM estimation). This
   // follows the procedure outlined in Elliot, Aggoun, and Moore's book "Hidden
   // Markov Models: Estimation and Control", pp. 36-40.
   for (size_t iter = 0; iter < iterations; iter++)
   {
-    // Clear new transition matrix and emission probabilities.
-    arma::vec newLogInitial(logTransition.n_rows);
-    newLogInitial.fill(-std::numeric_limits<double>::infinity());
-    arma::mat newLogTransition(logTransition.n_rows, logTransition.n_cols);
-    newLogTransition.fill(-std::numeric_limits<double>::infinity());
+    // Make sure the log-space parameters are up to date before the threads
+    // start reading them.
+    ConvertToLogSpace();
 
-    // Reset log likelihood.
-    loglik = 0;
-
-    // Sum over time.
-    size_t sumTime = 0;
+    // Clear the accumulators of each thread.
+    for (size_t thread = 0; thread < numThreads; ++thread)
+    {
+      threadLogInitial[thread].set_size(logTransition.n_rows);
+      threadLogInitial[thread].fill(-std::numeric_limits<double>::infinity());
+      threadLogTransition[thread].set_size(logTransition.n_rows,
+          logTransition.n_cols);
+      threadLogTransition[thread].fill(
+          -std::numeric_limits<double>::infinity());
+    }
+    threadLoglik.zeros();
 
     // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); seq++)
     {
-      arma::mat stateLogProb;
+      #ifdef HAS_OPENMP
+        const size_t thread = (size_t) omp_get_thread_num();
+      #else
+        const size_t thread = 0;
+      #endif
+      arma::vec& newLogInitial = threadLogInitial[thread];
+      arma::mat& newLogTransition = threadLogTransition[thread];
+
+      arma::mat emissionLogProb;
       arma::mat forwardLog;
       arma::mat backwardLog;
       arma::vec logScales;
 
+      // Compute the emission log probabilities of the whole sequence once;
+      // they are needed by the forward and backward passes and by the
+      // re-estimation of the transition matrix.
+      EmissionLogProbability(dataSeq[seq], emissionLogProb);
+      ForwardFromEmission(emissionLogProb, logScales, forwardLog);
+      BackwardFromEmission(emissionLogProb, logScales, backwardLog);
+      const arma::mat stateLogProb = forwardLog + backwardLog;
+
       // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += LogEstimate(dataSeq[seq], stateLogProb, forwardLog,
-          backwardLog, logScales);
+      threadLoglik[thread] += arma::accu(logScales);
 
       // Add to estimate of initial probability for state j.
       for (size_t j = 0; j < logTransition.n_cols; ++j)
@@ -170,19 +218,36 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
             {
               newLogTransition(i, j) = math::LogAdd(newLogTransition(i, j),
                   forwardLog(j, t) + backwardLog(i, t + 1) +
-                  emission[i].LogProbability(dataSeq[seq].unsafe_col(t + 1)) -
-                  logScales[t + 1]);
+                  emissionLogProb(i, t + 1) - logScales[t + 1]);
             }
           }
 
-          // Add to list of emission observations, for Distribution::Train().
-          emissionList.col(sumTime) = dataSeq[seq].col(t);
-          emissionProb[j][sumTime] = exp(stateLogProb(j, t));
+          // Add to the weights of the emission observations, for
+          // Distribution::Train().  Each sequence writes to its own range.
+          emissionProb[j][seqOffsets[seq] + t] = exp(stateLogProb(j, t));
         }
-        sumTime++;
       }
     }
 
+    // Reduce the statistics of each thread, in a fixed order.
+    arma::vec newLogInitial = threadLogInitial[0];
+    arma::mat newLogTransition = threadLogTransition[0];
+    for (size_t thread = 1; thread < numThreads; ++thread)
+    {
+      for (size_t j = 0; j < newLogInitial.n_elem; ++j)
+      {
+        newLogInitial[j] = math::LogAdd(newLogInitial[j],
+            threadLogInitial[thread][j]);
+      }
+
+      for (size_t j = 0; j < newLogTransition.n_elem; ++j)
+      {
+        newLogTransition[j] = math::LogAdd(newLogTransition[j],
+            threadLogTransition[thread][j]);
+      }
+    }
+    loglik = arma::accu(threadLoglik);
+
     if (std::abs(oldLoglik - loglik) < tolerance)
     {
       Log::Debug << "Converged after " << iter << " iterations." << std::endl;
@@ -338,8 +403,10 @@ double HMM<Distribution>::LogEstimate(const arma::mat& dataSeq,
                                       arma::vec& logScales) const
 {
   // First run the forward-backward algorithm.
-  Forward(dataSeq, logScales, forwardLogProb);
-  Backward(dataSeq, logScales, backwardLogProb);
+  arma::mat emissionLogProb;
+  EmissionLogProbability(dataSeq, emissionLogProb);
+  ForwardFromEmission(emissionLogProb, logScales, forwardLogProb);
+  BackwardFromEmission(emissionLogProb, logScales, backwardLogProb);
 
   // Now assemble the state probability matrix based on the forward and backward
   // probabilities.
@@ -457,54 +524,105 @@ void HMM<Distribution>::Generate(const size_t length,
 template<typename Distribution>
 double HMM<Distribution>::Predict(const arma::mat& dataSeq,
                                   arma::Row<size_t>& stateSeq) const
+{
+  arma::mat emissionLogProb;
+  EmissionLogProbability(dataSeq, emissionLogProb);
+
+  return PredictFromEmission(emissionLogProb, stateSeq);
+}
+
+/**
+ * Compute the most probable hidden state sequence for each of the given
+ * observation sequences using the Viterbi algorithm.
+ */
+template<typename Distribution>
+void HMM<Distribution>::Predict(const std::vector<arma::mat>& dataSeq,
+                                std::vector<arma::Row<size_t>>& stateSeq,
+                                arma::vec& logLikelihoods) const
+{
+  stateSeq.resize(dataSeq.size());
+  logLikelihoods.set_size(dataSeq.size());
+
+  // Make sure the log-space parameters are up to date before the threads start
+  // reading them.
+  ConvertToLogSpace();
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); ++seq)
+    logLikelihoods[seq] = Predict(dataSeq[seq], stateSeq[seq]);
+}
+
+/**
+ * The Viterbi algorithm, given the emission log probabilities.
+ */
+template<typename Distribution>
+double HMM<Distribution>::PredictFromEmission(
+    const arma::mat& emissionLogProb,
+    arma::Row<size_t>& stateSeq) const
 {
   // This is an implementation of the Viterbi algorithm for finding the most
-  // probable sequence of states to produce the observed data sequence.  We
-  // don't use log-likelihoods to save that little bit of time, but we'll
-  // calculate the log-likelihood at the end of it all.
-  stateSeq.set_size(dataSeq.n_cols);
-  arma::mat logStateProb(logTransition.n_rows, dataSeq.n_cols);
-  arma::mat stateSeqBack(logTransition.n_rows, dataSeq.n_cols);
+  // probable sequence of states to produce the observed data sequence.  All
+  // computations are done in log-space, so each step is a max-plus product of
+  // the previous state probabilities with the transition matrix.
+  const size_t numStates = logTransition.n_rows;
+  const size_t length = emissionLogProb.n_cols;
+  stateSeq.set_size(length);
+  arma::mat logStateProb(numStates, length);
+  arma::Mat<size_t> stateSeqBack(numStates, length);
 
   ConvertToLogSpace();
 
+  // Column j of the transposed transition matrix holds the log probabilities
+  // of transitioning into state j, so the inner loop below reads contiguous
+  // memory.
+  const arma::mat logTransitionT = logTransition.t();
+
   // The calculation of the first state is slightly different; the probability
   // of the first state being state j is the maximum probability that the state
   // came to be j from another state.
-  logStateProb.col(0).zeros();
-  for (size_t state = 0; state < logTransition.n_rows; state++)
+  for (size_t state = 0; state < numStates; state++)
   {
-    logStateProb(state, 0) = logInitial[state] +
-        emission[state].LogProbability(dataSeq.unsafe_col(0));
+    logStateProb(state, 0) = logInitial[state] + emissionLogProb(state, 0);
     stateSeqBack(state, 0) = state;
   }
 
-  // Store the best first state.
-  arma::uword index;
-  for (size_t t = 1; t < dataSeq.n_cols; t++)
+  for (size_t t = 1; t < length; t++)
   {
-    // Assemble the state probability for this element.
-    // Given that we are in state j, we use state with the highest probability
-    // of being the previous state.
-    for (size_t j = 0; j < logTransition.n_rows; j++)
+    // Assemble the state probability for this element.  Given that we are in
+    // state j, we use state with the highest probability of being the
+    // previous state.
+    const double* prevLogProb = logStateProb.colptr(t - 1);
+    for (size_t j = 0; j < numStates; j++)
     {
-      arma::vec prob = logStateProb.col(t - 1) + logTransition.row(j).t();
-      logStateProb(j, t) = prob.max(index) +
-          emission[j].LogProbability(dataSeq.unsafe_col(t));
-      stateSeqBack(j, t) = index;
+      const double* logTransitionTo = logTransitionT.colptr(j);
+      double maxLogProb = prevLogProb[0] + logTransitionTo[0];
+      size_t maxIndex = 0;
+      for (size_t i = 1; i < numStates; i++)
+      {
+        const double logProb = prevLogProb[i] + logTransitionTo[i];
+        if (logProb > maxLogProb)
+        {
+          maxLogProb = logProb;
+          maxIndex = i;
+        }
+      }
+
+      logStateProb(j, t) = maxLogProb + emissionLogProb(j, t);
+      stateSeqBack(j, t) = maxIndex;
     }
   }
 
   // Backtrack to find the most probable state sequence.
-  logStateProb.unsafe_col(dataSeq.n_cols - 1).max(index);
-  stateSeq[dataSeq.n_cols - 1] = index;
-  for (size_t t = 2; t <= dataSeq.n_cols; t++)
+  arma::uword index;
+  logStateProb.unsafe_col(length - 1).max(index);
+  stateSeq[length - 1] = index;
+  for (size_t t = 2; t <= length; t++)
   {
-    stateSeq[dataSeq.n_cols - t] =
-        stateSeqBack(stateSeq[dataSeq.n_cols - t + 1], dataSeq.n_cols - t + 1);
+    stateSeq[length - t] =
+        stateSeqBack(stateSeq[length - t + 1], length - t + 1);
   }
 
-  return logStateProb(stateSeq(dataSeq.n_cols - 1), dataSeq.n_cols - 1);
+  return logStateProb(stateSeq(length - 1), length - 1);
 }
 
 /**
@@ -522,6 +640,45 @@ double HMM<Distribution>::LogLikelihood(const arma::mat& dataSeq) const
   return accu(logScales);
 }
 
+/**
+ * Compute the log-likelihood of each of the given data sequences.
+ */
+template<typename Distribution>
+void HMM<Distribution>::LogLikelihood(const std::vector<arma::mat>& dataSeq,
+                                      arma::vec& logLikelihoods) const
+{
+  logLikelihoods.set_size(dataSeq.size());
+
+  // Make sure the log-space parameters are up to date before the threads start
+  // reading them.
+  ConvertToLogSpace();
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); ++seq)
+    logLikelihoods[seq] = LogLikelihood(dataSeq[seq]);
+}
+
+/**
+ * Compute the emission log probabilities of each state for each observation.
+ */
+template<typename Distribution>
+void HMM<Distribution>::EmissionLogProbability(
+    const arma::mat& dataSeq,
+    arma::mat& emissionLogProb) const
+{
+  // Each distribution computes the log probabilities of the whole sequence at
+  // once; we store them in the columns of a temporary matrix and then
+  // transpose, so that each column of the result corresponds to a time step.
+  arma::mat logProbs(dataSeq.n_cols, emission.size());
+  for (size_t state = 0; state < emission.size(); state++)
+  {
+    arma::vec logProbsAlias = logProbs.unsafe_col(state);
+    emission[state].LogProbability(dataSeq, logProbsAlias);
+  }
+
+  emissionLogProb = logProbs.t();
+}
+
 /**
  * Compute the log of the scaling factor of the given emission probability
  * at time t. To calculate the log-likelihood for the whole sequence,
@@ -708,12 +865,35 @@ template<typename Distribution>
 void HMM<Distribution>::Forward(const arma::mat& dataSeq,
                                 arma::vec& logScales,
                                 arma::mat& forwardLogProb) const
+{
+  arma::mat emissionLogProb;
+  EmissionLogProbability(dataSeq, emissionLogProb);
+  ForwardFromEmission(emissionLogProb, logScales, forwardLogProb);
+}
+
+template<typename Distribution>
+void HMM<Distribution>::Backward(const arma::mat& dataSeq,
+                                 const arma::vec& logScales,
+                                 arma::mat& backwardLogProb) const
+{
+  arma::mat emissionLogProb;
+  EmissionLogProbability(dataSeq, emissionLogProb);
+  BackwardFromEmission(emissionLogProb, logScales, backwardLogProb);
+}
+
+/**
+ * The Forward procedure, given the emission log probabilities.
+ */
+template<typename Distribution>
+void HMM<Distribution>::ForwardFromEmission(const arma::mat& emissionLogProb,
+                                            arma::vec& logScales,
+                                            arma::mat& forwardLogProb) const
 {
   // Our goal is to calculate the forward probabilities:
   //  P(X_k | o_{1:k}) for all possible states X_k, for each time point k.
-  forwardLogProb.resize(logTransition.n_rows, dataSeq.n_cols);
+  forwardLogProb.resize(logTransition.n_rows, emissionLogProb.n_cols);
   forwardLogProb.fill(-std::numeric_limits<double>::infinity());
-  logScales.resize(dataSeq.n_cols);
+  logScales.resize(emissionLogProb.n_cols);
   logScales.fill(-std::numeric_limits<double>::infinity());
 
   // The first entry in the forward algorithm uses the initial state
@@ -721,46 +901,41 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
   // t = -1) is state 0; this is not our assumption here.  To force that
   // behavior, you could append a single starting state to every single data
   // sequence and that should produce results in line with MATLAB.
-
-  arma::vec emissionLogProb(logTransition.n_rows);
-  for (size_t state = 0; state < logTransition.n_rows; state++)
-  {
-    emissionLogProb(state) =
-        emission[state].LogProbability(dataSeq.unsafe_col(0));
-  }
-
-  forwardLogProb.col(0) = ForwardAtT0(emissionLogProb, logScales(0));
+  forwardLogProb.col(0) = ForwardAtT0(emissionLogProb.unsafe_col(0),
+      logScales(0));
 
   // Now compute the probabilities for each successive observation.
-  for (size_t t = 1; t < dataSeq.n_cols; t++)
+  for (size_t t = 1; t < emissionLogProb.n_cols; t++)
   {
-    for (size_t state = 0; state < logTransition.n_rows; state++)
-    {
-          emissionLogProb(state) =
-                  emission[state].LogProbability(dataSeq.unsafe_col(t));
-    }
-
-    forwardLogProb.col(t) =
-      ForwardAtTn(emissionLogProb, logScales(t), forwardLogProb.col(t-1));
+    forwardLogProb.col(t) = ForwardAtTn(emissionLogProb.unsafe_col(t),
+        logScales(t), forwardLogProb.col(t - 1));
   }
 }
 
+/**
+ * The Backward procedure, given the emission log probabilities.
+ */
 template<typename Distribution>
-void HMM<Distribution>::Backward(const arma::mat& dataSeq,
-                                 const arma::vec& logScales,
-                                 arma::mat& backwardLogProb) const
+void HMM<Distribution>::BackwardFromEmission(const arma::mat& emissionLogProb,
+                                             const arma::vec& logScales,
+                                             arma::mat& backwardLogProb) const
 {
   // Our goal is to calculate the backward probabilities:
   //  P(X_k | o_{k + 1:T}) for all possible states X_k, for each time point k.
-  backwardLogProb.resize(logTransition.n_rows, dataSeq.n_cols);
+  backwardLogProb.resize(logTransition.n_rows, emissionLogProb.n_cols);
   backwardLogProb.fill(-std::numeric_limits<double>::infinity());
 
   // The last element probability is 1.
-  backwardLogProb.col(dataSeq.n_cols - 1).fill(0);
+  backwardLogProb.col(emissionLogProb.n_cols - 1).fill(0);
 
   // Now step backwards through all other observations.
-  for (size_t t = dataSeq.n_cols - 2; t + 1 > 0; t--)
+  arma::vec nextLogProb(logTransition.n_rows);
+  for (size_t t = emissionLogProb.n_cols - 2; t + 1 > 0; t--)
   {
+    // The probability of being in each state at the next time step and
+    // emitting the next observation does not depend on the current state.
+    nextLogProb = backwardLogProb.col(t + 1) + emissionLogProb.col(t + 1);
+
     for (size_t j = 0; j < logTransition.n_rows; j++)
     {
       // The backward probability of state j at time t is the sum over all state
@@ -770,8 +945,7 @@ void HMM<Distribution>::Backward(const arma::mat& dataSeq,
       for (size_t state = 0; state < logTransition.n_rows; state++)
       {
         backwardLogProb(j, t) = math::LogAdd(backwardLogProb(j, t),
-            logTransition(state, j) + backwardLogProb(state, t + 1)
-            + emission[state].LogProbability(dataSeq.unsafe_col(t + 1)));
+            logTransition(state, j) + nextLogProb[state]);
       }
 
       // Normalize by the weights from the forward algorithm.
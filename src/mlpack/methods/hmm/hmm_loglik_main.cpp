@@ -43,7 +43,15 @@ BINDING_LONG_DESC(
     PRINT_PARAM_STRING("input_model") + " parameter, and evaluates the "
     "log-likelihood of a sequence of observations, given with the " +
     PRINT_PARAM_STRING("input") + " parameter.  The computed log-likelihood is"
-    " given as output.");
+    " given as output."
+    "\n\n"
+    "Many observation sequences can be scored at once by concatenating them in "
+    + PRINT_PARAM_STRING("input") + " and specifying the length of each "
+    "sequence with the " + PRINT_PARAM_STRING("lengths") + " parameter.  In "
+    "that case the sequences are scored in parallel (if mlpack was built with "
+    "OpenMP), the log-likelihood of each sequence is given in " +
+    PRINT_PARAM_STRING("log_likelihoods") + ", and " +
+    PRINT_PARAM_STRING("log_likelihood") + " holds their sum.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -64,8 +72,12 @@ BINDING_SEE_ALSO("mlpack::hmm::HMM class documentation",
 
 PARAM_MATRIX_IN_REQ("input", "File containing observations,", "i");
 PARAM_MODEL_IN_REQ(HMMModel, "input_model", "File containing HMM.", "m");
+PARAM_UCOL_IN("lengths", "Lengths of the observation sequences concatenated "
+    "in the input matrix, if it holds more than one sequence.", "l");
 
 PARAM_DOUBLE_OUT("log_likelihood", "Log-likelihood of the sequence.");
+PARAM_COL_OUT("log_likelihoods", "Log-likelihood of each sequence, if "
+    "'lengths' is given.", "o");
 
 // Because we don't know what the type of our HMM is, we need to write a
 // function that can take arbitrary HMM types.
@@ -93,9 +105,43 @@ struct Loglik
           << hmm.Emission()[0].Dimensionality() << ")!" << endl;
     }
 
-    const double loglik = hmm.LogLikelihood(dataSeq);
+    if (IO::HasParam("lengths"))
+    {
+      // Split the input into individual sequences, and score all of them with
+      // the same model.
+      const arma::Col<size_t>& lengths =
+          IO::GetParam<arma::Col<size_t>>("lengths");
+      if (arma::accu(lengths) != dataSeq.n_cols)
+      {
+        Log::Fatal << "Sum of sequence lengths (" << arma::accu(lengths)
+            << ") does not match the number of observations ("
+            << dataSeq.n_cols << ")!" << endl;
+      }
+      else if (arma::any(lengths == 0))
+      {
+        Log::Fatal << "All sequence lengths must be positive!" << endl;
+      }
+
+      vector<mat> dataSeqs(lengths.n_elem);
+      size_t offset = 0;
+      for (size_t i = 0; i < lengths.n_elem; ++i)
+      {
+        dataSeqs[i] = dataSeq.cols(offset, offset + lengths[i] - 1);
+        offset += lengths[i];
+      }
+
+      arma::vec logLikelihoods;
+      hmm.LogLikelihood(dataSeqs, logLikelihoods);
+
+      IO::GetParam<double>("log_likelihood") = arma::accu(logLikelihoods);
+      IO::GetParam<arma::vec>("log_likelihoods") = std::move(logLikelihoods);
+    }
+    else
+    {
+      const double loglik = hmm.LogLikelihood(dataSeq);
 
-    IO::GetParam<double>("log_likelihood") = loglik;
+      IO::GetParam<double>("log_likelihood") = loglik;
+    }
   }
 };
 
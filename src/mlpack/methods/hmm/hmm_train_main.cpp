@@ -58,7 +58,10 @@ BINDING_LONG_DESC(
     "provided.  The tolerance of the Baum-Welch algorithm can be set with the "
     + PRINT_PARAM_STRING("tolerance") + "option.  By default, the transition "
     "matrix is randomly initialized and the emission distributions are "
-    "initialized to fit the extent of the data."
+    "initialized to fit the extent of the data.  If mlpack was built with "
+    "OpenMP, the sequences are processed in parallel by the Baum-Welch "
+    "algorithm; the number of threads can be controlled with the "
+    "OMP_NUM_THREADS environment variable."
     "\n\n"
     "Optionally, a pre-created HMM model can be used as a guess for the "
     "transition matrix and emission probabilities; this is specifiable with " +
@@ -45,7 +45,14 @@ BINDING_LONG_DESC(
     "hidden state sequence of a given sequence of observations (specified as "
     "'" + PRINT_PARAM_STRING("input") + ", using the Viterbi algorithm.  The "
     "computed state sequence may be saved using the " +
-    PRINT_PARAM_STRING("output") + " output parameter.");
+    PRINT_PARAM_STRING("output") + " output parameter."
+    "\n\n"
+    "Many observation sequences can be processed at once by concatenating them "
+    "in " + PRINT_PARAM_STRING("input") + " and specifying the length of each "
+    "sequence with the " + PRINT_PARAM_STRING("lengths") + " parameter.  In "
+    "that case the sequences are decoded in parallel (if mlpack was built with "
+    "OpenMP), and " + PRINT_PARAM_STRING("output") + " holds the concatenated "
+    "state sequences.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -68,6 +75,8 @@ BINDING_SEE_ALSO("mlpack::hmm::HMM class documentation",
 
 PARAM_MATRIX_IN_REQ("input", "Matrix containing observations,", "i");
 PARAM_MODEL_IN_REQ(HMMModel, "input_model", "Trained HMM to use.", "m");
+PARAM_UCOL_IN("lengths", "Lengths of the observation sequences concatenated "
+    "in the input matrix, if it holds more than one sequence.", "l");
 PARAM_UMATRIX_OUT("output", "File to save predicted state sequence to.", "o");
 
 // Because we don't know what the type of our HMM is, we need to write a
@@ -97,7 +106,48 @@ struct Viterbi
     }
 
     arma::Row<size_t> sequence;
-    hmm.Predict(dataSeq, sequence);
+    if (IO::HasParam("lengths"))
+    {
+      // Split the input into individual sequences, and decode all of them with
+      // the same model.
+      const arma::Col<size_t>& lengths =
+          IO::GetParam<arma::Col<size_t>>("lengths");
+      if (arma::accu(lengths) != dataSeq.n_cols)
+      {
+        Log::Fatal << "Sum of sequence lengths (" << arma::accu(lengths)
+            << ") does not match the number of observations ("
+            << dataSeq.n_cols << ")!" << endl;
+      }
+      else if (arma::any(lengths == 0))
+      {
+        Log::Fatal << "All sequence lengths must be positive!" << endl;
+      }
+
+      vector<mat> dataSeqs(lengths.n_elem);
+      size_t offset = 0;
+      for (size_t i = 0; i < lengths.n_elem; ++i)
+      {
+        dataSeqs[i] = dataSeq.cols(offset, offset + lengths[i] - 1);
+        offset += lengths[i];
+      }
+
+      vector<arma::Row<size_t>> stateSeqs;
+      arma::vec logLikelihoods;
+      hmm.Predict(dataSeqs, stateSeqs, logLikelihoods);
+
+      // Concatenate the predicted state sequences.
+      sequence.set_size(dataSeq.n_cols);
+      offset = 0;
+      for (size_t i = 0; i < stateSeqs.size(); ++i)
+      {
+        sequence.cols(offset, offset + lengths[i] - 1) = stateSeqs[i];
+        offset += lengths[i];
+      }
+    }
+    else
+    {
+      hmm.Predict(dataSeq, sequence);
+    }
 
     // Save output.
     IO::GetParam<arma::Mat<size_t>>("output") = std::move(sequence);
@@ -73,6 +73,15 @@ class BinaryNumericSplit
    */
   void Train(ObservationType value, const size_t label);
 
+  /**
+   * Merge the points seen by another split for the same dimension into this
+   * one.  Afterwards this split is the same as if it had been trained on the
+   * points of both splits.
+   *
+   * @param other Split to merge into this one.
+   */
+  void Merge(const BinaryNumericSplit& other);
+
   /**
    * Given the points seen so far, evaluate the fitness function, returning the
    * best possible gain of a binary split.  Note that this takes O(n) time,
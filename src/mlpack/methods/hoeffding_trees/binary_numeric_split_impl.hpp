@@ -54,6 +54,18 @@ void BinaryNumericSplit<FitnessFunction, ObservationType>::Train(
   isAccurate = false;
 }
 
+template<typename FitnessFunction, typename ObservationType>
+void BinaryNumericSplit<FitnessFunction, ObservationType>::Merge(
+    const BinaryNumericSplit& other)
+{
+  sortedElements.insert(other.sortedElements.begin(),
+      other.sortedElements.end());
+  classCounts += other.classCounts;
+
+  // Whatever we have cached is no longer valid.
+  isAccurate = false;
+}
+
 template<typename FitnessFunction, typename ObservationType>
 void BinaryNumericSplit<FitnessFunction, ObservationType>::
     EvaluateFitnessFunction(double& bestFitness,
@@ -76,6 +76,15 @@ class HoeffdingCategoricalSplit
   template<typename eT>
   void Train(eT value, const size_t label);
 
+  /**
+   * Merge the sufficient statistics of another split for the same dimension
+   * into this one.  Afterwards this split is the same as if it had been trained
+   * on the points of both splits.
+   *
+   * @param other Split to merge into this one.
+   */
+  void Merge(const HoeffdingCategoricalSplit& other);
+
   /**
    * Given the points seen so far, evaluate the fitness function, returning the
    * gain for the best possible split and the second best possible split.  In
@@ -47,6 +47,14 @@ void HoeffdingCategoricalSplit<FitnessFunction>::Train(eT value,
   sufficientStatistics(label, size_t(value))++;
 }
 
+template<typename FitnessFunction>
+void HoeffdingCategoricalSplit<FitnessFunction>::Merge(
+    const HoeffdingCategoricalSplit& other)
+{
+  // The counts just add.
+  sufficientStatistics += other.sufficientStatistics;
+}
+
 template<typename FitnessFunction>
 void HoeffdingCategoricalSplit<FitnessFunction>::EvaluateFitnessFunction(
     double& bestFitness,
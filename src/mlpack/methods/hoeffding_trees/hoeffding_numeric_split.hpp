@@ -87,6 +87,19 @@ class HoeffdingNumericSplit
    */
   void Train(ObservationType value, const size_t label);
 
+  /**
+   * Merge the statistics of another split for the same dimension (with the
+   * same number of bins) into this one.  If either split has not binned its
+   * observations yet, the result is the same as training on the observations
+   * of both splits.  If both splits have binned their observations with
+   * different split points, the counts of each bin of the other split are
+   * added to the bin of this split that holds the center of that bin, so the
+   * result is only an approximation.
+   *
+   * @param other Split to merge into this one.
+   */
+  void Merge(const HoeffdingNumericSplit& other);
+
   /**
    * Evaluate the fitness function given what has been calculated so far.  In
    * this case, if binning has not yet been performed, 0 will be returned (i.e.,
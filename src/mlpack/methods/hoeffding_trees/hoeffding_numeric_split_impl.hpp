@@ -103,6 +103,58 @@ void HoeffdingNumericSplit<FitnessFunction, ObservationType>::Train(
   sufficientStatistics(label, bin)++;
 }
 
+template<typename FitnessFunction, typename ObservationType>
+void HoeffdingNumericSplit<FitnessFunction, ObservationType>::Merge(
+    const HoeffdingNumericSplit& other)
+{
+  if (other.samplesSeen < other.observationsBeforeBinning)
+  {
+    // The other split has only stored its observations, so we can train on
+    // them.
+    for (size_t i = 0; i < other.samplesSeen; ++i)
+      Train(other.observations[i], other.labels[i]);
+  }
+  else if (samplesSeen < observationsBeforeBinning)
+  {
+    // Only the other split has binned, so take its bins and train on our
+    // observations.
+    HoeffdingNumericSplit merged(other);
+    for (size_t i = 0; i < samplesSeen; ++i)
+      merged.Train(observations[i], labels[i]);
+
+    *this = std::move(merged);
+  }
+  else if (splitPoints.n_elem == other.splitPoints.n_elem &&
+      arma::all(splitPoints == other.splitPoints))
+  {
+    // The bins are the same, so the counts just add.
+    sufficientStatistics += other.sufficientStatistics;
+  }
+  else
+  {
+    // Add the counts of each bin of the other split to the bin that holds its
+    // center.
+    for (size_t j = 0; j < other.sufficientStatistics.n_cols; ++j)
+    {
+      ObservationType center;
+      if (other.splitPoints.n_elem == 0)
+        center = ObservationType(0);
+      else if (j == 0)
+        center = other.splitPoints[0];
+      else if (j == other.splitPoints.n_elem)
+        center = other.splitPoints[j - 1];
+      else
+        center = (other.splitPoints[j - 1] + other.splitPoints[j]) / 2;
+
+      size_t bin = 0;
+      while (bin < bins - 1 && center > splitPoints[bin])
+        ++bin;
+
+      sufficientStatistics.col(bin) += other.sufficientStatistics.col(j);
+    }
+  }
+}
+
 template<typename FitnessFunction, typename ObservationType>
 void HoeffdingNumericSplit<FitnessFunction, ObservationType>::
     EvaluateFitnessFunction(double& bestFitness,
@@ -19,6 +19,10 @@
 #include "hoeffding_numeric_split.hpp"
 #include "hoeffding_categorical_split.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace tree {
 
@@ -213,6 +217,33 @@ class HoeffdingTree
   template<typename VecType>
   void Train(const VecType& point, const size_t label);
 
+  /**
+   * Train on a set of points in streaming mode, using multiple threads.  The
+   * points are considered in rounds; in each round, each thread takes the next
+   * mergeInterval points of the stream, passes them down the tree, and
+   * collects the split statistics of the leaves they reach.  At the end of the
+   * round, the statistics of all threads are merged into the leaves of the
+   * tree, and leaves that have seen another checkInterval points are checked
+   * for a split.  The tree is not modified during a round, so each thread only
+   * needs its own statistics.
+   *
+   * Because splits are only checked at the end of each round, the tree may
+   * differ slightly from the one found by Train() with batchTraining set to
+   * false.  The tree only depends on the number of threads and the merge
+   * interval.  When HoeffdingNumericSplit is used, mergeInterval should be less
+   * than the number of observations before binning, so that the statistics of
+   * each thread can be merged exactly.
+   *
+   * @param data Data points to train on.
+   * @param labels Labels of data points.
+   * @param mergeInterval Number of points each thread considers in a round; if
+   *      0, the check interval of the tree is used.
+   */
+  template<typename MatType>
+  void ParallelTrain(const MatType& data,
+                     const arma::Row<size_t>& labels,
+                     const size_t mergeInterval = 0);
+
   /**
    * Check if a split would satisfy the conditions of the Hoeffding bound with
    * the node's specified success probability.  If so, the number of children
@@ -335,6 +366,29 @@ class HoeffdingTree
   void serialize(Archive& ar, const uint32_t /* version */);
 
  private:
+  /**
+   * Add the given point to the split statistics of this node, without checking
+   * for a split.  This must only be called on a leaf.
+   */
+  template<typename VecType>
+  void UpdateStatistics(const VecType& point, const size_t label);
+
+  /**
+   * Add the split statistics of the given leaf (which must have been created by
+   * CreateLeaf() on this node) to this node, without checking for a split.
+   */
+  void MergeStatistics(const HoeffdingTree& other);
+
+  //! Set the majority class and its probability from the split statistics.
+  void UpdateMajorityClass();
+
+  /**
+   * Create a new leaf with no statistics and the same parameters and split
+   * types as this node, which shares the dataset information and dimension
+   * mappings of this node.
+   */
+  HoeffdingTree* CreateLeaf() const;
+
   // We need to keep some information for before we have split.
 
   //! Information for splitting of numeric features (used before split).
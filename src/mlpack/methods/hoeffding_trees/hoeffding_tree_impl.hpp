@@ -517,28 +517,7 @@ void HoeffdingTree<
 {
   if (splitDimension == size_t(-1))
   {
-    ++numSamples;
-    size_t numericIndex = 0;
-    size_t categoricalIndex = 0;
-    for (size_t i = 0; i < point.n_rows; ++i)
-    {
-      if (datasetInfo->Type(i) == data::Datatype::categorical)
-        categoricalSplits[categoricalIndex++].Train(point[i], label);
-      else if (datasetInfo->Type(i) == data::Datatype::numeric)
-        numericSplits[numericIndex++].Train(point[i], label);
-    }
-
-    // Grab majority class from splits.
-    if (categoricalSplits.size() > 0)
-    {
-      majorityClass = categoricalSplits[0].MajorityClass();
-      majorityProbability = categoricalSplits[0].MajorityProbability();
-    }
-    else
-    {
-      majorityClass = numericSplits[0].MajorityClass();
-      majorityProbability = numericSplits[0].MajorityProbability();
-    }
+    UpdateStatistics(point, label);
 
     // Check for a split, if we should.
     if (numSamples % checkInterval == 0)
@@ -561,6 +540,158 @@ void HoeffdingTree<
   }
 }
 
+//! Train on a set of points in parallel.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::ParallelTrain(const MatType& data,
+                 const arma::Row<size_t>& labels,
+                 const size_t mergeInterval)
+{
+  #ifdef HAS_OPENMP
+    const size_t numShards = (size_t) omp_get_max_threads();
+  #else
+    const size_t numShards = 1;
+  #endif
+  const size_t shardSize = (mergeInterval == 0) ? checkInterval :
+      mergeInterval;
+  const size_t roundSize = numShards * shardSize;
+
+  // For each shard, this maps each leaf of the tree reached by a point of the
+  // shard in the current round to the statistics collected for it.
+  typedef std::unordered_map<HoeffdingTree*, HoeffdingTree*> LeafMap;
+  std::vector<LeafMap> shardLeaves(numShards);
+
+  for (size_t roundBegin = 0; roundBegin < data.n_cols;
+       roundBegin += roundSize)
+  {
+    const size_t roundEnd = std::min(roundBegin + roundSize,
+        (size_t) data.n_cols);
+
+    // The tree does not change during the round, so the shards can find the
+    // leaves of their points at the same time.
+    #pragma omp parallel for
+    for (omp_size_t s = 0; s < (omp_size_t) numShards; ++s)
+    {
+      const size_t shardBegin = roundBegin + s * shardSize;
+      const size_t shardEnd = std::min(shardBegin + shardSize, roundEnd);
+      for (size_t i = shardBegin; i < shardEnd; ++i)
+      {
+        HoeffdingTree* leaf = this;
+        while (leaf->splitDimension != size_t(-1))
+          leaf = leaf->children[leaf->CalculateDirection(data.col(i))];
+
+        HoeffdingTree*& statistics = shardLeaves[s][leaf];
+        if (statistics == NULL)
+          statistics = leaf->CreateLeaf();
+        statistics->UpdateStatistics(data.col(i), labels[i]);
+      }
+    }
+
+    // Merge the statistics of each shard into the tree, in order.  We remember
+    // how many samples each leaf had seen before the round.
+    std::unordered_map<HoeffdingTree*, size_t> oldNumSamples;
+    for (size_t s = 0; s < numShards; ++s)
+    {
+      for (typename LeafMap::iterator it = shardLeaves[s].begin();
+           it != shardLeaves[s].end(); ++it)
+      {
+        oldNumSamples.insert(std::make_pair(it->first, it->first->numSamples));
+        it->first->MergeStatistics(*it->second);
+        delete it->second;
+      }
+      shardLeaves[s].clear();
+    }
+
+    // Now check for a split in each leaf that has seen another checkInterval
+    // samples, like Train() does.
+    for (typename std::unordered_map<HoeffdingTree*, size_t>::iterator it =
+         oldNumSamples.begin(); it != oldNumSamples.end(); ++it)
+    {
+      HoeffdingTree* leaf = it->first;
+      if (it->second / leaf->checkInterval ==
+          leaf->numSamples / leaf->checkInterval)
+        continue;
+
+      const size_t numChildren = leaf->SplitCheck();
+      if (numChildren > 0)
+      {
+        leaf->children.clear();
+        leaf->CreateChildren();
+      }
+    }
+  }
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename VecType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::UpdateStatistics(const VecType& point, const size_t label)
+{
+  ++numSamples;
+  size_t numericIndex = 0;
+  size_t categoricalIndex = 0;
+  for (size_t i = 0; i < point.n_rows; ++i)
+  {
+    if (datasetInfo->Type(i) == data::Datatype::categorical)
+      categoricalSplits[categoricalIndex++].Train(point[i], label);
+    else if (datasetInfo->Type(i) == data::Datatype::numeric)
+      numericSplits[numericIndex++].Train(point[i], label);
+  }
+
+  UpdateMajorityClass();
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::MergeStatistics(const HoeffdingTree& other)
+{
+  numSamples += other.numSamples;
+  for (size_t i = 0; i < numericSplits.size(); ++i)
+    numericSplits[i].Merge(other.numericSplits[i]);
+  for (size_t i = 0; i < categoricalSplits.size(); ++i)
+    categoricalSplits[i].Merge(other.categoricalSplits[i]);
+
+  UpdateMajorityClass();
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::UpdateMajorityClass()
+{
+  // Grab majority class from splits.
+  if (categoricalSplits.size() > 0)
+  {
+    majorityClass = categoricalSplits[0].MajorityClass();
+    majorityProbability = categoricalSplits[0].MajorityProbability();
+  }
+  else
+  {
+    majorityClass = numericSplits[0].MajorityClass();
+    majorityProbability = numericSplits[0].MajorityProbability();
+  }
+}
+
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType>
@@ -879,34 +1010,7 @@ void HoeffdingTree<
   // We already know what the splitDimension will be.
   for (size_t i = 0; i < childMajorities.n_elem; ++i)
   {
-    // We need to also give our split objects to the new children, so that
-    // parameters for the splits can be passed down.  But if we have no
-    // categorical or numeric features, we can't pass anything but the
-    // defaults...
-    if (categoricalSplits.size() == 0)
-    {
-      // Pass a default categorical split.
-      children.push_back(new HoeffdingTree(*datasetInfo, numClasses,
-          successProbability, maxSamples, checkInterval, minSamples,
-          CategoricalSplitType<FitnessFunction>(0, numClasses),
-          numericSplits[0], dimensionMappings, false));
-    }
-    else if (numericSplits.size() == 0)
-    {
-      // Pass a default numeric split.
-      children.push_back(new HoeffdingTree(*datasetInfo, numClasses,
-          successProbability, maxSamples, checkInterval, minSamples,
-          categoricalSplits[0], NumericSplitType<FitnessFunction>(numClasses),
-          dimensionMappings, false));
-    }
-    else
-    {
-      // Pass both splits that we already have.
-      children.push_back(new HoeffdingTree(*datasetInfo, numClasses,
-          successProbability, maxSamples, checkInterval, minSamples,
-          categoricalSplits[0], numericSplits[0], dimensionMappings, false));
-    }
-
+    children.push_back(CreateLeaf());
     children[i]->MajorityClass() = childMajorities[i];
   }
 
@@ -915,6 +1019,46 @@ void HoeffdingTree<
   categoricalSplits.clear();
 }
 
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>*
+HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::CreateLeaf() const
+{
+  // We need to also give our split objects to the new leaf, so that parameters
+  // for the splits can be passed down.  But if we have no categorical or
+  // numeric features, we can't pass anything but the defaults...
+  if (categoricalSplits.size() == 0)
+  {
+    // Pass a default categorical split.
+    return new HoeffdingTree(*datasetInfo, numClasses, successProbability,
+        maxSamples, checkInterval, minSamples,
+        CategoricalSplitType<FitnessFunction>(0, numClasses),
+        numericSplits[0], dimensionMappings, false);
+  }
+  else if (numericSplits.size() == 0)
+  {
+    // Pass a default numeric split.
+    return new HoeffdingTree(*datasetInfo, numClasses, successProbability,
+        maxSamples, checkInterval, minSamples, categoricalSplits[0],
+        NumericSplitType<FitnessFunction>(numClasses), dimensionMappings,
+        false);
+  }
+  else
+  {
+    // Pass both splits that we already have.
+    return new HoeffdingTree(*datasetInfo, numClasses, successProbability,
+        maxSamples, checkInterval, minSamples, categoricalSplits[0],
+        numericSplits[0], dimensionMappings, false);
+  }
+}
+
 template<
     typename FitnessFunction,
     template<typename> class NumericSplitType,
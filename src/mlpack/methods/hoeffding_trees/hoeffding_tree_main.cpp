@@ -55,6 +55,12 @@ BINDING_LONG_DESC(
     PRINT_PARAM_STRING("batch_mode") + " option, but this may not be the best "
     "option for large datasets."
     "\n\n"
+    "Streaming training may be performed with multiple threads by specifying a "
+    "positive " + PRINT_PARAM_STRING("merge_interval") + ".  Then each thread "
+    "passes that many points of the stream down the tree, and the split "
+    "statistics collected by the threads are merged into the tree before "
+    "splits are checked.  This is ignored in batch mode."
+    "\n\n"
     "When a model is trained, it may be saved via the " +
     PRINT_PARAM_STRING("output_model") + " output parameter.  A model may be "
     "loaded from file for further training or testing with the " +
@@ -124,6 +130,9 @@ PARAM_FLAG("batch_mode", "If true, samples will be considered in batch instead "
 PARAM_FLAG("info_gain", "If set, information gain is used instead of Gini "
     "impurity for calculating Hoeffding bounds.", "i");
 PARAM_INT_IN("passes", "Number of passes to take over the dataset.", "s", 1);
+PARAM_INT_IN("merge_interval", "If positive, streaming training uses multiple "
+    "threads, and each thread considers this many points before the statistics "
+    "of all threads are merged into the tree.", "g", 0);
 
 PARAM_INT_IN("bins", "If the 'domingos' split strategy is used, this specifies "
     "the number of bins for each numeric split.", "B", 10);
@@ -150,6 +159,11 @@ static void mlpackMain()
 
   ReportIgnoredParam({{ "training", false }}, "batch_mode");
   ReportIgnoredParam({{ "training", false }}, "passes");
+  ReportIgnoredParam({{ "training", false }}, "merge_interval");
+  ReportIgnoredParam({{ "batch_mode", true }}, "merge_interval");
+
+  RequireParamValue<int>("merge_interval", [](int x) { return x >= 0; }, true,
+      "merge interval must be nonnegative");
 
   if (IO::HasParam("test"))
   {
@@ -194,6 +208,7 @@ static void mlpackMain()
     const size_t observationsBeforeBinning = (size_t)
         IO::GetParam<int>("observations_before_binning");
     size_t passes = (size_t) IO::GetParam<int>("passes");
+    const size_t mergeInterval = (size_t) IO::GetParam<int>("merge_interval");
     if (passes > 1)
       batchTraining = false; // We already warned about this earlier.
 
@@ -230,7 +245,7 @@ static void mlpackMain()
       // Build the model.
       model->BuildModel(trainingSet, datasetInfo, labels,
           arma::max(labels) + 1, batchTraining, confidence, maxSamples,
-          100, minSamples, bins, observationsBeforeBinning);
+          100, minSamples, bins, observationsBeforeBinning, mergeInterval);
       --passes; // This model-building takes one pass.
     }
 
@@ -245,7 +260,7 @@ static void mlpackMain()
     else
     {
       for (size_t p = 0; p < passes; ++p)
-        model->Train(trainingSet, labels, false);
+        model->Train(trainingSet, labels, false, mergeInterval);
     }
 
     Timer::Stop("tree_training");
@@ -137,7 +137,8 @@ void HoeffdingTreeModel::BuildModel(
     const size_t checkInterval,
     const size_t minSamples,
     const size_t bins,
-    const size_t observationsBeforeBinning)
+    const size_t observationsBeforeBinning,
+    const size_t mergeInterval)
 {
   // Clean memory, if needed.
   delete giniHoeffdingTree;
@@ -145,6 +146,14 @@ void HoeffdingTreeModel::BuildModel(
   delete infoHoeffdingTree;
   delete infoBinaryTree;
 
+  // If we are training in parallel, build the tree without any points, and
+  // then train it with ParallelTrain().
+  const bool parallel = (!batchTraining && mergeInterval > 0);
+  const arma::mat emptyDataset(dataset.n_rows, 0);
+  const arma::Row<size_t> emptyLabels;
+  const arma::mat& buildDataset = parallel ? emptyDataset : dataset;
+  const arma::Row<size_t>& buildLabels = parallel ? emptyLabels : labels;
+
   // Depending on the type, create the tree.
   switch (type)
   {
@@ -154,17 +163,17 @@ void HoeffdingTreeModel::BuildModel(
         HoeffdingDoubleNumericSplit<GiniImpurity> ns(0, bins,
             observationsBeforeBinning);
 
-        giniHoeffdingTree = new GiniHoeffdingTreeType(dataset, datasetInfo,
-            labels, numClasses, batchTraining, successProbability, maxSamples,
-            checkInterval, minSamples,
+        giniHoeffdingTree = new GiniHoeffdingTreeType(buildDataset,
+            datasetInfo, buildLabels, numClasses, batchTraining,
+            successProbability, maxSamples, checkInterval, minSamples,
             HoeffdingCategoricalSplit<GiniImpurity>(0, 0), ns);
       }
       break;
 
     case GINI_BINARY:
-      giniBinaryTree = new GiniBinaryTreeType(dataset, datasetInfo, labels,
-          numClasses, batchTraining, successProbability, maxSamples,
-          checkInterval, minSamples);
+      giniBinaryTree = new GiniBinaryTreeType(buildDataset, datasetInfo,
+          buildLabels, numClasses, batchTraining, successProbability,
+          maxSamples, checkInterval, minSamples);
       break;
 
     case INFO_HOEFFDING:
@@ -173,26 +182,55 @@ void HoeffdingTreeModel::BuildModel(
         HoeffdingDoubleNumericSplit<HoeffdingInformationGain> ns(0, bins,
             observationsBeforeBinning);
 
-        infoHoeffdingTree = new InfoHoeffdingTreeType(dataset, datasetInfo,
-            labels, numClasses, batchTraining, successProbability, maxSamples,
-            checkInterval, minSamples,
+        infoHoeffdingTree = new InfoHoeffdingTreeType(buildDataset,
+            datasetInfo, buildLabels, numClasses, batchTraining,
+            successProbability, maxSamples, checkInterval, minSamples,
             HoeffdingCategoricalSplit<HoeffdingInformationGain>(0, 0), ns);
       }
       break;
 
     case INFO_BINARY:
-      infoBinaryTree = new InfoBinaryTreeType(dataset, datasetInfo, labels,
-          numClasses, batchTraining, successProbability, maxSamples,
-          checkInterval, minSamples);
+      infoBinaryTree = new InfoBinaryTreeType(buildDataset, datasetInfo,
+          buildLabels, numClasses, batchTraining, successProbability,
+          maxSamples, checkInterval, minSamples);
       break;
   }
+
+  if (parallel)
+    Train(dataset, labels, false, mergeInterval);
 }
 
 // Train the model on one pass of the dataset.
 void HoeffdingTreeModel::Train(const arma::mat& dataset,
                                const arma::Row<size_t>& labels,
-                               const bool batchTraining)
+                               const bool batchTraining,
+                               const size_t mergeInterval)
 {
+  // Streaming training may be done in parallel.
+  if (!batchTraining && mergeInterval > 0)
+  {
+    switch (type)
+    {
+      case GINI_HOEFFDING:
+        giniHoeffdingTree->ParallelTrain(dataset, labels, mergeInterval);
+        break;
+
+      case GINI_BINARY:
+        giniBinaryTree->ParallelTrain(dataset, labels, mergeInterval);
+        break;
+
+      case INFO_HOEFFDING:
+        infoHoeffdingTree->ParallelTrain(dataset, labels, mergeInterval);
+        break;
+
+      case INFO_BINARY:
+        infoBinaryTree->ParallelTrain(dataset, labels, mergeInterval);
+        break;
+    }
+
+    return;
+  }
+
   // Depending on the type, pass through once.
   switch (type)
   {
@@ -110,6 +110,9 @@ class HoeffdingTreeModel
    * @param bins Number of bins, for Hoeffding numeric split.
    * @param observationsBeforeBinning Number of observations before binning, for
    *      Hoeffding numeric split.
+   * @param mergeInterval If nonzero and batchTraining is false, train in
+   *      parallel with HoeffdingTree::ParallelTrain(), using this merge
+   *      interval.
    */
   void BuildModel(const arma::mat& dataset,
                   const data::DatasetInfo& datasetInfo,
@@ -121,7 +124,8 @@ class HoeffdingTreeModel
                   const size_t checkInterval,
                   const size_t minSamples,
                   const size_t bins,
-                  const size_t observationsBeforeBinning);
+                  const size_t observationsBeforeBinning,
+                  const size_t mergeInterval = 0);
 
   /**
    * Train in streaming mode on the given dataset.  This takes one pass.  Be
@@ -130,10 +134,14 @@ class HoeffdingTreeModel
    * @param dataset Dataset to train on.
    * @param labels Labels for training set.
    * @param batchTraining Whether or not to train in batch.
+   * @param mergeInterval If nonzero and batchTraining is false, train in
+   *      parallel with HoeffdingTree::ParallelTrain(), using this merge
+   *      interval.
    */
   void Train(const arma::mat& dataset,
              const arma::Row<size_t>& labels,
-             const bool batchTraining);
+             const bool batchTraining,
+             const size_t mergeInterval = 0);
 
   /**
    * Using the model, classify the given test points.  Be sure that BuildModel()
@@ -16,6 +16,23 @@
 namespace mlpack {
 namespace tree {
 
+/**
+ * Draw the indices of a bootstrap sample of a dataset with the given number of
+ * points: numPoints indices drawn uniformly with replacement.  Training on the
+ * points selected by these indices (see the DecisionTree::Train() overload that
+ * takes indices) is equivalent to training on the dataset returned by
+ * Bootstrap(), but avoids copying the dataset.
+ *
+ * @param numPoints Number of points in the dataset.
+ * @param indices Vector to store the sampled indices in.
+ */
+inline void BootstrapIndices(const size_t numPoints, arma::uvec& indices)
+{
+  // Random sampling with replacement.
+  indices = arma::randi<arma::uvec>(numPoints,
+      arma::distr_param(0, numPoints - 1));
+}
+
 /**
  * Given a dataset, create another dataset via bootstrap sampling, with labels.
  */
@@ -35,9 +52,8 @@ void Bootstrap(const MatType& dataset,
   if (UseWeights)
     bootstrapWeights.set_size(weights.n_elem);
 
-  // Random sampling with replacement.
-  arma::uvec indices = arma::randi<arma::uvec>(dataset.n_cols,
-      arma::distr_param(0, dataset.n_cols - 1));
+  arma::uvec indices;
+  BootstrapIndices(dataset.n_cols, indices);
   bootstrapDataset = dataset.cols(indices);
   bootstrapLabels = labels.cols(indices);
   if (UseWeights)
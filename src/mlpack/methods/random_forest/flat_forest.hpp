@@ -0,0 +1,195 @@
+/**
+ * @file methods/random_forest/flat_forest.hpp
+ *
+ * Definition of the FlatForest class, a compact, inference-only representation
+ * of trained decision trees and random forests.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/decision_tree/decision_tree.hpp>
+#include "random_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The FlatForest class holds a trained DecisionTree or RandomForest in a form
+ * that is suited to fast batch classification.  The nodes of all trees are
+ * stored in contiguous arrays (a structure of arrays: split dimension, split
+ * threshold, left child, right child, and leaf index), and every node is a
+ * binary "value <= threshold goes left" test.  Categorical splits are rewritten
+ * as a balanced sequence of such tests over the category values.  Leaves point
+ * to themselves, so a point can be walked down a tree for a fixed number of
+ * steps (the depth of the tree) without any data-dependent branches.
+ *
+ * Points are classified in blocks of BlockSize; each tree is applied to the
+ * whole block before moving to the next tree, so that the nodes of a tree stay
+ * in cache, and the walks of the points in a block are independent of each
+ * other.  Blocks are processed in parallel with OpenMP.
+ *
+ * The predictions and probabilities are the same as those given by the
+ * Classify() methods of the original DecisionTree or RandomForest.
+ *
+ * The numeric split type of the trees must be a binary split that sends a
+ * point left when its value is less than or equal to the split value stored in
+ * the first element of ClassProbabilities() (like BestBinaryNumericSplit and
+ * HistogramNumericSplit), and the categorical split type must send a point to
+ * the child given by its category (like AllCategoricalSplit).
+ *
+ * @code
+ * RandomForest<> rf(data, labels, numClasses, 500);
+ * FlatForest flat(rf);
+ * flat.Classify(testData, predictions, probabilities);
+ * @endcode
+ */
+class FlatForest
+{
+ public:
+  //! The number of points that are classified together.
+  static constexpr size_t BlockSize = 64;
+
+  /**
+   * Create an empty FlatForest.  Trees can be added with AddTree().
+   */
+  FlatForest() : numClasses(0), dimensionality(0) { }
+
+  /**
+   * Create a FlatForest that holds the given decision tree.
+   *
+   * @param tree Trained decision tree.
+   */
+  template<typename FitnessFunction,
+           template<typename> class NumericSplitType,
+           template<typename> class CategoricalSplitType,
+           typename DimensionSelectionType,
+           typename ElemType,
+           bool NoRecursion>
+  explicit FlatForest(const DecisionTree<FitnessFunction,
+                                         NumericSplitType,
+                                         CategoricalSplitType,
+                                         DimensionSelectionType,
+                                         ElemType,
+                                         NoRecursion>& tree);
+
+  /**
+   * Create a FlatForest that holds all the trees of the given random forest.
+   *
+   * @param forest Trained random forest.
+   */
+  template<typename FitnessFunction,
+           typename DimensionSelectionType,
+           template<typename> class NumericSplitType,
+           template<typename> class CategoricalSplitType,
+           typename ElemType>
+  explicit FlatForest(const RandomForest<FitnessFunction,
+                                         DimensionSelectionType,
+                                         NumericSplitType,
+                                         CategoricalSplitType,
+                                         ElemType>& forest);
+
+  /**
+   * Flatten the given decision tree and add it to the forest.  All trees in
+   * the forest must have the same number of classes.
+   *
+   * @param tree Trained decision tree.
+   */
+  template<typename TreeType>
+  void AddTree(const TreeType& tree);
+
+  /**
+   * Predict the classes of each point in the given dataset.  If the forest
+   * holds no trees, this will throw an exception.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of each point in the given dataset, also returning the
+   * predicted class probabilities (averaged over all trees) for each point.  If
+   * the forest holds no trees, this will throw an exception.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   * @param probabilities Output matrix of class probabilities for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of trees in the forest.
+  size_t NumTrees() const { return roots.size(); }
+  //! Get the total number of nodes of all trees.
+  size_t NumNodes() const { return dimensions.size(); }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+  /**
+   * Serialize the forest.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  /**
+   * Flatten the subtree rooted at the given node, and return the index of its
+   * root in the node arrays.  The depth of the flattened subtree is stored in
+   * depth.
+   */
+  template<typename TreeType>
+  size_t AddNode(const TreeType& node, size_t& depth);
+
+  /**
+   * Flatten the children firstChild through lastChild of the categorical split
+   * node into a balanced sequence of binary nodes, and return the index of
+   * the first of these nodes.  The depth of the flattened nodes is stored in
+   * depth.
+   */
+  template<typename TreeType>
+  size_t AddCategoricalNodes(const TreeType& node,
+                             const size_t firstChild,
+                             const size_t lastChild,
+                             size_t& depth);
+
+  //! The split dimension of each node.
+  std::vector<size_t> dimensions;
+  //! The split value of each node; points with a value less than or equal to it
+  //! go to the left child.
+  std::vector<double> thresholds;
+  //! The index of the left child of each node (a leaf is its own child).
+  std::vector<size_t> leftChildren;
+  //! The index of the right child of each node (a leaf is its own child).
+  std::vector<size_t> rightChildren;
+  //! The index of the leaf of each node in leafProbabilities (only meaningful
+  //! for leaves).
+  std::vector<size_t> leafIndices;
+  //! The class probabilities of each leaf, stored contiguously (numClasses
+  //! values per leaf).
+  std::vector<double> leafProbabilities;
+  //! The index of the root node of each tree.
+  std::vector<size_t> roots;
+  //! The depth of each tree.
+  std::vector<size_t> depths;
+  //! The number of classes.
+  size_t numClasses;
+  //! The minimum number of dimensions a point must have.
+  size_t dimensionality;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_forest_impl.hpp"
+
+#endif
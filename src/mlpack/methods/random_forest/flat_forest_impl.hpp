@@ -0,0 +1,264 @@
+/**
+ * @file methods/random_forest/flat_forest_impl.hpp
+ *
+ * Implementation of the FlatForest class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "flat_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+FlatForest::FlatForest(const DecisionTree<FitnessFunction,
+                                          NumericSplitType,
+                                          CategoricalSplitType,
+                                          DimensionSelectionType,
+                                          ElemType,
+                                          NoRecursion>& tree) :
+    numClasses(0),
+    dimensionality(0)
+{
+  AddTree(tree);
+}
+
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType>
+FlatForest::FlatForest(const RandomForest<FitnessFunction,
+                                          DimensionSelectionType,
+                                          NumericSplitType,
+                                          CategoricalSplitType,
+                                          ElemType>& forest) :
+    numClasses(0),
+    dimensionality(0)
+{
+  for (size_t i = 0; i < forest.NumTrees(); ++i)
+    AddTree(forest.Tree(i));
+}
+
+template<typename TreeType>
+void FlatForest::AddTree(const TreeType& tree)
+{
+  if (roots.empty())
+    numClasses = tree.NumClasses();
+  else if (tree.NumClasses() != numClasses)
+    throw std::invalid_argument("FlatForest::AddTree(): tree has a different "
+        "number of classes than the other trees in the forest!");
+
+  size_t depth = 0;
+  roots.push_back(AddNode(tree, depth));
+  depths.push_back(depth);
+}
+
+template<typename TreeType>
+size_t FlatForest::AddNode(const TreeType& node, size_t& depth)
+{
+  // Reserve this node's slot before flattening the children, so that nodes
+  // are stored in depth-first order.
+  const size_t index = dimensions.size();
+  dimensions.push_back(0);
+  thresholds.push_back(0.0);
+  leftChildren.push_back(index);
+  rightChildren.push_back(index);
+  leafIndices.push_back(0);
+
+  if (node.NumChildren() == 0)
+  {
+    // A leaf is its own child, so walking further down the tree stays here.
+    const arma::vec& probabilities = node.ClassProbabilities();
+    if (probabilities.n_elem != numClasses)
+      throw std::invalid_argument("FlatForest::AddTree(): leaf has a different "
+          "number of classes than the tree!");
+
+    leafIndices[index] = leafProbabilities.size() / numClasses;
+    leafProbabilities.insert(leafProbabilities.end(), probabilities.begin(),
+        probabilities.end());
+    depth = 0;
+    return index;
+  }
+
+  dimensionality = std::max(dimensionality, node.SplitDimension() + 1);
+
+  if (node.SplitType() == data::Datatype::categorical)
+  {
+    // Replace the categorical split by binary splits over the categories.  We
+    // reuse this node's slot for the first of them.
+    dimensions.pop_back();
+    thresholds.pop_back();
+    leftChildren.pop_back();
+    rightChildren.pop_back();
+    leafIndices.pop_back();
+    return AddCategoricalNodes(node, 0, node.NumChildren() - 1, depth);
+  }
+
+  if (node.NumChildren() != 2)
+    throw std::invalid_argument("FlatForest::AddTree(): only binary numeric "
+        "splits are supported!");
+
+  size_t leftDepth, rightDepth;
+  const size_t left = AddNode(node.Child(0), leftDepth);
+  const size_t right = AddNode(node.Child(1), rightDepth);
+
+  dimensions[index] = node.SplitDimension();
+  thresholds[index] = node.ClassProbabilities()[0];
+  leftChildren[index] = left;
+  rightChildren[index] = right;
+  depth = std::max(leftDepth, rightDepth) + 1;
+
+  return index;
+}
+
+template<typename TreeType>
+size_t FlatForest::AddCategoricalNodes(const TreeType& node,
+                                       const size_t firstChild,
+                                       const size_t lastChild,
+                                       size_t& depth)
+{
+  if (firstChild == lastChild)
+    return AddNode(node.Child(firstChild), depth);
+
+  const size_t index = dimensions.size();
+  dimensions.push_back(node.SplitDimension());
+  thresholds.push_back(0.0);
+  leftChildren.push_back(index);
+  rightChildren.push_back(index);
+  leafIndices.push_back(0);
+
+  // A point goes to child (size_t) value, so it goes to the children after
+  // 'middle' exactly when value >= middle; the split value is therefore the
+  // largest representable value below 'middle'.
+  const size_t middle = (firstChild + lastChild + 1) / 2;
+  size_t leftDepth, rightDepth;
+  const size_t left = AddCategoricalNodes(node, firstChild, middle - 1,
+      leftDepth);
+  const size_t right = AddCategoricalNodes(node, middle, lastChild,
+      rightDepth);
+
+  thresholds[index] = std::nextafter((double) middle, -DBL_MAX);
+  leftChildren[index] = left;
+  rightChildren[index] = right;
+  depth = std::max(leftDepth, rightDepth) + 1;
+
+  return index;
+}
+
+template<typename MatType>
+void FlatForest::Classify(const MatType& data,
+                          arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename MatType>
+void FlatForest::Classify(const MatType& data,
+                          arma::Row<size_t>& predictions,
+                          arma::mat& probabilities) const
+{
+  // Check edge cases.
+  if (roots.empty())
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("FlatForest::Classify(): no trees in the "
+        "forest!");
+  }
+
+  if (data.n_rows < dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "FlatForest::Classify(): dimensionality of points (" << data.n_rows
+        << ") is less than the dimensionality used by the trees ("
+        << dimensionality << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  predictions.set_size(data.n_cols);
+  probabilities.zeros(numClasses, data.n_cols);
+
+  const size_t numBlocks = (data.n_cols + BlockSize - 1) / BlockSize;
+
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t begin = b * BlockSize;
+    const size_t count = std::min((size_t) BlockSize, data.n_cols - begin);
+
+    // The current node of each point in the block.
+    size_t nodes[BlockSize];
+
+    for (size_t t = 0; t < roots.size(); ++t)
+    {
+      for (size_t j = 0; j < count; ++j)
+        nodes[j] = roots[t];
+
+      // Walk every point down the tree one level at a time.  Points that have
+      // reached a leaf stay there, so no point needs to be handled separately.
+      for (size_t d = 0; d < depths[t]; ++d)
+      {
+        for (size_t j = 0; j < count; ++j)
+        {
+          const size_t node = nodes[j];
+          nodes[j] = (data(dimensions[node], begin + j) <= thresholds[node]) ?
+              leftChildren[node] : rightChildren[node];
+        }
+      }
+
+      // Accumulate the class probabilities of the leaves.
+      for (size_t j = 0; j < count; ++j)
+      {
+        const double* leaf = leafProbabilities.data() +
+            leafIndices[nodes[j]] * numClasses;
+        double* point = probabilities.colptr(begin + j);
+        for (size_t c = 0; c < numClasses; ++c)
+          point[c] += leaf[c];
+      }
+    }
+
+    // Find maximum element after renormalizing probabilities.
+    for (size_t j = begin; j < begin + count; ++j)
+    {
+      probabilities.col(j) /= roots.size();
+      arma::uword maxIndex = 0;
+      probabilities.col(j).max(maxIndex);
+      predictions[j] = (size_t) maxIndex;
+    }
+  }
+}
+
+template<typename Archive>
+void FlatForest::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(dimensions));
+  ar(CEREAL_NVP(thresholds));
+  ar(CEREAL_NVP(leftChildren));
+  ar(CEREAL_NVP(rightChildren));
+  ar(CEREAL_NVP(leafIndices));
+  ar(CEREAL_NVP(leafProbabilities));
+  ar(CEREAL_NVP(roots));
+  ar(CEREAL_NVP(depths));
+  ar(CEREAL_NVP(numClasses));
+  ar(CEREAL_NVP(dimensionality));
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
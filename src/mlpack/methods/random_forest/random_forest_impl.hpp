@@ -463,7 +463,25 @@ double RandomForest<
          const size_t maximumDepth,
          DimensionSelectionType& dimensionSelector)
 {
-  // Train each tree individually.
+  // If we are not given type information, all dimensions are numeric.
+  const data::DatasetInfo numericInfo(UseDatasetInfo ? 0 : dataset.n_rows);
+  const data::DatasetInfo& info = UseDatasetInfo ? datasetInfo : numericInfo;
+
+  // If the trees split numeric dimensions on histograms, bin the dataset once
+  // and let every tree build its histograms from these bins.
+  typename DecisionTreeType::BinnedData binned;
+  const bool useBins = UsesHistograms<typename DecisionTreeType::NumericSplit>
+      ::value && maximumDepth != 1;
+  if (useBins)
+  {
+    Timer::Start("bin_data");
+    DecisionTreeType::BinData(dataset, info, binned);
+    Timer::Stop("bin_data");
+  }
+
+  // Train each tree individually.  Each tree is trained on a bootstrap sample
+  // of the dataset given as a set of indices, so the dataset itself is never
+  // copied; each thread only needs O(dataset.n_cols) extra memory.
   trees.resize(numTrees); // This will fill the vector with untrained trees.
   double avgGain = 0.0;
 
@@ -471,44 +489,15 @@ double RandomForest<
   for (omp_size_t i = 0; i < numTrees; ++i)
   {
     Timer::Start("bootstrap");
-    MatType bootstrapDataset;
-    arma::Row<size_t> bootstrapLabels;
-    arma::rowvec bootstrapWeights;
-    Bootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
-        bootstrapLabels, bootstrapWeights);
+    arma::uvec bootstrapIndices;
+    BootstrapIndices(dataset.n_cols, bootstrapIndices);
     Timer::Stop("bootstrap");
 
     // Now build the decision tree.
     Timer::Start("train_tree");
-    if (UseWeights)
-    {
-      if (UseDatasetInfo)
-      {
-        avgGain += trees[i].Train(bootstrapDataset, datasetInfo,
-            bootstrapLabels, numClasses, bootstrapWeights, minimumLeafSize,
-            minimumGainSplit, maximumDepth, dimensionSelector);
-      }
-      else
-      {
-        avgGain += trees[i].Train(bootstrapDataset, bootstrapLabels, numClasses,
-            bootstrapWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
-            dimensionSelector);
-      }
-    }
-    else
-    {
-      if (UseDatasetInfo)
-      {
-        avgGain += trees[i].Train(bootstrapDataset, datasetInfo,
-            bootstrapLabels, numClasses, minimumLeafSize, minimumGainSplit,
-            maximumDepth, dimensionSelector);
-      }
-      else
-      {
-        avgGain += trees[i].Train(bootstrapDataset, bootstrapLabels, numClasses,
-            minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
-      }
-    }
+    avgGain += trees[i].template Train<UseWeights>(dataset, bootstrapIndices,
+        info, labels, numClasses, weights, minimumLeafSize, minimumGainSplit,
+        maximumDepth, dimensionSelector, useBins ? &binned : NULL);
     Timer::Stop("train_tree");
   }
   return avgGain / numTrees;
@@ -891,3 +891,54 @@ TEST_CASE("ID3DecisionStumpSerializationTest", "[AdaBoostTest]")
             abBinary.WeakLearner(i).SplitDimension());
   }
 }
+
+/**
+ * Make sure that the class probabilities given by Classify() are the
+ * normalized, alpha-weighted votes of the weak learners, and that the batch
+ * classification of the perceptron matches classifying each point by hand.
+ */
+TEST_CASE("ClassifyWeightedVotesTest", "[AdaBoostTest]")
+{
+  arma::mat inputData;
+  if (!data::Load("iris_train.csv", inputData))
+    FAIL("Cannot load test dataset iris_train.csv!");
+
+  arma::Mat<size_t> labels;
+  if (!data::Load("iris_train_labels.csv", labels))
+    FAIL("Cannot load labels for iris_train_labels.csv");
+  const size_t numClasses = max(labels.row(0)) + 1;
+
+  Perceptron<> p(inputData, labels.row(0), numClasses, 400);
+  AdaBoost<> a(inputData, labels.row(0), numClasses, p, 20, 1e-10);
+
+  arma::Row<size_t> predictedLabels;
+  arma::mat probabilities;
+  a.Classify(inputData, predictedLabels, probabilities);
+
+  arma::mat votes(numClasses, inputData.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < a.WeakLearners(); ++i)
+  {
+    Perceptron<> w(a.WeakLearner(i));
+    arma::Row<size_t> weakPredictions;
+    w.Classify(inputData, weakPredictions);
+    REQUIRE(weakPredictions.n_elem == inputData.n_cols);
+
+    for (size_t j = 0; j < inputData.n_cols; ++j)
+    {
+      // Check the batch classification of the perceptron.
+      arma::vec scores = w.Weights().t() * inputData.col(j) + w.Biases();
+      arma::uword maxIndex = 0;
+      scores.max(maxIndex);
+      REQUIRE(weakPredictions[j] == maxIndex);
+
+      votes(weakPredictions[j], j) += a.Alpha(i);
+    }
+  }
+
+  for (size_t j = 0; j < inputData.n_cols; ++j)
+  {
+    votes.col(j) /= arma::accu(votes.col(j));
+    for (size_t k = 0; k < numClasses; ++k)
+      REQUIRE(probabilities(k, j) == Approx(votes(k, j)).margin(1e-10));
+  }
+}
@@ -1503,6 +1503,70 @@ TEST_CASE("WriteCellStateParamLSTMLayerTest", "[ANNLayerTest]")
   }
 }
 
+/**
+ * Check the forward pass of the LSTM layer with random weights, using the
+ * documented layout of the stacked gate weights.
+ */
+TEST_CASE("StackedGateWeightsLSTMLayerTest", "[ANNLayerTest]")
+{
+  const size_t rho = 5, inputSize = 3, outputSize = 4, batchSize = 2;
+  arma::cube input(inputSize, batchSize, rho, arma::fill::randn);
+
+  LSTM<> lstm(inputSize, outputSize, rho);
+  lstm.Parameters().randn();
+  lstm.Reset();
+  lstm.ResetCell(rho);
+
+  const arma::mat& parameters = lstm.Parameters();
+  size_t offset = 0;
+  const arma::mat inputWeight = arma::reshape(parameters.rows(offset,
+      offset + 4 * outputSize * inputSize - 1), 4 * outputSize, inputSize);
+  offset += inputWeight.n_elem;
+  const arma::vec bias = parameters.rows(offset, offset + 4 * outputSize - 1);
+  offset += bias.n_elem;
+  const arma::mat outputWeight = arma::reshape(parameters.rows(offset,
+      offset + 4 * outputSize * outputSize - 1), 4 * outputSize, outputSize);
+  offset += outputWeight.n_elem;
+  const arma::vec cellInputWeight = parameters.rows(offset,
+      offset + outputSize - 1);
+  const arma::vec cellForgetWeight = parameters.rows(offset + outputSize,
+      offset + 2 * outputSize - 1);
+  const arma::vec cellOutputWeight = parameters.rows(offset + 2 * outputSize,
+      offset + 3 * outputSize - 1);
+
+  arma::mat cellCalc = arma::zeros(outputSize, batchSize);
+  arma::mat outCalc = arma::zeros(outputSize, batchSize);
+  arma::mat outLstm;
+  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  {
+    lstm.Forward(input.slice(seqNum), outLstm);
+
+    arma::mat gates = inputWeight * input.slice(seqNum) +
+        outputWeight * outCalc;
+    gates.each_col() += bias;
+
+    arma::mat inputGate = gates.rows(0, outputSize - 1);
+    inputGate += cellCalc.each_col() % cellInputWeight;
+    inputGate = 1.0 / (1 + arma::exp(-inputGate));
+
+    arma::mat forgetGate = gates.rows(outputSize, 2 * outputSize - 1);
+    forgetGate += cellCalc.each_col() % cellForgetWeight;
+    forgetGate = 1.0 / (1 + arma::exp(-forgetGate));
+
+    const arma::mat hidden = arma::tanh(gates.rows(2 * outputSize,
+        3 * outputSize - 1));
+    cellCalc = forgetGate % cellCalc + inputGate % hidden;
+
+    arma::mat outputGate = gates.rows(3 * outputSize, 4 * outputSize - 1);
+    outputGate += cellCalc.each_col() % cellOutputWeight;
+    outputGate = 1.0 / (1 + arma::exp(-outputGate));
+
+    outCalc = outputGate % arma::tanh(cellCalc);
+
+    CheckMatrices(outLstm, outCalc, 1e-10);
+  }
+}
+
 /**
  * Test that the functions that can modify and access the parameters of the
  * GRU layer work.
@@ -1995,6 +2059,40 @@ TEST_CASE("LookupLayerParametersTest", "[ANNLayerTest]")
   REQUIRE(layer.EmbeddingSize() == 8);
 }
 
+/**
+ * Make sure that the gradient of the Lookup layer is right when the same
+ * gradient matrix is reused with different tokens.
+ */
+TEST_CASE("LookupLayerSparseGradientTest", "[ANNLayerTest]")
+{
+  const size_t vocabSize = 50, embeddingSize = 4, seqLength = 3;
+  Lookup<> layer(vocabSize, embeddingSize);
+
+  arma::mat gradient;
+  for (size_t trial = 0; trial < 3; ++trial)
+  {
+    arma::mat input(seqLength, 2);
+    for (size_t i = 0; i < input.n_elem; ++i)
+      input(i) = math::RandInt(1, vocabSize + 1);
+    const arma::mat error(embeddingSize * seqLength, 2, arma::fill::randu);
+
+    layer.Gradient(input, error, gradient);
+
+    arma::mat expected(embeddingSize, vocabSize, arma::fill::zeros);
+    for (size_t i = 0; i < input.n_cols; ++i)
+    {
+      for (size_t j = 0; j < seqLength; ++j)
+      {
+        const size_t token = (size_t) input(j, i) - 1;
+        expected.col(token) += error.submat(j * embeddingSize, i,
+            (j + 1) * embeddingSize - 1, i);
+      }
+    }
+
+    CheckMatrices(gradient, expected);
+  }
+}
+
 /**
  * Simple LogSoftMax module test.
  */
@@ -3968,6 +4066,74 @@ TEST_CASE("MaxPoolingTestCase", "[ANNLayerTest]")
   REQUIRE(output.n_cols == 1);
 }
 
+/**
+ * Compare the max and mean pooling of a batch of multi-channel inputs with the
+ * maxima and means of the windows, and make sure the error of every window is
+ * routed to its maximum.
+ */
+TEST_CASE("PoolingWindowsTest", "[ANNLayerTest]")
+{
+  const size_t inputWidth = 7, inputHeight = 6, channels = 3, batchSize = 4;
+  const size_t kernelWidth = 3, kernelHeight = 2, strideWidth = 2;
+  const size_t strideHeight = 1;
+  const size_t outputWidth = 3, outputHeight = 5;
+
+  arma::mat input = arma::randu<arma::mat>(inputWidth * inputHeight * channels,
+      batchSize);
+  arma::mat maxOutput, meanOutput, delta;
+
+  MaxPooling<> maxPooling(kernelWidth, kernelHeight, strideWidth,
+      strideHeight);
+  maxPooling.InputWidth() = inputWidth;
+  maxPooling.InputHeight() = inputHeight;
+  maxPooling.Forward(input, maxOutput);
+
+  MeanPooling<> meanPooling(kernelWidth, kernelHeight, strideWidth,
+      strideHeight);
+  meanPooling.InputWidth() = inputWidth;
+  meanPooling.InputHeight() = inputHeight;
+  meanPooling.Forward(input, meanOutput);
+
+  REQUIRE(maxOutput.n_rows == outputWidth * outputHeight * channels);
+  REQUIRE(maxOutput.n_cols == batchSize);
+  REQUIRE(meanOutput.n_rows == maxOutput.n_rows);
+
+  // Every output gets a distinct error, so that it can be traced back.
+  arma::mat error = arma::linspace<arma::vec>(1, maxOutput.n_elem,
+      maxOutput.n_elem);
+  error.reshape(maxOutput.n_rows, maxOutput.n_cols);
+  maxPooling.Backward(input, error, delta);
+
+  arma::mat expectedDelta(arma::size(input), arma::fill::zeros);
+  const arma::cube slices(input.memptr(), inputWidth, inputHeight,
+      channels * batchSize, false, true);
+  arma::cube expectedDeltaSlices(expectedDelta.memptr(), inputWidth,
+      inputHeight, channels * batchSize, false, true);
+  for (size_t s = 0; s < slices.n_slices; ++s)
+  {
+    for (size_t j = 0; j < outputHeight; ++j)
+    {
+      for (size_t i = 0; i < outputWidth; ++i)
+      {
+        const arma::mat window = slices.slice(s).submat(i * strideWidth,
+            j * strideHeight, i * strideWidth + kernelWidth - 1,
+            j * strideHeight + kernelHeight - 1);
+        const size_t o = s * outputWidth * outputHeight + j * outputWidth + i;
+
+        REQUIRE(maxOutput(o) == window.max());
+        REQUIRE(meanOutput(o) == Approx(arma::mean(arma::vectorise(window)))
+            .epsilon(1e-7));
+
+        const arma::uword index = window.index_max();
+        expectedDeltaSlices(i * strideWidth + index % kernelWidth,
+            j * strideHeight + index / kernelWidth, s) += error(o);
+      }
+    }
+  }
+
+  CheckMatrices(delta, expectedDelta);
+}
+
 /**
  * Test that the functions that can modify and access the parameters of the
  * Glimpse layer work.
@@ -5052,3 +5218,281 @@ TEST_CASE("GradientMultiheadAttentionTest", "[ANNLayerTest]")
 
   REQUIRE(CheckGradient(function) <= 3e-06);
 }
+
+/**
+ * Test that the MultiheadAttention layer gives the right results when the
+ * source sequence is longer than the block of source positions that is
+ * processed at once.
+ */
+TEST_CASE("BlockedMultiheadAttentionTest", "[ANNLayerTest]")
+{
+  const size_t tgtSeqLen = 3;
+  const size_t srcSeqLen = 150;
+  const size_t embedDim = 4;
+  const size_t nHeads = 2;
+  const size_t headDim = embedDim / nHeads;
+
+  arma::mat query = arma::randu(embedDim * tgtSeqLen, 1);
+  arma::mat key = 0.1 * arma::randu(embedDim * srcSeqLen, 1);
+  arma::mat value = 0.1 * arma::randu(embedDim * srcSeqLen, 1);
+  arma::mat input = arma::join_cols(arma::join_cols(query, key), value);
+
+  arma::mat keyPaddingMask = arma::zeros(1, srcSeqLen);
+  keyPaddingMask(srcSeqLen - 1) = std::numeric_limits<double>::lowest();
+
+  MultiheadAttention<> module(tgtSeqLen, srcSeqLen, embedDim, nHeads);
+  module.KeyPaddingMask() = keyPaddingMask;
+  module.Reset();
+  module.Parameters().randu();
+
+  arma::mat output;
+  module.Forward(input, output);
+
+  // Compute the attention directly.
+  const arma::mat& weights = module.Parameters();
+  const size_t wtSize = embedDim * embedDim;
+  const arma::mat queryWt(weights.memptr(), embedDim, embedDim);
+  const arma::mat keyWt(weights.memptr() + wtSize, embedDim, embedDim);
+  const arma::mat valueWt(weights.memptr() + 2 * wtSize, embedDim, embedDim);
+  const arma::mat outWt(weights.memptr() + 3 * wtSize, embedDim, embedDim);
+  const arma::vec qBias(weights.memptr() + 4 * wtSize, embedDim);
+  const arma::vec kBias(weights.memptr() + 4 * wtSize + embedDim, embedDim);
+  const arma::vec vBias(weights.memptr() + 4 * wtSize + 2 * embedDim,
+      embedDim);
+  const arma::rowvec outBias(weights.memptr() + 4 * wtSize + 3 * embedDim,
+      embedDim);
+
+  arma::mat q = arma::trans(queryWt * arma::reshape(query, embedDim,
+      tgtSeqLen) + arma::repmat(qBias, 1, tgtSeqLen)) / std::sqrt(headDim);
+  arma::mat k = arma::trans(keyWt * arma::reshape(key, embedDim, srcSeqLen)
+      + arma::repmat(kBias, 1, srcSeqLen));
+  arma::mat v = arma::trans(valueWt * arma::reshape(value, embedDim,
+      srcSeqLen) + arma::repmat(vBias, 1, srcSeqLen));
+
+  arma::mat attnOut(tgtSeqLen, embedDim);
+  for (size_t h = 0; h < nHeads; ++h)
+  {
+    const size_t first = h * headDim;
+    const size_t last = (h + 1) * headDim - 1;
+    arma::mat scores = q.cols(first, last) * k.cols(first, last).t();
+    scores.each_row() += keyPaddingMask;
+    scores = arma::exp(scores.each_row() - arma::max(scores, 0));
+    scores.each_row() /= arma::sum(scores, 0);
+    attnOut.cols(first, last) = scores * v.cols(first, last);
+  }
+
+  arma::mat expected = arma::vectorise(arma::trans(attnOut * outWt +
+      arma::repmat(outBias, tgtSeqLen, 1)));
+  CheckMatrices(output, expected, 1e-5);
+
+  // The backward pass recomputes the attention weights block by block.
+  double error = JacobianTest(module, input);
+  REQUIRE(error <= 1e-5);
+}
+
+/**
+ * Test that the Convolution, BatchNorm, MaxPooling, Linear and LogSoftMax
+ * layers give the same results with single precision as with double precision.
+ */
+TEST_CASE("SinglePrecisionLayersTest", "[ANNLayerTest]")
+{
+  typedef Convolution<NaiveConvolution<ValidConvolution>,
+                      NaiveConvolution<FullConvolution>,
+                      NaiveConvolution<ValidConvolution>,
+                      arma::fmat, arma::fmat> FloatConvolution;
+
+  // Two input maps of size 5 x 5, three output maps and 3 x 3 filters with
+  // a padding of 1.
+  Convolution<> conv(2, 3, 3, 3, 1, 1, 1, 1, 5, 5);
+  FloatConvolution convFloat(2, 3, 3, 3, 1, 1, 1, 1, 5, 5);
+  conv.Parameters().randu();
+  convFloat.Parameters() = arma::conv_to<arma::fmat>::from(conv.Parameters());
+  conv.Reset();
+  convFloat.Reset();
+
+  BatchNorm<> batchNorm(3);
+  BatchNorm<arma::fmat, arma::fmat> batchNormFloat(3);
+  batchNorm.Reset();
+  batchNormFloat.Reset();
+
+  MaxPooling<> pooling(2, 2, 1, 1);
+  MaxPooling<arma::fmat, arma::fmat> poolingFloat(2, 2, 1, 1);
+  pooling.InputWidth() = poolingFloat.InputWidth() = 5;
+  pooling.InputHeight() = poolingFloat.InputHeight() = 5;
+
+  Linear<> linear(4 * 4 * 3, 10);
+  Linear<arma::fmat, arma::fmat> linearFloat(4 * 4 * 3, 10);
+  linear.Parameters().randu();
+  linearFloat.Parameters() =
+      arma::conv_to<arma::fmat>::from(linear.Parameters());
+  linear.Reset();
+  linearFloat.Reset();
+
+  LogSoftMax<> logSoftMax;
+  LogSoftMax<arma::fmat, arma::fmat> logSoftMaxFloat;
+
+  // Forward pass.
+  arma::mat input(5 * 5 * 2, 4, arma::fill::randu);
+  arma::mat convOutput, normOutput, poolOutput, linearOutput, output;
+  conv.Forward(input, convOutput);
+  batchNorm.Forward(convOutput, normOutput);
+  pooling.Forward(normOutput, poolOutput);
+  linear.Forward(poolOutput, linearOutput);
+  logSoftMax.Forward(linearOutput, output);
+
+  arma::fmat inputFloat = arma::conv_to<arma::fmat>::from(input);
+  arma::fmat convOutputFloat, normOutputFloat, poolOutputFloat,
+      linearOutputFloat, outputFloat;
+  convFloat.Forward(inputFloat, convOutputFloat);
+  batchNormFloat.Forward(convOutputFloat, normOutputFloat);
+  poolingFloat.Forward(normOutputFloat, poolOutputFloat);
+  linearFloat.Forward(poolOutputFloat, linearOutputFloat);
+  logSoftMaxFloat.Forward(linearOutputFloat, outputFloat);
+
+  CheckMatrices(output, arma::conv_to<arma::mat>::from(outputFloat), 0.1);
+
+  // Backward pass.
+  arma::mat error(output.n_rows, output.n_cols, arma::fill::randu);
+  arma::mat linearError, poolError, normError, convError, delta;
+  logSoftMax.Backward(output, error, linearError);
+  linear.Backward(linearOutput, linearError, poolError);
+  pooling.Backward(poolOutput, poolError, normError);
+  batchNorm.Backward(convOutput, normError, convError);
+  conv.Backward(input, convError, delta);
+
+  arma::fmat errorFloat = arma::conv_to<arma::fmat>::from(error);
+  arma::fmat linearErrorFloat, poolErrorFloat, normErrorFloat, convErrorFloat,
+      deltaFloat;
+  logSoftMaxFloat.Backward(outputFloat, errorFloat, linearErrorFloat);
+  linearFloat.Backward(linearOutputFloat, linearErrorFloat, poolErrorFloat);
+  poolingFloat.Backward(poolOutputFloat, poolErrorFloat, normErrorFloat);
+  batchNormFloat.Backward(convOutputFloat, normErrorFloat, convErrorFloat);
+  convFloat.Backward(inputFloat, convErrorFloat, deltaFloat);
+
+  CheckMatrices(delta, arma::conv_to<arma::mat>::from(deltaFloat), 0.1);
+
+  // Gradients.
+  arma::mat gradient;
+  arma::fmat gradientFloat;
+  linear.Gradient(poolOutput, linearError, gradient);
+  linearFloat.Gradient(poolOutputFloat, linearErrorFloat, gradientFloat);
+  CheckMatrices(gradient, arma::conv_to<arma::mat>::from(gradientFloat), 0.1);
+
+  batchNorm.Gradient(convOutput, normError, gradient);
+  batchNormFloat.Gradient(convOutputFloat, normErrorFloat, gradientFloat);
+  CheckMatrices(gradient, arma::conv_to<arma::mat>::from(gradientFloat), 0.1);
+
+  conv.Gradient(input, convError, gradient);
+  convFloat.Gradient(inputFloat, convErrorFloat, gradientFloat);
+  CheckMatrices(gradient, arma::conv_to<arma::mat>::from(gradientFloat), 0.1);
+}
+
+/**
+ * Test that the Convolution layer gives the same results with the
+ * Im2ColConvolution rules as with the default rules.
+ */
+TEST_CASE("Im2ColConvolutionLayerTest", "[ANNLayerTest]")
+{
+  typedef Convolution<Im2ColConvolution<ValidConvolution>,
+                      Im2ColConvolution<FullConvolution>,
+                      Im2ColConvolution<ValidConvolution> >
+      Im2ColConvolutionLayer;
+
+  // Two input maps of size 7 x 6, three output maps and 3 x 3 filters with
+  // a padding of 1.
+  Convolution<> naive(2, 3, 3, 3, 1, 1, 1, 1, 7, 6);
+  Im2ColConvolutionLayer im2col(2, 3, 3, 3, 1, 1, 1, 1, 7, 6);
+  naive.Reset();
+  im2col.Reset();
+  naive.Parameters().randu();
+  im2col.Parameters() = naive.Parameters();
+
+  // A single point and a batch of several points, where the gradient of the
+  // bias sums over the batch.
+  for (size_t batchSize = 1; batchSize <= 3; batchSize += 2)
+  {
+    arma::mat input(7 * 6 * 2, batchSize, arma::fill::randu);
+    arma::mat naiveOutput, im2colOutput;
+    naive.Forward(input, naiveOutput);
+    im2col.Forward(input, im2colOutput);
+    CheckMatrices(naiveOutput, im2colOutput, 1e-5);
+
+    arma::mat error(naiveOutput.n_rows, batchSize, arma::fill::randu);
+    arma::mat naiveDelta, im2colDelta;
+    naive.Backward(input, error, naiveDelta);
+    im2col.Backward(input, error, im2colDelta);
+    CheckMatrices(naiveDelta, im2colDelta, 1e-5);
+
+    arma::mat naiveGradient, im2colGradient;
+    naive.Gradient(input, error, naiveGradient);
+    im2col.Gradient(input, error, im2colGradient);
+    CheckMatrices(naiveGradient, im2colGradient, 1e-5);
+  }
+}
+
+/**
+ * Numerically check the gradient of the Convolution and AtrousConvolution
+ * layers with the Im2ColConvolution rules, using strides, dilation and a
+ * batch of several points.
+ */
+TEST_CASE("GradientIm2ColConvolutionLayerTest", "[ANNLayerTest]")
+{
+  typedef Convolution<Im2ColConvolution<ValidConvolution>,
+                      Im2ColConvolution<FullConvolution>,
+                      Im2ColConvolution<ValidConvolution> >
+      Im2ColConvolutionLayer;
+  typedef AtrousConvolution<Im2ColConvolution<ValidConvolution>,
+                            Im2ColConvolution<FullConvolution>,
+                            Im2ColConvolution<ValidConvolution> >
+      Im2ColAtrousConvolutionLayer;
+
+  struct GradientFunction
+  {
+    GradientFunction(const bool atrous) :
+        input(arma::randu<arma::mat>(7 * 7 * 2, 3)),
+        target(arma::mat("0 3 5"))
+    {
+      model = new FFN<NegativeLogLikelihood<>, RandomInitialization,
+          Im2ColConvolutionLayer, Im2ColAtrousConvolutionLayer>();
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<IdentityLayer<> >();
+      if (atrous)
+      {
+        // Output maps of size 5 x 5.
+        model->Add<Im2ColAtrousConvolutionLayer>(2, 2, 3, 3, 1, 1, 1, 1, 7,
+            7, 2, 2);
+      }
+      else
+      {
+        // Output maps of size 4 x 4.
+        model->Add<Im2ColConvolutionLayer>(2, 2, 3, 3, 2, 2, 1, 1, 7, 7);
+      }
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 3);
+      model->Gradient(model->Parameters(), 0, gradient, 3);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<NegativeLogLikelihood<>, RandomInitialization,
+        Im2ColConvolutionLayer, Im2ColAtrousConvolutionLayer>* model;
+    arma::mat input, target;
+  };
+
+  GradientFunction convolution(false);
+  REQUIRE(CheckGradient(convolution) <= 1e-4);
+
+  GradientFunction atrous(true);
+  REQUIRE(CheckGradient(atrous) <= 1e-4);
+}
@@ -376,6 +376,118 @@ TEST_CASE("BestBinaryNumericSplitNoGainTest", "[DecisionTreeTest]")
   REQUIRE(classProbabilities.n_elem == 0);
 }
 
+/**
+ * Check that the HistogramNumericSplit will split on an obviously splittable
+ * dimension.
+ */
+TEST_CASE("HistogramNumericSplitSimpleSplitTest", "[DecisionTreeTest]")
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0");
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1");
+  arma::rowvec weights(labels.n_elem);
+  weights.ones();
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  // Call the method to do the splitting.
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, classProbabilities,
+      aux);
+  const double weightedGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain, values,
+      labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+
+  // Make sure that a split was made.
+  REQUIRE(gain > bestGain);
+
+  // Make sure weight works and is not different than the unweighted one.
+  REQUIRE(gain == weightedGain);
+
+  // The split is perfect, so we should be able to accomplish a gain of 0.
+  REQUIRE(gain == Approx(0.0).margin(1e-7));
+
+  // The split value is the upper boundary of the last bin on the left, which
+  // should be between 0.4 and 0.5.
+  REQUIRE(classProbabilities.n_elem == 1);
+  REQUIRE(classProbabilities[0] >= 0.4);
+  REQUIRE(classProbabilities[0] < 0.5);
+}
+
+/**
+ * Check that the HistogramNumericSplit won't split if not enough points are
+ * given, or if the dimension gives no gain.
+ */
+TEST_CASE("HistogramNumericSplitNoSplitTest", "[DecisionTreeTest]")
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0");
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1");
+  arma::rowvec weights;
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 8, 1e-7, classProbabilities,
+      aux);
+
+  REQUIRE(gain == DBL_MAX);
+  REQUIRE(classProbabilities.n_elem == 0);
+
+  // Now each value holds one point of each class.
+  values.set_size(100);
+  labels.set_size(100);
+  for (size_t i = 0; i < 100; i += 2)
+  {
+    values[i] = i;
+    labels[i] = 0;
+    values[i + 1] = i;
+    labels[i + 1] = 1;
+  }
+
+  bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain,
+      values, labels, 2, weights, 10, 1e-7, classProbabilities, aux);
+
+  REQUIRE(gain == DBL_MAX);
+  REQUIRE(classProbabilities.n_elem == 0);
+}
+
+/**
+ * Make sure that the HistogramNumericSplit never uses more than 256 bins, and
+ * that the bins are consistent with the boundaries.
+ */
+TEST_CASE("HistogramNumericSplitBinTest", "[DecisionTreeTest]")
+{
+  arma::rowvec values(50000, arma::fill::randu);
+
+  std::vector<double> boundaries;
+  HistogramNumericSplit<GiniGain>::BinBoundaries(values, boundaries);
+  REQUIRE(boundaries.size() <= 255);
+  REQUIRE(boundaries.size() > 200);
+  for (size_t i = 1; i < boundaries.size(); ++i)
+    REQUIRE(boundaries[i - 1] < boundaries[i]);
+
+  arma::Row<uint8_t> bins;
+  HistogramNumericSplit<GiniGain>::Bin(values, boundaries, bins);
+  REQUIRE(bins.n_elem == values.n_elem);
+  for (size_t i = 0; i < values.n_elem; ++i)
+  {
+    if (bins[i] < boundaries.size())
+      REQUIRE(values[i] <= boundaries[bins[i]]);
+    if (bins[i] > 0)
+      REQUIRE(values[i] > boundaries[bins[i] - 1]);
+  }
+
+  // The bins should be roughly balanced.
+  arma::uvec binCounts(boundaries.size() + 1, arma::fill::zeros);
+  for (size_t i = 0; i < bins.n_elem; ++i)
+    ++binCounts[bins[i]];
+  REQUIRE(binCounts.max() < 4 * values.n_elem / binCounts.n_elem);
+}
+
 /**
  * Check that the AllCategoricalSplit will split when the split is obviously
  * better.
@@ -701,6 +813,137 @@ TEST_CASE("SimpleGeneralizationTest", "[DecisionTreeTest]")
   REQUIRE(wdcorrect > 0.75);
 }
 
+/**
+ * Test that a decision tree built with the HistogramNumericSplit generalizes
+ * reasonably.
+ */
+TEST_CASE("HistogramSplitGeneralizationTest", "[DecisionTreeTest]")
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::rowvec weights(labels.n_cols, arma::fill::ones);
+
+  // Build decision trees.
+  DecisionTree<GiniGain, HistogramNumericSplit> d(inputData, labels, 3, 10);
+  DecisionTree<GiniGain, HistogramNumericSplit> wd(inputData, labels, 3,
+      weights, 10);
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    FAIL("Cannot load test dataset vc2_test.csv!");
+
+  arma::Row<size_t> trueTestLabels;
+  if (!data::Load("vc2_test_labels.txt", trueTestLabels))
+    FAIL("Cannot load labels for vc2_test_labels.txt");
+
+  arma::Row<size_t> predictions, weightedPredictions;
+  d.Classify(testData, predictions);
+  wd.Classify(testData, weightedPredictions);
+
+  REQUIRE(predictions.n_elem == testData.n_cols);
+  REQUIRE(weightedPredictions.n_elem == testData.n_cols);
+
+  const double correct = (double) arma::accu(predictions == trueTestLabels) /
+      predictions.n_elem;
+  const double wdcorrect = (double) arma::accu(weightedPredictions ==
+      trueTestLabels) / weightedPredictions.n_elem;
+
+  REQUIRE(correct > 0.75);
+  REQUIRE(wdcorrect > 0.75);
+}
+
+/**
+ * Make sure that a decision tree built with the HistogramNumericSplit gives the
+ * same tree whether it is trained with or without unit weights, through the
+ * indexed Train(), and with bins given by BinData(), on a dataset large enough
+ * that the histograms of the children are computed by subtraction and in
+ * parallel.  Also make sure that the split of a child whose histograms were
+ * computed by subtraction is the split found from histograms built directly
+ * from the points of the child.
+ */
+TEST_CASE("HistogramSplitSubtractionTest", "[DecisionTreeTest]")
+{
+  typedef DecisionTree<GiniGain, HistogramNumericSplit> HistogramTree;
+
+  arma::mat dataset(5, 10000, arma::fill::randu);
+  arma::Row<size_t> labels(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    labels[i] = (dataset(0, i) > 0.5 ? 1 : 0) + (dataset(1, i) > 0.3 ? 1 : 0);
+  arma::rowvec weights(dataset.n_cols, arma::fill::ones);
+
+  HistogramTree d(dataset, labels, 3, 10);
+  HistogramTree wd(dataset, labels, 3, weights, 10);
+
+  HistogramTree id;
+  arma::uvec indices = arma::linspace<arma::uvec>(0, dataset.n_cols - 1,
+      dataset.n_cols);
+  data::DatasetInfo info(dataset.n_rows);
+  id.Train<false>(dataset, indices, info, labels, 3, weights, 10, 1e-7, 0,
+      AllDimensionSelect());
+
+  REQUIRE(d.NumChildren() == 2);
+  REQUIRE(wd.NumChildren() == 2);
+  REQUIRE(id.NumChildren() == 2);
+
+  arma::Row<size_t> predictions, weightedPredictions, indexedPredictions;
+  d.Classify(dataset, predictions);
+  wd.Classify(dataset, weightedPredictions);
+  id.Classify(dataset, indexedPredictions);
+
+  REQUIRE(arma::all(predictions == weightedPredictions));
+  REQUIRE(arma::all(predictions == indexedPredictions));
+
+  const double correct = (double) arma::accu(predictions == labels) /
+      labels.n_elem;
+  REQUIRE(correct > 0.95);
+
+  // Bin the dataset once, as a random forest does; the boundaries are those
+  // the root of the tree computes from all points.
+  HistogramTree::BinnedData binned;
+  HistogramTree::BinData(dataset, info, binned);
+  HistogramTree bd;
+  bd.Train<false>(dataset, indices, info, labels, 3, weights, 10, 1e-7, 0,
+      AllDimensionSelect(), &binned);
+
+  arma::Row<size_t> binnedPredictions;
+  bd.Classify(dataset, binnedPredictions);
+  REQUIRE(arma::all(predictions == binnedPredictions));
+
+  // The histograms of the largest child of the root are those of the root
+  // minus those of the other child.  A tree trained on the points of that child
+  // alone builds its histograms directly from the same bins, so it has to find
+  // the same split.
+  arma::Row<size_t> directions(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    directions[i] = bd.CalculateDirection(dataset.col(i));
+  const size_t largest = (arma::accu(directions == 1) >
+      arma::accu(directions == 0)) ? 1 : 0;
+  const arma::uvec childIndices = arma::find(directions == largest);
+  const HistogramTree& child = bd.Child(largest);
+  REQUIRE(child.NumChildren() == 2);
+
+  HistogramTree cd;
+  cd.Train<false>(dataset, childIndices, info, labels, 3, weights, 10, 1e-7, 2,
+      AllDimensionSelect(), &binned);
+  REQUIRE(cd.NumChildren() == 2);
+  REQUIRE(cd.SplitDimension() == child.SplitDimension());
+
+  size_t sameDirection = 0;
+  for (size_t i = 0; i < childIndices.n_elem; ++i)
+  {
+    if (cd.CalculateDirection(dataset.col(childIndices[i])) ==
+        child.CalculateDirection(dataset.col(childIndices[i])))
+      ++sameDirection;
+  }
+  REQUIRE(sameDirection == childIndices.n_elem);
+}
+
 /**
  * Test that we can build a decision tree on a simple categorical dataset.
  */
@@ -1241,3 +1484,64 @@ TEST_CASE("DifferentMaximumDepthTest", "[DecisionTreeTest]")
   REQUIRE(d2.Child(0).NumChildren() == 2);
   REQUIRE(d2.Child(1).NumChildren() == 2);
 }
+
+/**
+ * Make sure that training on a large dataset (where the candidate dimensions
+ * and the subtrees are handled in parallel) gives the same tree as training
+ * with a single thread.
+ */
+TEST_CASE("DecisionTreeParallelTrainingTest", "[DecisionTreeTest]")
+{
+  // The labels depend on a few of the dimensions, and are noisy, so that the
+  // tree is deep.
+  arma::mat dataset(10, 10000, arma::fill::randu);
+  arma::Row<size_t> labels(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    const double value = dataset(2, i) + 0.5 * dataset(5, i) +
+        0.2 * dataset(7, i) + 0.2 * math::Random();
+    labels[i] = (value > 1.0) ? 2 : (value > 0.6) ? 1 : 0;
+  }
+  arma::rowvec weights(dataset.n_cols, arma::fill::randu);
+
+  DecisionTree<> tree;
+  const double gain = tree.Train(dataset, labels, 3, 5);
+  DecisionTree<> weightedTree;
+  const double weightedGain = weightedTree.Train(dataset, labels, 3, weights,
+      5);
+
+  // Train the same trees with a single thread.
+  #ifdef HAS_OPENMP
+  const int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  #endif
+
+  DecisionTree<> serialTree;
+  const double serialGain = serialTree.Train(dataset, labels, 3, 5);
+  DecisionTree<> serialWeightedTree;
+  const double serialWeightedGain = serialWeightedTree.Train(dataset, labels,
+      3, weights, 5);
+
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(threads);
+  #endif
+
+  REQUIRE(gain == Approx(serialGain).epsilon(1e-7));
+  REQUIRE(weightedGain == Approx(serialWeightedGain).epsilon(1e-7));
+
+  arma::mat testData(10, 2000, arma::fill::randu);
+  arma::Row<size_t> predictions, serialPredictions;
+  arma::mat probabilities, serialProbabilities;
+  tree.Classify(testData, predictions, probabilities);
+  serialTree.Classify(testData, serialPredictions, serialProbabilities);
+  REQUIRE(arma::all(predictions == serialPredictions));
+  REQUIRE(arma::approx_equal(probabilities, serialProbabilities, "absdiff",
+      1e-10));
+
+  weightedTree.Classify(testData, predictions, probabilities);
+  serialWeightedTree.Classify(testData, serialPredictions,
+      serialProbabilities);
+  REQUIRE(arma::all(predictions == serialPredictions));
+  REQUIRE(arma::approx_equal(probabilities, serialProbabilities, "absdiff",
+      1e-10));
+}
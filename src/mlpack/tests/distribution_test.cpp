@@ -453,6 +453,38 @@ TEST_CASE("GaussianMultipointMultivariateProbabilityTest", "[DistributionTest]")
   REQUIRE(phis(5) == Approx(-14.900192463287908).epsilon(1e-7));
 }
 
+/**
+ * Make sure that the GaussianDistribution::LogProbability() overload with an
+ * external workspace gives the same results, also when the workspace is reused.
+ */
+TEST_CASE("GaussianWorkspaceLogProbabilityTest", "[DistributionTest]")
+{
+  arma::mat points = arma::randu<arma::mat>(4, 50);
+  arma::mat cov = arma::randu<arma::mat>(4, 4);
+  cov = cov * cov.t() + arma::eye<arma::mat>(4, 4);
+  GaussianDistribution g(arma::randu<arma::vec>(4), cov);
+
+  arma::vec phis, phis2;
+  arma::mat workspace;
+  g.LogProbability(points, phis);
+  g.LogProbability(points, phis2, workspace);
+
+  REQUIRE(workspace.n_rows == 4);
+  REQUIRE(workspace.n_cols == 100);
+  REQUIRE(phis2.n_elem == 50);
+  for (size_t i = 0; i < 50; ++i)
+  {
+    REQUIRE(phis2(i) == Approx(phis(i)).epsilon(1e-7));
+    REQUIRE(phis2(i) == Approx(g.LogProbability(points.col(i))).epsilon(1e-7));
+  }
+
+  // Reuse the workspace on new points.
+  points = arma::randu<arma::mat>(4, 50);
+  g.LogProbability(points, phis2, workspace);
+  for (size_t i = 0; i < 50; ++i)
+    REQUIRE(phis2(i) == Approx(g.LogProbability(points.col(i))).epsilon(1e-7));
+}
+
 /**
  * Make sure random observations follow the probability distribution correctly.
  */
@@ -1424,6 +1456,34 @@ TEST_CASE("DiagonalGaussianMultipointMultivariateProbabilityTest",
   REQUIRE(phis(5) == Approx(-13.647746496371308).epsilon(1e-7));
 }
 
+/**
+ * Make sure that the DiagonalGaussianDistribution::LogProbability() overload
+ * with an external workspace gives the same results, also when the workspace is
+ * reused.
+ */
+TEST_CASE("DiagonalGaussianWorkspaceLogProbabilityTest", "[DistributionTest]")
+{
+  arma::mat points = arma::randu<arma::mat>(5, 50);
+  DiagonalGaussianDistribution d(arma::randu<arma::vec>(5),
+      arma::randu<arma::vec>(5) + 0.5);
+
+  arma::vec phis;
+  arma::mat workspace;
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    d.LogProbability(points, phis, workspace);
+
+    REQUIRE(phis.n_elem == 50);
+    for (size_t i = 0; i < 50; ++i)
+    {
+      REQUIRE(phis(i) ==
+          Approx(d.LogProbability(points.col(i))).epsilon(1e-7));
+    }
+
+    points = arma::randu<arma::mat>(5, 50);
+  }
+}
+
 /**
  * Make sure random observations follow the probability distribution correctly.
  */
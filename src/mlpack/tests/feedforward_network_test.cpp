@@ -14,6 +14,7 @@
 
 #include <mlpack/methods/ann/layer/layer.hpp>
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
+#include <mlpack/methods/ann/regularizer/regularizer.hpp>
 #include <mlpack/methods/ann/ffn.hpp>
 
 #include <ensmallen.hpp>
@@ -1008,3 +1009,429 @@ TEST_CASE("FFNCheckInputShapeTest", "[FeedForwardNetworkTest]")
 
   REQUIRE_THROWS_AS(model.Train(trainData, trainLabels, opt), std::logic_error);
 }
+
+/**
+ * Test that the predictions of a network do not depend on the batch size used
+ * by Predict().
+ */
+TEST_CASE("FFNPredictBatchSizeTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(10, 100, arma::fill::randu);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+
+  arma::mat predictions;
+  model.Predict(data, predictions, 1);
+
+  REQUIRE(predictions.n_rows == 3);
+  REQUIRE(predictions.n_cols == 100);
+
+  const size_t batchSizes[] = { 7, 100, 1000 };
+  for (const size_t batchSize : batchSizes)
+  {
+    arma::mat batchPredictions;
+    model.Predict(data, batchPredictions, batchSize);
+
+    REQUIRE(batchPredictions.n_rows == predictions.n_rows);
+    REQUIRE(batchPredictions.n_cols == predictions.n_cols);
+    for (size_t i = 0; i < predictions.n_elem; ++i)
+      REQUIRE(batchPredictions[i] == Approx(predictions[i]).epsilon(1e-7));
+  }
+}
+
+/**
+ * Test that a network can still be used after layers are added to it or
+ * removed from it once it has been run.
+ */
+TEST_CASE("FFNModifyModelTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(5, 20, arma::fill::randu);
+
+  FFN<MeanSquaredError<> > model;
+  model.Add<Linear<> >(5, 4);
+  model.Add<SigmoidLayer<> >();
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+  REQUIRE(predictions.n_rows == 4);
+  REQUIRE(predictions.n_cols == 20);
+
+  // Add a layer and make sure the new output is used.
+  model.Add<Linear<> >(4, 2);
+  model.ResetParameters();
+  model.Predict(data, predictions);
+  REQUIRE(predictions.n_rows == 2);
+  REQUIRE(predictions.n_cols == 20);
+
+  // Remove the last layer through Model().
+  boost::apply_visitor(DeleteVisitor(), model.Model().back());
+  model.Model().pop_back();
+  model.ResetParameters();
+
+  // The copy of the network has to use its own layers.
+  FFN<MeanSquaredError<> > copy(model);
+  arma::mat copyPredictions;
+  model.Predict(data, predictions);
+  copy.Predict(data, copyPredictions);
+  REQUIRE(predictions.n_rows == 4);
+  REQUIRE(copyPredictions.n_rows == 4);
+  CheckMatrices(predictions, copyPredictions);
+}
+
+/**
+ * Make sure that folding BatchNorm layers into the preceding Linear and
+ * Convolution layers does not change the predictions of the network.
+ */
+TEST_CASE("FFNFuseLayersTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(36, 20, arma::fill::randu);
+
+  FFN<MeanSquaredError<> > model;
+  model.Add<IdentityLayer<> >();
+  model.Add<Convolution<> >(1, 2, 3, 3, 1, 1, 0, 0, 6, 6);
+  model.Add<BatchNorm<> >(2);
+  model.Add<ReLULayer<> >();
+  model.Add<Linear<> >(32, 5);
+  model.Add<BatchNorm<> >(5);
+  model.Add<Dropout<> >();
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(5, 3);
+  model.ResetParameters();
+
+  // Give the BatchNorm layers some statistics to fold.
+  for (size_t i = 0; i < model.Model().size(); ++i)
+  {
+    BatchNorm<>** layer = boost::get<BatchNorm<>*>(&model.Model()[i]);
+    if (layer != NULL)
+    {
+      (*layer)->Parameters().randu();
+      (*layer)->TrainingMean().randn();
+      (*layer)->TrainingVariance().randu();
+      (*layer)->TrainingVariance() += 0.5;
+    }
+  }
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  model.FuseLayers();
+
+  REQUIRE(model.Model().size() == 5);
+  REQUIRE(model.Parameters().n_elem == (18 + 2) + (32 * 5 + 5) + (5 * 3 + 3));
+
+  arma::mat fusedPredictions;
+  model.Predict(data, fusedPredictions);
+  CheckMatrices(predictions, fusedPredictions);
+
+  // Fusing again doesn't change anything.
+  model.FuseLayers();
+  REQUIRE(model.Model().size() == 5);
+  model.Predict(data, fusedPredictions);
+  CheckMatrices(predictions, fusedPredictions);
+}
+
+/**
+ * Make sure that the predictions of a quantized network are close to the
+ * predictions of the original network, and that the quantized network can be
+ * serialized.
+ */
+TEST_CASE("FFNQuantizeTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(36, 50, arma::fill::randu);
+
+  FFN<MeanSquaredError<> > model;
+  model.Add<Convolution<> >(1, 2, 3, 3, 1, 1, 1, 1, 6, 6);
+  model.Add<ReLULayer<> >();
+  model.Add<Linear<> >(72, 5);
+  model.Add<SigmoidLayer<> >();
+  model.Add<LinearNoBias<> >(5, 3);
+  model.ResetParameters();
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  model.Quantize(data, 16);
+
+  REQUIRE(model.Model().size() == 5);
+  REQUIRE(model.Parameters().n_elem == 0);
+  REQUIRE(boost::get<QuantizedConvolution<>*>(&model.Model()[0]) != NULL);
+  REQUIRE(boost::get<QuantizedLinear<>*>(&model.Model()[2]) != NULL);
+  REQUIRE(boost::get<QuantizedLinear<>*>(&model.Model()[4]) != NULL);
+
+  arma::mat quantizedPredictions;
+  model.Predict(data, quantizedPredictions);
+  REQUIRE(arma::abs(predictions - quantizedPredictions).max() <
+      0.02 * arma::abs(predictions).max());
+
+  FFN<MeanSquaredError<> > xmlModel, jsonModel, binaryModel;
+  xmlModel.Add<Linear<> >(10, 10); // Layer that will get removed.
+
+  SerializeObjectAll(model, xmlModel, jsonModel, binaryModel);
+
+  arma::mat xmlPredictions, jsonPredictions, binaryPredictions;
+  xmlModel.Predict(data, xmlPredictions);
+  jsonModel.Predict(data, jsonPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+
+  CheckMatrices(quantizedPredictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+}
+
+/**
+ * Make sure that training with several threads gives the same model as
+ * training with one thread, and that it is reproducible with a fixed seed.
+ */
+TEST_CASE("FFNDataParallelTrainTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(10, 64, arma::fill::randu);
+  arma::mat responses(3, 64, arma::fill::randu);
+
+  // Without random layers the result doesn't depend on the number of threads.
+  arma::mat parameters[2];
+  for (size_t threads = 1; threads <= 3; threads += 2)
+  {
+    FFN<MeanSquaredError<> > model;
+    model.Add<Linear<> >(10, 8);
+    model.Add<SigmoidLayer<> >();
+    model.Add<Linear<> >(8, 3);
+    model.Threads() = threads;
+
+    ens::StandardSGD opt(0.1, 16, 4 * data.n_cols, -100, false);
+    math::RandomSeed(42);
+    model.Train(data, responses, opt);
+    parameters[threads / 2] = model.Parameters();
+  }
+  CheckMatrices(parameters[0], parameters[1]);
+
+  // With dropout, the same seed gives the same model.
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    FFN<MeanSquaredError<> > model;
+    model.Add<Linear<> >(10, 8);
+    model.Add<Dropout<> >(0.3);
+    model.Add<SigmoidLayer<> >();
+    model.Add<Linear<> >(8, 3);
+    model.Threads() = 4;
+
+    ens::StandardSGD opt(0.1, 16, 4 * data.n_cols, -100, true);
+    math::RandomSeed(7);
+    model.Train(data, responses, opt);
+    parameters[trial] = model.Parameters();
+  }
+  REQUIRE(arma::approx_equal(parameters[0], parameters[1], "absdiff", 0.0));
+}
+
+/**
+ * Make sure that the penalty of a regularizer is added once when training with
+ * several threads.
+ */
+TEST_CASE("FFNDataParallelRegularizerTest", "[FeedForwardNetworkTest]")
+{
+  typedef Linear<arma::mat, arma::mat, L2Regularizer> RegularizedLinear;
+
+  arma::mat data(10, 64, arma::fill::randu);
+  arma::mat responses(3, 64, arma::fill::randu);
+
+  arma::mat parameters[2];
+  for (size_t threads = 1; threads <= 3; threads += 2)
+  {
+    FFN<MeanSquaredError<>, RandomInitialization, RegularizedLinear> model;
+    model.Add<RegularizedLinear>(10, 8, L2Regularizer(0.1));
+    model.Add<SigmoidLayer<> >();
+    model.Add<RegularizedLinear>(8, 3, L2Regularizer(0.1));
+    model.Threads() = threads;
+
+    ens::StandardSGD opt(0.1, 16, 4 * data.n_cols, -100, false);
+    math::RandomSeed(42);
+    model.Train(data, responses, opt);
+    parameters[threads / 2] = model.Parameters();
+  }
+  CheckMatrices(parameters[0], parameters[1]);
+}
+
+/**
+ * Make sure that the running mean of a BatchNorm layer is computed from the
+ * whole batch when training with several threads.
+ */
+TEST_CASE("FFNDataParallelBatchNormTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(10, 64, arma::fill::randu);
+  arma::mat responses(3, 64, arma::fill::randu);
+
+  // The parameters don't change, so every batch has the same input for the
+  // BatchNorm layer with any number of threads.
+  arma::mat means[2];
+  size_t counts[2];
+  for (size_t threads = 1; threads <= 3; threads += 2)
+  {
+    FFN<MeanSquaredError<> > model;
+    model.Add<Linear<> >(10, 8);
+    model.Add<BatchNorm<> >(8);
+    model.Add<SigmoidLayer<> >();
+    model.Add<Linear<> >(8, 3);
+    model.Threads() = threads;
+
+    ens::StandardSGD opt(0.0, 16, 4 * data.n_cols, -100, false);
+    math::RandomSeed(42);
+    model.Train(data, responses, opt);
+
+    BatchNorm<>* layer = boost::get<BatchNorm<>*>(model.Model()[1]);
+    means[threads / 2] = layer->TrainingMean();
+    counts[threads / 2] = layer->Count();
+  }
+  CheckMatrices(means[0], means[1]);
+  REQUIRE(counts[0] == counts[1]);
+}
+
+/**
+ * Make sure that the Lookup layer gives the same model with several threads,
+ * where the gradients of the replicas are summed into the gradient of the
+ * network.
+ */
+TEST_CASE("FFNDataParallelLookupTest", "[FeedForwardNetworkTest]")
+{
+  const size_t vocabSize = 20, embeddingSize = 4, seqLength = 3;
+  arma::mat data(seqLength, 64);
+  for (size_t i = 0; i < data.n_elem; ++i)
+    data(i) = math::RandInt(1, vocabSize + 1);
+  arma::mat responses(2, 64, arma::fill::randu);
+
+  arma::mat parameters[2];
+  for (size_t threads = 1; threads <= 2; ++threads)
+  {
+    FFN<MeanSquaredError<> > model;
+    model.Add<Lookup<> >(vocabSize, embeddingSize);
+    model.Add<Linear<> >(embeddingSize * seqLength, 2);
+    model.Threads() = threads;
+
+    ens::StandardSGD opt(0.1, 16, 4 * data.n_cols, -100, false);
+    math::RandomSeed(42);
+    model.Train(data, responses, opt);
+    parameters[threads - 1] = model.Parameters();
+  }
+  CheckMatrices(parameters[0], parameters[1]);
+}
+
+/**
+ * Make sure that the replicas of a network that hasn't seen any input yet infer
+ * the input sizes of layers like MaxPooling, so that training with several
+ * threads gives the same model as training with one thread.
+ */
+TEST_CASE("FFNDataParallelConvolutionTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(36, 64, arma::fill::randu);
+  arma::mat responses(3, 64, arma::fill::randu);
+
+  arma::mat parameters[2];
+  for (size_t threads = 1; threads <= 3; threads += 2)
+  {
+    FFN<MeanSquaredError<> > model;
+    model.Add<Convolution<> >(1, 2, 3, 3, 1, 1, 0, 0, 6, 6);
+    model.Add<MaxPooling<> >(2, 2, 2, 2);
+    model.Add<Linear<> >(8, 3);
+    model.Threads() = threads;
+
+    ens::StandardSGD opt(0.1, 16, 4 * data.n_cols, -100, false);
+    math::RandomSeed(42);
+    model.Train(data, responses, opt);
+    parameters[threads / 2] = model.Parameters();
+  }
+  CheckMatrices(parameters[0], parameters[1]);
+}
+
+/**
+ * Make sure that the BatchPrefetcher visits every point once per epoch, keeps
+ * the predictors and responses together, and handles batches that are not
+ * requested in order.
+ */
+TEST_CASE("BatchPrefetcherTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat predictors(3, 50);
+  for (size_t i = 0; i < predictors.n_cols; ++i)
+    predictors.col(i).fill(i);
+  const arma::mat responses = 2 * predictors.row(0);
+
+  BatchPrefetcher<arma::mat> prefetcher;
+  REQUIRE(!prefetcher.Shuffled());
+  prefetcher.Shuffle(predictors.n_cols);
+  REQUIRE(prefetcher.Shuffled());
+
+  for (size_t epoch = 0; epoch < 2; ++epoch)
+  {
+    arma::uvec visited(predictors.n_cols, arma::fill::zeros);
+    for (size_t begin = 0; begin < predictors.n_cols; begin += 16)
+    {
+      const size_t batchSize = std::min(size_t(16),
+          size_t(predictors.n_cols - begin));
+      prefetcher.Fetch(predictors, responses, begin, batchSize);
+
+      REQUIRE(prefetcher.Predictors().n_cols == batchSize);
+      CheckMatrices(prefetcher.Responses(),
+          2 * prefetcher.Predictors().row(0));
+      for (size_t i = 0; i < batchSize; ++i)
+        visited((size_t) prefetcher.Predictors()(1, i))++;
+    }
+    REQUIRE(arma::all(visited == 1));
+
+    // A batch that wasn't prefetched gives the same points.
+    prefetcher.Fetch(predictors, responses, 32, 16);
+    const arma::mat batch = prefetcher.Predictors();
+    prefetcher.Fetch(predictors, responses, 0, 16);
+    prefetcher.Fetch(predictors, responses, 32, 16);
+    CheckMatrices(batch, prefetcher.Predictors());
+
+    prefetcher.Shuffle(predictors.n_cols);
+  }
+
+  prefetcher.Reset();
+  REQUIRE(!prefetcher.Shuffled());
+}
+
+/**
+ * Make sure that the layer outputs don't share memory anymore once Predict()
+ * is done, so that the gradient can still be computed.
+ */
+TEST_CASE("FFNPredictWorkspaceTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(10, 50, arma::fill::randu);
+  arma::mat responses(3, 50, arma::fill::randu);
+
+  FFN<MeanSquaredError<> > model;
+  model.Add<Linear<> >(10, 10);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(10, 10);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(10, 3);
+  model.ResetParameters();
+
+  FFN<MeanSquaredError<> > copy(model);
+
+  arma::mat predictions;
+  model.Predict(data, predictions, 8);
+
+  for (size_t i = 0; i < model.Model().size(); ++i)
+  {
+    for (size_t j = i + 1; j < model.Model().size(); ++j)
+    {
+      const arma::mat& a = boost::apply_visitor(OutputParameterVisitor(),
+          model.Model()[i]);
+      const arma::mat& b = boost::apply_visitor(OutputParameterVisitor(),
+          model.Model()[j]);
+      if (!a.is_empty() && !b.is_empty())
+        REQUIRE(a.memptr() != b.memptr());
+    }
+  }
+
+  arma::mat results, copyResults, gradients, copyGradients;
+  model.Forward(data, results);
+  copy.Forward(data, copyResults);
+  CheckMatrices(results, copyResults);
+
+  model.Backward(data, responses, gradients);
+  copy.Backward(data, responses, copyGradients);
+  CheckMatrices(gradients, copyGradients);
+}
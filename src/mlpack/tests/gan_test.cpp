@@ -345,3 +345,68 @@ TEST_CASE("GANMemorySharingTest", "[GANNetworkTest]")
   CheckMatricesNotEqual(gan.Predictors().head_cols(trainData.n_cols),
       trainData);
 }
+
+/*
+ * Check that the concurrent passes of the Discriminator on the real and the
+ * generated data give the same gradient as the sequential passes, and that the
+ * next step uses the noise sampled during these passes.
+ */
+TEST_CASE("GANConcurrentPassesTest", "[GANNetworkTest]")
+{
+  const size_t batchSize = 8;
+  const size_t noiseDim = 2;
+
+  arma::mat trainData(1, 64);
+  trainData.imbue( [&]() { return arma::as_scalar(RandNormal(4, 0.5));});
+
+  // Create the Discriminator network.
+  FFN<SigmoidCrossEntropyError<> > discriminator;
+  discriminator.Add<Linear<> >(1, 16);
+  discriminator.Add<ReLULayer<> >();
+  discriminator.Add<Linear<> >(16, 1);
+
+  // Create the Generator network.
+  FFN<SigmoidCrossEntropyError<> > generator;
+  generator.Add<Linear<> >(noiseDim, 8);
+  generator.Add<SoftPlusLayer<> >();
+  generator.Add<Linear<> >(8, 1);
+
+  GaussianInitialization gaussian(0, 0.1);
+  std::function<double ()> noiseFunction = [](){ return
+      math::RandNormal(0, 1); };
+  GAN<FFN<SigmoidCrossEntropyError<> >, GaussianInitialization,
+      std::function<double()> > gan(generator, discriminator, gaussian,
+      noiseFunction, noiseDim, batchSize, 1, 0, 1);
+  GAN<FFN<SigmoidCrossEntropyError<> >, GaussianInitialization,
+      std::function<double()> > concurrentGan(generator, discriminator,
+      gaussian, noiseFunction, noiseDim, batchSize, 1, 0, 1);
+  concurrentGan.Concurrent() = true;
+
+  math::RandomSeed(3);
+  gan.ResetData(trainData);
+  math::RandomSeed(3);
+  concurrentGan.ResetData(trainData);
+
+  arma::mat gradient, concurrentGradient;
+  math::RandomSeed(5);
+  const double concurrentObjective = concurrentGan.EvaluateWithGradient(
+      concurrentGan.Parameters(), 0, concurrentGradient, batchSize);
+  math::RandomSeed(5);
+  const double objective = gan.EvaluateWithGradient(gan.Parameters(), 0,
+      gradient, batchSize);
+
+  REQUIRE(concurrentObjective == Approx(objective).epsilon(1e-10));
+  CheckMatrices(gradient, concurrentGradient, 1e-8);
+
+  // The next step uses the noise that was sampled ahead, after the seeds of the
+  // two passes were drawn, so the sequential GAN skips these two draws.
+  math::RandInt(std::numeric_limits<int>::max());
+  math::RandInt(std::numeric_limits<int>::max());
+  const double nextObjective = gan.EvaluateWithGradient(gan.Parameters(),
+      batchSize, gradient, batchSize);
+  const double nextConcurrentObjective = concurrentGan.EvaluateWithGradient(
+      concurrentGan.Parameters(), batchSize, concurrentGradient, batchSize);
+
+  REQUIRE(nextConcurrentObjective == Approx(nextObjective).epsilon(1e-10));
+  CheckMatrices(gradient, concurrentGradient, 1e-8);
+}
@@ -81,6 +81,48 @@ TEST_CASE("GMMProbabilityComponentTest", "[GMMTest]")
   REQUIRE(gmm.Probability("1.4 0", 1) == Approx(0.0067568972024).epsilon(1e-7));
 }
 
+/**
+ * Make sure the batch GMM::LogProbability() overloads give the same results as
+ * the single-observation versions.
+ */
+TEST_CASE("GMMBatchLogProbabilityTest", "[GMMTest]")
+{
+  // Create a GMM (same as the last test).
+  GMM gmm(2, 2);
+  gmm.Component(0) = distribution::GaussianDistribution("0 0", "1 0; 0 1");
+  gmm.Component(1) = distribution::GaussianDistribution("3 3", "2 1; 1 2");
+  gmm.Weights() = "0.3 0.7";
+
+  arma::mat observations = "0 1 2 3 -1.0 1.4;"
+                           "0 1 2 3  5.3 0.0";
+
+  arma::mat logProbabilities, workspace;
+  arma::vec mixtureLogProbabilities;
+  gmm.LogProbability(observations, logProbabilities, workspace);
+  gmm.LogProbability(observations, mixtureLogProbabilities);
+
+  REQUIRE(logProbabilities.n_rows == observations.n_cols);
+  REQUIRE(logProbabilities.n_cols == 2);
+  REQUIRE(mixtureLogProbabilities.n_elem == observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    for (size_t j = 0; j < 2; ++j)
+    {
+      REQUIRE(logProbabilities(i, j) == Approx(
+          gmm.LogProbability(observations.col(i), j)).epsilon(1e-7));
+    }
+
+    REQUIRE(mixtureLogProbabilities(i) ==
+        Approx(gmm.LogProbability(observations.col(i))).epsilon(1e-7));
+  }
+
+  // Reusing the workspace should give the same results.
+  arma::mat logProbabilities2;
+  gmm.LogProbability(observations, logProbabilities2, workspace);
+  REQUIRE(arma::approx_equal(logProbabilities, logProbabilities2, "absdiff",
+      1e-10));
+}
+
 /**
  * Test training a model on only one Gaussian (randomly generated) in two
  * dimensions.  We will vary the dataset size from small to large.  The EM
@@ -876,6 +918,42 @@ TEST_CASE("DiagonalGMMProbabilityComponentTest", "[GMMTest]")
       Approx(8.60082772711e-05).epsilon(1e-7));
 }
 
+/**
+ * Make sure the batch DiagonalGMM::LogProbability() overloads give the same
+ * results as the single-observation versions.
+ */
+TEST_CASE("DiagonalGMMBatchLogProbabilityTest", "[GMMTest]")
+{
+  // Create DiagonalGMM (same as the last test).
+  DiagonalGMM gmm(2, 2);
+  gmm.Component(0) = distribution::DiagonalGaussianDistribution("0 0", "1 1");
+  gmm.Component(1) = distribution::DiagonalGaussianDistribution("2 3", "3 2");
+  gmm.Weights() = "0.2 0.8";
+
+  arma::mat observations = "0 1 3 2.6 -4.1;"
+                           "0 1 3 3.2  2.1";
+
+  arma::mat logProbabilities, workspace;
+  arma::vec mixtureLogProbabilities;
+  gmm.LogProbability(observations, logProbabilities, workspace);
+  gmm.LogProbability(observations, mixtureLogProbabilities);
+
+  REQUIRE(logProbabilities.n_rows == observations.n_cols);
+  REQUIRE(logProbabilities.n_cols == 2);
+  REQUIRE(mixtureLogProbabilities.n_elem == observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    for (size_t j = 0; j < 2; ++j)
+    {
+      REQUIRE(logProbabilities(i, j) == Approx(
+          gmm.LogProbability(observations.col(i), j)).epsilon(1e-7));
+    }
+
+    REQUIRE(mixtureLogProbabilities(i) ==
+        Approx(gmm.LogProbability(observations.col(i))).epsilon(1e-7));
+  }
+}
+
 /**
  * Make sure we can train a model on only one Gaussian (randomly generated)
  * in two dimensions.  We will vary the dataset size from small to large.
@@ -1509,6 +1509,95 @@ TEST_CASE("HMMTrainReturnLogLikelihood", "[HMMTest]")
   REQUIRE(std::isfinite(loglik) == true);
 }
 
+/**
+ * Make sure that Baum-Welch training on many sequences (which may be processed
+ * in parallel) gives the same model every time it is run.
+ */
+TEST_CASE("HMMTrainManySequencesDeterministicTest", "[HMMTest]")
+{
+  HMM<GaussianDistribution> hmm(2, GaussianDistribution(2));
+  hmm.Transition() = arma::mat("0.3 0.6; 0.7 0.4");
+  hmm.Emission()[0] = GaussianDistribution("0.0 0.0", "1.0 0.0; 0.0 1.0");
+  hmm.Emission()[1] = GaussianDistribution("3.0 3.0", "1.5 0.5; 0.5 1.5");
+
+  // Generate a large number of short sequences.
+  std::vector<arma::mat> observations(200);
+  std::vector<arma::Row<size_t>> states(200);
+  for (size_t i = 0; i < observations.size(); ++i)
+    hmm.Generate(20 + (i % 7), observations[i], states[i]);
+
+  HMM<GaussianDistribution> hmm1(hmm), hmm2(hmm);
+  const double loglik1 = hmm1.Train(observations);
+  const double loglik2 = hmm2.Train(observations);
+
+  REQUIRE(std::isfinite(loglik1));
+  REQUIRE(loglik1 == loglik2);
+  REQUIRE(arma::approx_equal(hmm1.Initial(), hmm2.Initial(), "absdiff",
+      1e-12));
+  REQUIRE(arma::approx_equal(hmm1.Transition(), hmm2.Transition(), "absdiff",
+      1e-12));
+  for (size_t i = 0; i < 2; ++i)
+  {
+    REQUIRE(arma::approx_equal(hmm1.Emission()[i].Mean(),
+        hmm2.Emission()[i].Mean(), "absdiff", 1e-12));
+    REQUIRE(arma::approx_equal(hmm1.Emission()[i].Covariance(),
+        hmm2.Emission()[i].Covariance(), "absdiff", 1e-12));
+  }
+
+  // The learned transition matrix should be close to the true one.
+  for (size_t i = 0; i < 2; ++i)
+    for (size_t j = 0; j < 2; ++j)
+      REQUIRE(hmm1.Transition()(i, j) ==
+          Approx(hmm.Transition()(i, j)).margin(0.1));
+}
+
+/**
+ * Make sure that the batch Predict() and LogLikelihood() overloads give the
+ * same results as the single-sequence versions.
+ */
+TEST_CASE("HMMBatchPredictLogLikelihoodTest", "[HMMTest]")
+{
+  HMM<GMM> hmm(3, GMM(2, 2));
+  hmm.Transition() = arma::mat("0.5 0.2 0.1; 0.3 0.7 0.1; 0.2 0.1 0.8");
+  for (size_t i = 0; i < 3; ++i)
+  {
+    hmm.Emission()[i].Component(0) = GaussianDistribution(
+        arma::vec(2).fill(3.0 * i), arma::eye<arma::mat>(2, 2));
+    hmm.Emission()[i].Component(1) = GaussianDistribution(
+        arma::vec(2).fill(3.0 * i + 1.0), 0.5 * arma::eye<arma::mat>(2, 2));
+  }
+
+  std::vector<arma::mat> observations(30);
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    arma::Row<size_t> states;
+    hmm.Generate(10 + 3 * i, observations[i], states);
+  }
+
+  std::vector<arma::Row<size_t>> stateSeqs;
+  arma::vec predictLogLikelihoods, logLikelihoods;
+  hmm.Predict(observations, stateSeqs, predictLogLikelihoods);
+  hmm.LogLikelihood(observations, logLikelihoods);
+
+  REQUIRE(stateSeqs.size() == observations.size());
+  REQUIRE(predictLogLikelihoods.n_elem == observations.size());
+  REQUIRE(logLikelihoods.n_elem == observations.size());
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    arma::Row<size_t> stateSeq;
+    const double predictLogLikelihood = hmm.Predict(observations[i], stateSeq);
+
+    REQUIRE(stateSeqs[i].n_elem == stateSeq.n_elem);
+    for (size_t t = 0; t < stateSeq.n_elem; ++t)
+      REQUIRE(stateSeqs[i][t] == stateSeq[t]);
+
+    REQUIRE(predictLogLikelihoods[i] ==
+        Approx(predictLogLikelihood).epsilon(1e-10));
+    REQUIRE(logLikelihoods[i] ==
+        Approx(hmm.LogLikelihood(observations[i])).epsilon(1e-10));
+  }
+}
+
 /********************************************/
 /** DiagonalGMM Hidden Markov Models Tests **/
 /********************************************/
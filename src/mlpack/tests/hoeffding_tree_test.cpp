@@ -1475,3 +1475,183 @@ TEST_CASE("HoeffdingTreeModelSerializationTest", "[HoeffdingTreeTest]")
     }
   }
 }
+
+/**
+ * Make sure that merging two HoeffdingCategoricalSplits gives the same result
+ * as training one split on all of the points.
+ */
+TEST_CASE("HoeffdingCategoricalSplitMergeTest", "[HoeffdingTreeTest]")
+{
+  HoeffdingCategoricalSplit<GiniImpurity> split1(5, 3), split2(5, 3),
+      split(5, 3);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    const size_t category = mlpack::math::RandInt(5);
+    const size_t label = (category + mlpack::math::RandInt(2)) % 3;
+    if (i % 3 == 0)
+      split1.Train(category, label);
+    else
+      split2.Train(category, label);
+    split.Train(category, label);
+  }
+
+  split1.Merge(split2);
+
+  double bestGain, secondBestGain, mergedBestGain, mergedSecondBestGain;
+  split.EvaluateFitnessFunction(bestGain, secondBestGain);
+  split1.EvaluateFitnessFunction(mergedBestGain, mergedSecondBestGain);
+  REQUIRE(mergedBestGain == Approx(bestGain).epsilon(1e-7));
+  REQUIRE(split1.MajorityClass() == split.MajorityClass());
+  REQUIRE(split1.MajorityProbability() ==
+      Approx(split.MajorityProbability()).epsilon(1e-7));
+}
+
+/**
+ * Make sure that merging two BinaryNumericSplits gives the same result as
+ * training one split on all of the points.
+ */
+TEST_CASE("BinaryNumericSplitMergeTest", "[HoeffdingTreeTest]")
+{
+  BinaryNumericSplit<GiniImpurity> split1(2), split2(2), split(2);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    const double value0 = mlpack::math::Random();
+    const double value1 = mlpack::math::Random() + 0.8;
+    if (i % 2 == 0)
+    {
+      split1.Train(value0, 0);
+      split2.Train(value1, 1);
+    }
+    else
+    {
+      split2.Train(value0, 0);
+      split1.Train(value1, 1);
+    }
+    split.Train(value0, 0);
+    split.Train(value1, 1);
+  }
+
+  split1.Merge(split2);
+
+  double bestGain, secondBestGain, mergedBestGain, mergedSecondBestGain;
+  split.EvaluateFitnessFunction(bestGain, secondBestGain);
+  split1.EvaluateFitnessFunction(mergedBestGain, mergedSecondBestGain);
+  REQUIRE(mergedBestGain == Approx(bestGain).epsilon(1e-7));
+  REQUIRE(mergedSecondBestGain == Approx(secondBestGain).epsilon(1e-7));
+
+  arma::Col<size_t> childMajorities, mergedChildMajorities;
+  BinaryNumericSplitInfo<> splitInfo, mergedSplitInfo;
+  split.Split(childMajorities, splitInfo);
+  split1.Split(mergedChildMajorities, mergedSplitInfo);
+  REQUIRE(arma::all(childMajorities == mergedChildMajorities));
+  REQUIRE(mergedSplitInfo.CalculateDirection(0.9) ==
+      splitInfo.CalculateDirection(0.9));
+}
+
+/**
+ * Make sure that merging a HoeffdingNumericSplit that has not binned yet into
+ * another split (binned or not) gives the same result as training one split on
+ * the points in the same order.
+ */
+TEST_CASE("HoeffdingNumericSplitMergeTest", "[HoeffdingTreeTest]")
+{
+  arma::vec values(200, arma::fill::randu);
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < 200; ++i)
+    labels[i] = (values[i] + 0.2 * mlpack::math::Random() > 0.6) ? 1 : 0;
+
+  // The first split has binned, and the second has not.
+  HoeffdingNumericSplit<GiniImpurity> binnedSplit(2, 10, 100);
+  HoeffdingNumericSplit<GiniImpurity> unbinnedSplit(2, 10, 100);
+  HoeffdingNumericSplit<GiniImpurity> split(2, 10, 100);
+  for (size_t i = 0; i < 150; ++i)
+    binnedSplit.Train(values[i], labels[i]);
+  for (size_t i = 150; i < 200; ++i)
+    unbinnedSplit.Train(values[i], labels[i]);
+  for (size_t i = 0; i < 200; ++i)
+    split.Train(values[i], labels[i]);
+
+  // Merging the unbinned split into the binned split is the same as training
+  // on all the points in order.
+  HoeffdingNumericSplit<GiniImpurity> merged(binnedSplit);
+  merged.Merge(unbinnedSplit);
+
+  double bestGain, secondBestGain, mergedBestGain, mergedSecondBestGain;
+  split.EvaluateFitnessFunction(bestGain, secondBestGain);
+  merged.EvaluateFitnessFunction(mergedBestGain, mergedSecondBestGain);
+  REQUIRE(mergedBestGain == Approx(bestGain).epsilon(1e-7));
+  REQUIRE(merged.MajorityClass() == split.MajorityClass());
+  REQUIRE(merged.MajorityProbability() ==
+      Approx(split.MajorityProbability()).epsilon(1e-7));
+
+  // Merging the binned split into the unbinned split takes the bins of the
+  // binned split, so the result is the same.
+  HoeffdingNumericSplit<GiniImpurity> reverseMerged(unbinnedSplit);
+  reverseMerged.Merge(binnedSplit);
+
+  reverseMerged.EvaluateFitnessFunction(mergedBestGain, mergedSecondBestGain);
+  REQUIRE(mergedBestGain == Approx(bestGain).epsilon(1e-7));
+  REQUIRE(reverseMerged.MajorityClass() == split.MajorityClass());
+}
+
+/**
+ * Train Hoeffding trees in parallel on an easy dataset, with both numeric split
+ * types, and make sure they split correctly and give good accuracy.
+ */
+TEST_CASE("HoeffdingTreeParallelTrainTest", "[HoeffdingTreeTest]")
+{
+  // Generate data.
+  arma::mat dataset(4, 9000);
+  arma::Row<size_t> labels(9000);
+  data::DatasetInfo info(4); // All features are numeric, except the fourth.
+  info.MapString<double>("0", 3);
+  info.MapString<double>("1", 3);
+  for (size_t i = 0; i < 9000; i += 3)
+  {
+    dataset(0, i) = mlpack::math::Random();
+    dataset(1, i) = mlpack::math::Random();
+    dataset(2, i) = mlpack::math::Random();
+    dataset(3, i) = mlpack::math::RandInt(2);
+    labels[i] = 0;
+
+    dataset(0, i + 1) = mlpack::math::Random();
+    dataset(1, i + 1) = mlpack::math::Random() - 1.0;
+    dataset(2, i + 1) = mlpack::math::Random() + 0.5;
+    dataset(3, i + 1) = mlpack::math::RandInt(2);
+    labels[i + 1] = 2;
+
+    dataset(0, i + 2) = mlpack::math::Random();
+    dataset(1, i + 2) = mlpack::math::Random() + 1.0;
+    dataset(2, i + 2) = mlpack::math::Random() + 0.8;
+    dataset(3, i + 2) = mlpack::math::RandInt(2);
+    labels[i + 2] = 1;
+  }
+
+  HoeffdingTree<GiniImpurity, HoeffdingDoubleNumericSplit> tree(info, 3);
+  tree.ParallelTrain(dataset, labels, 50);
+  HoeffdingTree<GiniImpurity, BinaryDoubleNumericSplit> binaryTree(info, 3);
+  binaryTree.ParallelTrain(dataset, labels);
+
+  REQUIRE(tree.NumChildren() > 0);
+  REQUIRE(binaryTree.NumChildren() > 0);
+  REQUIRE(tree.SplitDimension() == 1);
+  REQUIRE(binaryTree.SplitDimension() == 1);
+
+  arma::Row<size_t> predictions, binaryPredictions;
+  tree.Classify(dataset, predictions);
+  binaryTree.Classify(dataset, binaryPredictions);
+
+  size_t correct = 0;
+  size_t binaryCorrect = 0;
+  for (size_t i = 0; i < 9000; ++i)
+  {
+    if (labels[i] == predictions[i])
+      ++correct;
+    if (labels[i] == binaryPredictions[i])
+      ++binaryCorrect;
+  }
+
+  // 66% accuracy shouldn't be too much to ask...
+  REQUIRE(correct > 6000);
+  REQUIRE(binaryCorrect > 6000);
+}
@@ -70,3 +70,38 @@ TEST_CASE_METHOD(HMMLoglikTestFixture, "HMMLoglikOutputNegativeTest",
   // Since the log of a probability <= 0 ...
   REQUIRE(loglik <= 0);
 }
+
+TEST_CASE_METHOD(HMMLoglikTestFixture, "HMMLoglikMultipleSequencesTest",
+                 "[HMMLoglikMainTest][BindingTests]")
+{
+  // Load data to train a discrete HMM model with.
+  arma::mat inp;
+  data::Load("obs1.csv", inp);
+  std::vector<arma::mat> trainSeq = {inp};
+
+  // Initialize and train an HMM model.
+  HMMModel* h = new HMMModel(DiscreteHMM);
+  h->PerformAction<InitHMMModel, std::vector<arma::mat>>(&trainSeq);
+  h->PerformAction<TrainHMMModel, std::vector<arma::mat>>(&trainSeq);
+
+  // Score the same sequence twice, concatenated with a shorter prefix of it.
+  const size_t prefixLength = inp.n_cols / 2;
+  arma::Col<size_t> lengths = { inp.n_cols, prefixLength, inp.n_cols };
+  arma::mat input = arma::join_rows(arma::join_rows(inp,
+      inp.cols(0, prefixLength - 1)), inp);
+
+  SetInputParam("input_model", h);
+  SetInputParam("input", std::move(input));
+  SetInputParam("lengths", std::move(lengths));
+
+  mlpackMain();
+
+  const arma::vec& logliks = IO::GetParam<arma::vec>("log_likelihoods");
+  const double loglik = IO::GetParam<double>("log_likelihood");
+
+  REQUIRE(logliks.n_elem == 3);
+  REQUIRE(logliks(0) == Approx(logliks(2)).epsilon(1e-7));
+  REQUIRE(logliks(0) <= 0);
+  REQUIRE(logliks(1) <= 0);
+  REQUIRE(loglik == Approx(arma::accu(logliks)).epsilon(1e-7));
+}
@@ -78,6 +78,37 @@ TEST_CASE_METHOD(HMMViterbiTestFixture,
   REQUIRE(out.n_cols == inp.n_cols);
 }
 
+TEST_CASE_METHOD(HMMViterbiTestFixture,
+                 "HMMViterbiDiscreteHMMMultipleSequencesTest",
+                 "[HMMViterbiMainTest][BindingTests]")
+{
+  // Load data to train a discrete HMM model with.
+  arma::mat inp;
+  data::Load("obs1.csv", inp);
+  std::vector<arma::mat> trainSeq = {inp};
+
+  // Initialize and train a discrete HMM model.
+  HMMModel* h = new HMMModel(DiscreteHMM);
+  h->PerformAction<InitHMMModel, std::vector<arma::mat>>(&trainSeq);
+  h->PerformAction<TrainHMMModel, std::vector<arma::mat>>(&trainSeq);
+
+  // Decode the same sequence twice in one call.
+  arma::Col<size_t> lengths = { inp.n_cols, inp.n_cols };
+  SetInputParam("input_model", h);
+  SetInputParam("input", arma::mat(arma::join_rows(inp, inp)));
+  SetInputParam("lengths", std::move(lengths));
+
+  mlpackMain();
+
+  arma::Mat<size_t> out = IO::GetParam<arma::Mat<size_t> >("output");
+
+  // The output holds both state sequences, which must be identical.
+  REQUIRE(out.n_rows == 1);
+  REQUIRE(out.n_cols == 2 * inp.n_cols);
+  for (size_t i = 0; i < inp.n_cols; ++i)
+    REQUIRE(out(0, i) == out(0, inp.n_cols + i));
+}
+
 TEST_CASE_METHOD(HMMViterbiTestFixture,
                  "HMMViterbiGaussianHMMCheckDimensionsTest",
                  "[HMMViterbiMainTest][BindingTests]")
@@ -763,3 +763,44 @@ TEST_CASE_METHOD(HoeffdingTreeTestFixture, "HoeffdingBinningTest",
   REQUIRE((IO::GetParam<HoeffdingTreeModel*>("output_model"))->NumNodes()
       == 1);
 }
+
+/**
+ * Make sure that streaming training with multiple threads gives a reasonable
+ * tree.
+ */
+TEST_CASE_METHOD(HoeffdingTreeTestFixture, "HoeffdingTreeMergeIntervalTest",
+                 "[HoeffdingTreeMainTest][BindingTests]")
+{
+  arma::mat inputData;
+  DatasetInfo info;
+  if (!data::Load("vc2.csv", inputData, info))
+    FAIL("Cannot load train dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData, info))
+    FAIL("Cannot load test dataset vc2.csv!");
+
+  const size_t testSize = testData.n_cols;
+
+  // Input training data.
+  SetInputParam("training", std::make_tuple(info, inputData));
+  SetInputParam("labels", std::move(labels));
+
+  // Input test data.
+  SetInputParam("test", std::make_tuple(info, testData));
+
+  SetInputParam("merge_interval", 20);
+  SetInputParam("passes", 10);
+  SetInputParam("max_samples", 50);
+
+  mlpackMain();
+
+  // The tree should have split, and we should get a prediction for each point.
+  REQUIRE((IO::GetParam<HoeffdingTreeModel*>("output_model"))->NumNodes() > 1);
+  REQUIRE(IO::GetParam<arma::Row<size_t>>("predictions").n_cols == testSize);
+  REQUIRE(IO::GetParam<arma::mat>("probabilities").n_cols == testSize);
+}
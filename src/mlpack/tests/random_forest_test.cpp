@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/random_forest/random_forest.hpp>
+#include <mlpack/methods/random_forest/flat_forest.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 
 #include "serialization.hpp"
@@ -94,6 +95,58 @@ TEST_CASE("BootstrapWeightsTest", "[RandomForestTest]")
   }
 }
 
+/**
+ * Make sure bootstrap indices are valid, and that training a tree on them gives
+ * the same tree as training on the copied bootstrap dataset.
+ */
+TEST_CASE("BootstrapIndicesTest", "[RandomForestTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("vc2.csv", dataset))
+    FAIL("Cannot load dataset vc2.csv");
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load dataset vc2_labels.txt");
+  arma::rowvec weights(labels.n_elem, arma::fill::randu);
+
+  arma::uvec indices;
+  BootstrapIndices(dataset.n_cols, indices);
+
+  REQUIRE(indices.n_elem == dataset.n_cols);
+  REQUIRE(indices.max() < dataset.n_cols);
+
+  // Build the equivalent copied bootstrap dataset.
+  arma::mat bootstrapDataset = dataset.cols(indices);
+  arma::Row<size_t> bootstrapLabels = labels.cols(indices);
+  arma::rowvec bootstrapWeights = weights.cols(indices);
+
+  data::DatasetInfo info(dataset.n_rows);
+  DecisionTree<> indexTree, copyTree, weightedIndexTree, weightedCopyTree;
+  indexTree.Train<false>(dataset, indices, info, labels, 3, weights, 5, 1e-7,
+      0, AllDimensionSelect());
+  copyTree.Train(bootstrapDataset, bootstrapLabels, 3, 5);
+  weightedIndexTree.Train<true>(dataset, indices, info, labels, 3, weights, 5,
+      1e-7, 0, AllDimensionSelect());
+  weightedCopyTree.Train(bootstrapDataset, bootstrapLabels, 3,
+      bootstrapWeights, 5);
+
+  // The dataset must not have been modified, and the trees should be the same.
+  arma::Row<size_t> indexPredictions, copyPredictions;
+  arma::mat indexProbabilities, copyProbabilities;
+  indexTree.Classify(dataset, indexPredictions, indexProbabilities);
+  copyTree.Classify(dataset, copyPredictions, copyProbabilities);
+
+  REQUIRE(indexTree.NumChildren() == copyTree.NumChildren());
+  REQUIRE(arma::accu(indexPredictions != copyPredictions) == 0);
+  CheckMatrices(indexProbabilities, copyProbabilities);
+
+  weightedIndexTree.Classify(dataset, indexPredictions, indexProbabilities);
+  weightedCopyTree.Classify(dataset, copyPredictions, copyProbabilities);
+
+  REQUIRE(arma::accu(indexPredictions != copyPredictions) == 0);
+  CheckMatrices(indexProbabilities, copyProbabilities);
+}
+
 /**
  * Make sure an empty forest cannot predict.
  */
@@ -154,6 +207,47 @@ TEST_CASE("UnweightedNumericLearningTest", "[RandomForestTest]")
   REQUIRE(rfCorrect >= size_t(0.7 * testDataset.n_cols));
 }
 
+/**
+ * Test unweighted numeric learning with the HistogramNumericSplit, making sure
+ * that we get performance comparable to a single decision tree.
+ */
+TEST_CASE("HistogramSplitNumericLearningTest", "[RandomForestTest]")
+{
+  // Load the vc2 dataset.
+  arma::mat dataset;
+  if (!data::Load("vc2.csv", dataset))
+    FAIL("Cannot load dataset vc2.csv");
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load dataset vc2.csv");
+
+  // Build a random forest and a decision tree.
+  RandomForest<GiniGain, MultipleRandomDimensionSelect, HistogramNumericSplit>
+      rf(dataset, labels, 3, 20 /* 20 trees */, 1, 1e-7);
+  DecisionTree<> dt(dataset, labels, 3, 5);
+
+  // Get performance statistics on test data.
+  arma::mat testDataset;
+  if (!data::Load("vc2_test.csv", testDataset))
+    FAIL("Cannot load dataset vc2_test.csv");
+  arma::Row<size_t> testLabels;
+  if (!data::Load("vc2_test_labels.txt", testLabels))
+    FAIL("Cannot load dataset vc2_test_labels.txt");
+
+  arma::Row<size_t> rfPredictions;
+  arma::Row<size_t> dtPredictions;
+
+  rf.Classify(testDataset, rfPredictions);
+  dt.Classify(testDataset, dtPredictions);
+
+  // Calculate the number of correct points.
+  size_t rfCorrect = arma::accu(rfPredictions == testLabels);
+  size_t dtCorrect = arma::accu(dtPredictions == testLabels);
+
+  REQUIRE(rfCorrect >= dtCorrect * 0.9);
+  REQUIRE(rfCorrect >= size_t(0.7 * testDataset.n_cols));
+}
+
 /**
  * Test weighted numeric learning, making sure that we get better performance
  * than a single decision tree.
@@ -498,3 +592,94 @@ TEST_CASE("DifferentTreesTest", "[RandomForestTest]")
 
   REQUIRE(success == true);
 }
+
+/**
+ * Make sure that a FlatForest gives the same predictions and probabilities as
+ * the random forest and decision tree it was built from.
+ */
+TEST_CASE("FlatForestNumericTest", "[RandomForestTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("vc2.csv", dataset))
+    FAIL("Cannot load dataset vc2.csv");
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load dataset vc2_labels.txt");
+  arma::mat testDataset;
+  if (!data::Load("vc2_test.csv", testDataset))
+    FAIL("Cannot load dataset vc2_test.csv");
+
+  RandomForest<> rf(dataset, labels, 3, 20 /* 20 trees */, 1);
+  DecisionTree<> dt(dataset, labels, 3, 5);
+
+  FlatForest flatRF(rf);
+  FlatForest flatDT(dt);
+
+  REQUIRE(flatRF.NumTrees() == 20);
+  REQUIRE(flatDT.NumTrees() == 1);
+  REQUIRE(flatRF.NumClasses() == 3);
+
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::mat probabilities, flatProbabilities;
+
+  rf.Classify(testDataset, predictions, probabilities);
+  flatRF.Classify(testDataset, flatPredictions, flatProbabilities);
+  CheckMatrices(predictions, flatPredictions);
+  CheckMatrices(probabilities, flatProbabilities);
+
+  dt.Classify(testDataset, predictions, probabilities);
+  flatDT.Classify(testDataset, flatPredictions, flatProbabilities);
+  CheckMatrices(predictions, flatPredictions);
+  CheckMatrices(probabilities, flatProbabilities);
+
+  // Serialize the flattened forest and make sure the results are the same.
+  FlatForest xmlForest, jsonForest, binaryForest;
+  SerializeObjectAll(flatRF, xmlForest, jsonForest, binaryForest);
+
+  arma::Row<size_t> xmlPredictions, jsonPredictions, binaryPredictions;
+  rf.Classify(testDataset, predictions);
+  xmlForest.Classify(testDataset, xmlPredictions);
+  jsonForest.Classify(testDataset, jsonPredictions);
+  binaryForest.Classify(testDataset, binaryPredictions);
+  CheckMatrices(predictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+}
+
+/**
+ * Make sure that a FlatForest built from a forest with categorical splits
+ * gives the same results as the forest.
+ */
+TEST_CASE("FlatForestCategoricalTest", "[RandomForestTest]")
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  arma::mat trainingData = d.cols(0, 1999);
+  arma::mat testData = d.cols(2000, 3999);
+  arma::Row<size_t> trainingLabels = l.subvec(0, 1999);
+
+  RandomForest<> rf(trainingData, di, trainingLabels, 5, 10 /* 10 trees */, 1,
+      1e-7, 0, MultipleRandomDimensionSelect(4));
+  FlatForest flat(rf);
+
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::mat probabilities, flatProbabilities;
+  rf.Classify(testData, predictions, probabilities);
+  flat.Classify(testData, flatPredictions, flatProbabilities);
+
+  CheckMatrices(predictions, flatPredictions);
+  CheckMatrices(probabilities, flatProbabilities);
+}
+
+/**
+ * Make sure an empty FlatForest cannot predict.
+ */
+TEST_CASE("FlatForestEmptyClassifyTest", "[RandomForestTest]")
+{
+  arma::mat points(10, 100, arma::fill::randu);
+  arma::Row<size_t> predictions;
+  FlatForest flat;
+  REQUIRE_THROWS_AS(flat.Classify(points, predictions), std::invalid_argument);
+}
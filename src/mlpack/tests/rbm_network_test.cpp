@@ -211,6 +211,84 @@ TEST_CASE("ssRBMClassificationTest", "[RBMNetworkTest]")
   REQUIRE(ssRbmClassificationAccuracy >= 76.18 - 3.0);
 }
 
+/*
+ * Check that the Gibbs chains of the BinaryRBM split across threads are
+ * reproducible, and that the persistent chains follow batches of different
+ * sizes.
+ */
+TEST_CASE("BinaryRBMParallelGibbsTest", "[RBMNetworkTest]")
+{
+  const size_t visibleSize = 12;
+  const size_t hiddenSize = 20;
+  arma::mat data = arma::round(arma::randu<arma::mat>(visibleSize, 16));
+
+  GaussianInitialization gaussian(0, 0.1);
+  RBM<GaussianInitialization> model(data, gaussian, visibleSize, hiddenSize,
+      16, 3, 1, 2, 8, 1, true);
+  RBM<GaussianInitialization> copy(data, gaussian, visibleSize, hiddenSize,
+      16, 3, 1, 2, 8, 1, true);
+  model.Reset();
+  copy.Reset();
+  copy.Parameters() = model.Parameters();
+  model.Threads() = 4;
+  copy.Threads() = 4;
+
+  arma::mat output, copyOutput;
+  math::RandomSeed(7);
+  model.Gibbs(data.cols(0, 9), output);
+  model.Gibbs(data, output);
+  math::RandomSeed(7);
+  copy.Gibbs(data.cols(0, 9), copyOutput);
+  copy.Gibbs(data, copyOutput);
+
+  REQUIRE(output.n_rows == visibleSize);
+  REQUIRE(output.n_cols == data.n_cols);
+  REQUIRE(arma::approx_equal(output, copyOutput, "absdiff", 0));
+  REQUIRE(arma::all(arma::vectorise((output == 0) + (output == 1)) == 1));
+
+  // A smaller batch continues the first chains.
+  model.Gibbs(data.cols(0, 4), output);
+  REQUIRE(output.n_cols == 5);
+}
+
+/*
+ * Check the free energy and the spike mean of the SpikeSlabRBM against the sums
+ * over the single hidden units.
+ */
+TEST_CASE("ssRBMHiddenUnitsTest", "[RBMNetworkTest]")
+{
+  const size_t visibleSize = 6;
+  const size_t hiddenSize = 4;
+  const size_t poolSize = 3;
+  const double slabPenalty = 8;
+  arma::mat data = arma::randu<arma::mat>(visibleSize, 5);
+
+  GaussianInitialization gaussian(0, 0.5);
+  RBM<GaussianInitialization, arma::mat, SpikeSlabRBM> model(data, gaussian,
+      visibleSize, hiddenSize, 5, 1, 1, poolSize, slabPenalty, 10);
+  model.Reset();
+  model.VisiblePenalty().fill(5);
+  model.SpikeBias().randu();
+
+  double freeEnergy = 0.5 * 5 * arma::dot(data, data) - 0.5 * hiddenSize *
+      poolSize * std::log((2.0 * M_PI) / slabPenalty);
+  arma::mat spikeMean(hiddenSize, 1), expectedSpikeMean(hiddenSize, 1);
+  for (size_t i = 0; i < hiddenSize; ++i)
+  {
+    const arma::mat& w = model.Weight().slice(i);
+    freeEnergy -= SoftplusFunction::Fn(model.SpikeBias()(i) -
+        arma::accu(arma::square(data.t() * w)) / (2.0 * slabPenalty));
+    expectedSpikeMean(i) = LogisticFunction::Fn(0.5 / slabPenalty *
+        arma::accu(data.t() * (w * w.t()) * data) / std::pow(data.n_cols, 2) +
+        model.SpikeBias()(i));
+  }
+
+  model.SpikeMean(data, spikeMean);
+  REQUIRE(model.FreeEnergy(data) == Approx(freeEnergy).epsilon(1e-7));
+  for (size_t i = 0; i < hiddenSize; ++i)
+    REQUIRE(spikeMean(i) == Approx(expectedSpikeMean(i)).epsilon(1e-7));
+}
+
 template<typename MatType = arma::mat>
 void BuildVanillaNetwork(MatType& trainData,
                          const size_t hiddenLayerSize)
@@ -22,6 +22,7 @@
 #include "catch.hpp"
 #include "serialization.hpp"
 #include "custom_layer.hpp"
+#include "ann_test_tools.hpp"
 
 using namespace mlpack;
 using namespace mlpack::ann;
@@ -414,6 +415,47 @@ TEST_CASE("RNNSerializationTest", "[RecurrentNetworkTest]")
   CheckMatrices(prediction, xmlPrediction, jsonPrediction, binaryPrediction);
 }
 
+/**
+ * Make sure that an RNN with an LSTM layer can be serialized with the current
+ * layout of the LSTM weights.
+ */
+TEST_CASE("LSTMSerializationTest", "[RecurrentNetworkTest]")
+{
+  const size_t rho = 10;
+
+  arma::cube input;
+  arma::mat labelsTemp;
+  GenerateNoisySines(input, labelsTemp, rho, 6);
+
+  arma::cube labels = arma::zeros<arma::cube>(1, labelsTemp.n_cols, rho);
+  for (size_t i = 0; i < labelsTemp.n_cols; ++i)
+  {
+    const int value = arma::as_scalar(arma::find(
+        arma::max(labelsTemp.col(i)) == labelsTemp.col(i), 1)) + 1;
+    labels.tube(0, i).fill(value);
+  }
+
+  RNN<> model(rho);
+  model.Add<IdentityLayer<> >();
+  model.Add<LSTM<> >(1, 4, rho);
+  model.Add<Linear<> >(4, 10);
+  model.Add<LogSoftMax<> >();
+
+  StandardSGD opt(0.1, 1, input.n_cols /* 1 epoch */, -100);
+  model.Train(input, labels, opt);
+
+  RNN<> xmlModel(1), jsonModel(3), binaryModel(5);
+  SerializeObjectAll(model, xmlModel, jsonModel, binaryModel);
+
+  arma::cube prediction, xmlPrediction, jsonPrediction, binaryPrediction;
+  model.Predict(input, prediction);
+  xmlModel.Predict(input, xmlPrediction);
+  jsonModel.Predict(input, jsonPrediction);
+  binaryModel.Predict(input, binaryPrediction);
+
+  CheckMatrices(prediction, xmlPrediction, jsonPrediction, binaryPrediction);
+}
+
 /**
  * Train the BRNN on a larger dataset.
  */
@@ -931,3 +973,133 @@ TEST_CASE("RNNCheckInputShapeTest", "[RecurrentNetworkTest]")
 
   REQUIRE_THROWS_AS(model.Train(input, labels, opt), std::logic_error);
 }
+
+/**
+ * Test that the predictions of a recurrent network do not depend on the batch
+ * size used by Predict(), i.e. that no state is carried from one batch of
+ * sequences to the next.
+ */
+TEST_CASE("RNNPredictBatchSizeTest", "[RecurrentNetworkTest]")
+{
+  const size_t rho = 10;
+
+  arma::cube input;
+  arma::mat labelsTemp;
+  GenerateNoisySines(input, labelsTemp, rho, 6);
+
+  RNN<> model(rho);
+  model.Add<IdentityLayer<> >();
+  model.Add<LSTM<> >(1, 4, rho);
+  model.Add<Linear<> >(4, 2);
+  model.Add<LogSoftMax<> >();
+
+  arma::cube predictions;
+  model.Predict(input, predictions, input.n_cols);
+
+  REQUIRE(predictions.n_rows == 2);
+  REQUIRE(predictions.n_cols == input.n_cols);
+  REQUIRE(predictions.n_slices == rho);
+
+  const size_t batchSizes[] = { 1, 5 };
+  for (const size_t batchSize : batchSizes)
+  {
+    arma::cube batchPredictions;
+    model.Predict(input, batchPredictions, batchSize);
+
+    REQUIRE(batchPredictions.n_rows == predictions.n_rows);
+    REQUIRE(batchPredictions.n_cols == predictions.n_cols);
+    REQUIRE(batchPredictions.n_slices == predictions.n_slices);
+    for (size_t i = 0; i < predictions.n_elem; ++i)
+      REQUIRE(batchPredictions[i] == Approx(predictions[i]).epsilon(1e-7));
+  }
+}
+
+/**
+ * Make sure that backpropagation through time with checkpointing gives the
+ * same objective and gradient as saving the layer outputs of every step.
+ */
+TEST_CASE("RNNCheckpointGradientTest", "[RecurrentNetworkTest]")
+{
+  const size_t rho = 10;
+
+  arma::cube input;
+  arma::mat labelsTemp;
+  GenerateNoisySines(input, labelsTemp, rho, 6);
+
+  arma::cube labels = arma::zeros<arma::cube>(1, labelsTemp.n_cols, rho);
+  for (size_t i = 0; i < labelsTemp.n_cols; ++i)
+  {
+    const int value = arma::as_scalar(arma::find(
+        arma::max(labelsTemp.col(i)) == labelsTemp.col(i), 1));
+    labels.tube(0, i).fill(value);
+  }
+
+  RNN<> model(rho);
+  model.Add<IdentityLayer<> >();
+  model.Add<LSTM<> >(1, 4, rho);
+  model.Add<Linear<> >(4, 2);
+  model.Add<LogSoftMax<> >();
+  model.Predictors() = input;
+  model.Responses() = labels;
+
+  BRNN<> brnn(rho);
+  brnn.Add<IdentityLayer<> >();
+  brnn.Add<FastLSTM<> >(1, 4, rho);
+  brnn.Add<Linear<> >(4, 2);
+  brnn.Predictors() = input;
+  brnn.Responses() = labels;
+
+  arma::mat gradient, brnnGradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 4);
+  const double brnnObjective = brnn.EvaluateWithGradient(brnn.Parameters(),
+      0, brnnGradient, 4);
+
+  // The last segment is shorter than the others for an interval of 3.
+  const size_t intervals[] = { 1, 3, rho };
+  for (const size_t interval : intervals)
+  {
+    model.CheckpointInterval() = interval;
+    arma::mat checkpointGradient;
+    REQUIRE(model.EvaluateWithGradient(model.Parameters(), 0,
+        checkpointGradient, 4) == Approx(objective).epsilon(1e-7));
+    CheckMatrices(gradient, checkpointGradient, 1e-5);
+
+    brnn.CheckpointInterval() = interval;
+    arma::mat brnnCheckpointGradient;
+    REQUIRE(brnn.EvaluateWithGradient(brnn.Parameters(), 0,
+        brnnCheckpointGradient, 4) == Approx(brnnObjective).epsilon(1e-7));
+    CheckMatrices(brnnGradient, brnnCheckpointGradient, 1e-5);
+  }
+
+  // The forward pass of each segment is computed again with the dropout masks
+  // of the first pass, so the gradient matches the objective of that pass.
+  struct GradientFunction
+  {
+    GradientFunction(const arma::cube& input, const arma::cube& labels,
+                     const size_t rho) :
+        model(rho)
+    {
+      model.Add<IdentityLayer<> >();
+      model.Add<LSTM<> >(1, 4, rho);
+      model.Add<Dropout<> >(0.3);
+      model.Add<Linear<> >(4, 2);
+      model.Add<LogSoftMax<> >();
+      model.Predictors() = input;
+      model.Responses() = labels;
+      model.CheckpointInterval() = 3;
+    }
+
+    double Gradient(arma::mat& gradient)
+    {
+      math::RandomSeed(7);
+      return model.EvaluateWithGradient(model.Parameters(), 0, gradient, 4);
+    }
+
+    arma::mat& Parameters() { return model.Parameters(); }
+
+    RNN<> model;
+  } function(input, labels, rho);
+
+  REQUIRE(CheckGradient(function) <= 1e-4);
+}